@@ -0,0 +1,225 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <ctime>
+#include <cstdlib>
+#include <string>
+#include <iomanip>
+#include <iostream>
+#include "testfunctions.hpp"
+#include "dataset.hpp"
+#include "datafile.hpp"
+
+/** Accumulated CPU time of a phase of the optimization. */
+struct PhaseTimer
+{
+  PhaseTimer(): calls(0), time(0) {};
+  void add(std::clock_t t) { ++calls; time += t; };
+  size_t calls;
+  std::clock_t time;
+};
+
+/** 
+ * Adds timers to the criteria optimization and the function
+ * evaluations of any model. 
+ */
+template <class Model>
+class TimedModel: public Model
+{
+public:
+  TimedModel(bopt_params par): Model(par) {}
+
+  template <class Arg>
+  TimedModel(const Arg& arg, bopt_params par): Model(arg,par) {}
+
+  double evaluateSample(const vectord& x)
+  {
+    std::clock_t start = std::clock();
+    const double y = Model::evaluateSample(x);
+    mEvaluation.add(std::clock() - start);
+    return y;
+  }
+
+  PhaseTimer mEvaluation, mCriteria;
+
+protected:
+  void findOptimal(vectord &xOpt)
+  {
+    std::clock_t start = std::clock();
+    Model::findOptimal(xOpt);
+    mCriteria.add(std::clock() - start);
+  }
+};
+
+/** 
+ * Replaces the objective by a lookup in a recorded dataset (see
+ * utils::ObservationFile). The value is the one of the nearest
+ * recorded sample, thus the run is deterministic for a given seed.
+ */
+class LookupModel: public bayesopt::ContinuousModel
+{
+public:
+  LookupModel(const bayesopt::utils::ObservationFile& data, bopt_params par):
+    ContinuousModel(data.getNDims(),par)
+  {
+    const size_t dim = data.getNDims();
+    const double* x = data.getInputs();
+    vectord xi(dim), lb(dim), ub(dim);
+
+    for (size_t i = 0; i < data.getNSamples(); ++i)
+      {
+	std::copy(x+i*dim, x+(i+1)*dim, xi.begin());
+	mData.addSample(xi,data.getOutputs()[i]);
+	for (size_t j = 0; j < dim; ++j)
+	  {
+	    lb(j) = (i == 0) ? xi(j) : std::min(lb(j),xi(j));
+	    ub(j) = (i == 0) ? xi(j) : std::max(ub(j),xi(j));
+	  }
+      }
+    setBoundingBox(lb,ub);
+  }
+
+  double evaluateSample(const vectord& x)
+  {
+    double dist;
+    return mData.getSampleY(mData.getNearestSample(x,dist));
+  }
+
+  bool checkReachability(const vectord &query)
+  {return true;};
+
+private:
+  bayesopt::Dataset mData;
+};
+
+
+void printPhase(const std::string& name, const PhaseTimer& timer)
+{
+  const double total = static_cast<double>(timer.time) / CLOCKS_PER_SEC;
+  std::cout << std::setw(22) << std::left << name 
+	    << std::setw(8) << std::right << timer.calls
+	    << std::setw(12) << std::fixed << std::setprecision(4) << total
+	    << std::setw(12) << (timer.calls ? 1000.0*total/timer.calls : 0.0)
+	    << std::endl;
+}
+
+/** Runs the full optimization timing each phase. */
+template <class Model>
+int benchmark(Model& model, const bopt_params& par)
+{
+  PhaseTimer init, relearn, update;
+
+  std::clock_t start = std::clock();
+  model.initializeOptimization();
+  init.add(std::clock() - start - model.mEvaluation.time);
+  const PhaseTimer initEvaluation = model.mEvaluation;
+      
+  for (size_t ii = 0; ii < par.n_iterations; ++ii)
+    {      
+      const std::clock_t prev = model.mEvaluation.time + model.mCriteria.time;
+      start = std::clock();
+      model.stepOptimization();
+      const std::clock_t step = std::clock() - start - 
+	(model.mEvaluation.time + model.mCriteria.time - prev);
+
+      // Same condition as BayesOptBase::stepOptimization
+      if ((par.n_iter_relearn > 0) && ((ii + 1) % par.n_iter_relearn == 0))
+	relearn.add(step);
+      else
+	update.add(step);
+    }
+
+  PhaseTimer evaluation = model.mEvaluation;
+  evaluation.calls -= initEvaluation.calls;
+  evaluation.time -= initEvaluation.time;
+  
+  std::cout << std::setw(22) << std::left << "Phase" 
+	    << std::setw(8) << std::right << "Calls"
+	    << std::setw(12) << "Total(s)" << std::setw(12) << "Mean(ms)" 
+	    << std::endl;
+  printPhase("Initial design+fit",init);
+  printPhase("Criteria optimization",model.mCriteria);
+  printPhase("Incremental update",update);
+  printPhase("Relearn+fit",relearn);
+  printPhase("Objective (lookup)",evaluation);
+
+  const bopt_profile total = model.getProfiler().getTotal();
+  std::cout << "Kernel evaluations: " << total.n_kernel 
+	    << " | Cholesky: " << total.n_cholesky 
+	    << " | Criteria evaluations: " << total.n_criteria 
+	    << " | Likelihood evaluations: " << total.n_likelihood << std::endl;
+
+  std::cout << "Best value: " << std::setprecision(6) 
+	    << model.getValueAtMinimum() << std::endl;
+  return 0;
+}
+
+
+int main(int nargs, char *args[])
+{
+  if (nargs < 2)
+    {
+      std::cout << "Usage: " << args[0] 
+		<< " [branin|camelback|hartmann6|oned|datafile]"
+		<< " [n_iterations] [n_iter_relearn] [seed]" << std::endl;
+      return -1;
+    }
+  const std::string source = args[1];
+
+  bopt_params par = initialize_parameters_to_default();
+  par.n_iterations = (nargs > 2) ? std::atoi(args[2]) : 190;
+  if (nargs > 3) par.n_iter_relearn = std::atoi(args[3]);
+  par.random_seed = (nargs > 4) ? std::atoi(args[4]) : 0;
+  par.verbose_level = 0;
+  par.noise = 1e-10;
+  par.journal_mode = 0;  // Only the optimizer is measured
+
+  if (source == "branin")
+    {
+      TimedModel<BraninNormalized> model(par);
+      return benchmark(model,par);
+    }
+  else if (source == "camelback")
+    {
+      TimedModel<ExampleCamelback> model(par);
+      vectord lb(2); lb(0) = -2; lb(1) = -1;
+      vectord ub(2); ub(0) =  2; ub(1) = 1;
+      model.setBoundingBox(lb,ub);
+      return benchmark(model,par);
+    }
+  else if (source == "hartmann6")
+    {
+      TimedModel<ExampleHartmann6> model(par);
+      return benchmark(model,par);
+    }
+  else if (source == "oned")
+    {
+      TimedModel<ExampleOneD> model(par);
+      return benchmark(model,par);
+    }
+  else
+    {
+      bayesopt::utils::ObservationFile data(source);
+      TimedModel<LookupModel> model(data,par);
+      return benchmark(model,par);
+    }
+}
@@ -20,7 +20,6 @@
 ------------------------------------------------------------------------
 */
 
-#include <ctime>
 #include <fstream>
 #include "testfunctions.hpp"
 
@@ -34,28 +33,26 @@ int main(int nargs, char *args[])
   par.noise = 1e-10;
 
   BraninNormalized branin(par);
+  vectord result(2);
 
+  branin.optimize(result);
+
+  // Wall time of each phase per iteration (record 0 is the initial
+  // design).
   std::ofstream timelog;
   timelog.open("time_branin.log");
-  std::clock_t curr_t;
-  std::clock_t prev_t = clock();
+  timelog << "iteration,learning,fit,update,criteria,evaluation" << std::endl;
 
-  branin.initializeOptimization();
-      
-  for (size_t ii = 0; ii < par.n_iterations; ++ii)
+  const bayesopt::utils::Profiler& profiler = branin.getProfiler();
+  for (size_t ii = 0; ii < profiler.getNRecords(); ++ii)
     {      
-      branin.stepOptimization();
-
-      curr_t = clock();
-      timelog << ii << ","
-	      << static_cast<double>(curr_t - prev_t) / CLOCKS_PER_SEC 
-	      << std::endl;
-      prev_t = curr_t;
-      }
-
+      const bopt_profile rec = profiler.getRecord(ii);
+      timelog << rec.iteration << "," << rec.t_learning << "," 
+	      << rec.t_fit << "," << rec.t_update << "," 
+	      << rec.t_criteria << "," << rec.t_evaluation << std::endl;
+    }
   timelog.close();
 
-  vectord result = branin.getFinalResult();
   std::cout << "Result: " << result << "->" 
 	    << branin.evaluateSample(result) << std::endl;
   branin.printOptimal();
@@ -0,0 +1,68 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2013 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+
+#include "bayesopt.hpp"
+#include "testfunctions.hpp"
+
+/** Branin function hidden in a high dimensional space. Only two
+    components are relevant. */
+class BraninHighDim: public bayesopt::RemboModel
+{
+public:
+  BraninHighDim(size_t dim, bopt_params par):
+    RemboModel(dim,2,par), mBranin(par), mI1(150), mI2(237) {}
+
+  double evaluateSample( const vectord& xin)
+  {
+    vectord x(2);
+    x(0) = xin(mI1);  x(1) = xin(mI2);
+    return mBranin.evaluateSample(x);
+  }
+
+  bool checkReachability(const vectord &query)
+  {return true;};
+
+private:
+  BraninNormalized mBranin;
+  size_t mI1, mI2;
+};
+
+int main(int nargs, char *args[])
+{
+  bopt_params par = initialize_parameters_to_default();
+  par.n_iterations = 100;
+  par.random_seed = 0;
+  par.verbose_level = 1;
+  par.noise = 1e-10;
+  
+  const size_t dim = 1000;
+  BraninHighDim branin(dim,par);
+  vectord result(dim);
+
+  branin.optimizeEmbeddings(result,4);
+  std::cout << "Result: " << result(150) << ", " << result(237) << "->" 
+	    << branin.evaluateSample(result) << std::endl;
+  std::cout << "Optimal: 0.397887" << std::endl;
+
+  return 0;
+}
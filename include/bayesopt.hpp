@@ -114,7 +114,7 @@ namespace bayesopt  {
 		      double yNext);
 
     /** Selects the initial set of points to build the surrogate model. */
-    void sampleInitialPoints(matrixd& xPoints, vectord& yPoints);
+    void sampleInitialDesign(matrixd& xPoints);
 
     /** Sample a single point in the input space. Used for epsilon
 	greedy exploration. */
@@ -123,6 +123,15 @@ namespace bayesopt  {
     /** Wrapper for the target function adding any preprocessing or
 	constraint. It also maps the box constrains to the [0,1] hypercube. */
     double evaluateSampleInternal( const vectord &query );
+
+    /** Maps a point of the bounding box to the [0,1] hypercube. */
+    vectord normalizeInput(const vectord& x);
+
+    /** Maps a point of the [0,1] hypercube to the bounding box. */
+    vectord unnormalizeInput(const vectord& x);
+
+    /** The bounding box of the input space. */
+    utils::JournalDomain getJournalDomain();
     
     /** 
      * \brief Call the inner optimization method to find the optimal
@@ -131,8 +140,31 @@ namespace bayesopt  {
      */
     void findOptimal(vectord &xOpt);
 
+    /** 
+     * \brief Decomposed inner optimization for additive models. The
+     * criterion is optimized independently for each group of
+     * dimensions, with the rest of the dimensions fixed at the best
+     * point. The result combines the optimum of every group, unless
+     * moving a single group is better.
+     * @param groups input dimensions of each group
+     * @param xOpt optimal point
+     * @return criterion value at xOpt
+     */
+    double findOptimalByGroups(const vecOfGroups& groups, vectord &xOpt);
+
+    /** 
+     * \brief Updates the size of the trust region based on the
+     * success or failure of the last query and sets the limits of
+     * the inner optimization around the best point.
+     */
+    void updateTrustRegion();
+
   private:
     boost::scoped_ptr<utils::BoundingBox<vectord> > mBB;      ///< Bounding Box (input space limits)
+    double mTrLength;             ///< Current side of the trust region
+    double mTrBest;               ///< Best value at the last update
+    size_t mTrIter;               ///< Iteration of the last update
+    size_t mTrSuccess, mTrFailure;  ///< Consecutive successes/failures
     boost::scoped_ptr<NLOPT_Optimization> cOptimizer;
     boost::scoped_ptr<CritCallback> mCallback;
 
@@ -141,6 +173,99 @@ namespace bayesopt  {
   };
   
 
+  /**
+   * \brief Bayesian optimization in a random embedding (REMBO) of a
+   * high dimensional input space.
+   *
+   * For functions with low effective dimensionality, the surrogate
+   * model and the inner optimization work in a low dimensional box
+   * \f$ y \in [-\sqrt{d},\sqrt{d}]^d \f$. Queries are mapped to the
+   * input space as \f$ x = A y \f$, with a Gaussian random matrix
+   * \f$ A \f$, and clipped to the bounding box \cite ZiyuWang2013.
+   *
+   * Usage is the same as ContinuousModel, but evaluateSample receives
+   * points of the input (high dimensional) space. Note that
+   * checkReachability receives points of the normalized embedded
+   * space.
+   *
+   * The embedding might miss the optimum with small probability, so
+   * several independent embeddings can be tried:
+   * \code{.cpp}
+   *   opt.optimizeEmbeddings(result,nEmbeddings);
+   * \endcode  
+   */
+  class BAYESOPT_API RemboModel: public ContinuousModel
+  {
+  public:
+    /** 
+     * Constructor
+     * @param dim number of input dimensions
+     * @param embeddedDim number of dimensions of the embedding
+     * @param params set of parameters (see parameters.h)
+     */
+    RemboModel(size_t dim, size_t embeddedDim, bopt_params params);
+
+    /**  Default destructor  */
+    virtual ~RemboModel();
+
+    /** Optimal point of the current embedding in the input space. */
+    vectord getFinalResult();
+
+    /** 
+     * \brief Sets the bounding box of the input space. 
+     *
+     * @param lowerBound vector with the lower bounds of the hypercube
+     * @param upperBound vector with the upper bounds of the hypercube
+     */
+    void setBoundingBox( const vectord &lowerBound,
+			const vectord &upperBound);
+
+    /** 
+     * \brief Runs a full optimization for each of several random
+     * embeddings and returns the best point found.
+     *
+     * @param bestPoint [out] best point in the input space
+     * @param nEmbeddings number of embeddings
+     */
+    void optimizeEmbeddings(vectord &bestPoint, size_t nEmbeddings);
+
+    /** Draws a new random embedding. The current data is discarded
+	at the next initialization of the optimization. */
+    void resetEmbedding();
+
+    /** Maps a point of the normalized embedded space to the input
+	space (clipped to the bounding box). */
+    vectord projectToInputSpace(const vectord &query);
+
+  protected:
+    /** Print data for every step according to the verbose level */
+    void plotStepData(size_t iteration, const vectord& xNext,
+		      double yNext);
+
+    /** Maps the query to the input space before evaluating it. */
+    double evaluateSampleInternal( const vectord &query );
+
+    /** The embedding cannot be inverted, thus external observations
+	are not supported. Throws std::invalid_argument. */
+    vectord normalizeInput(const vectord& x);
+
+    /** Same as projectToInputSpace. */
+    vectord unnormalizeInput(const vectord& x);
+
+    /** The bounding box of the input space and the embedding. */
+    utils::JournalDomain getJournalDomain();
+
+  private:
+    size_t mInputDims;                 ///< Dimensions of the input space
+    matrixd mA;                        ///< Random embedding
+    boost::uint64_t mEmbeddingSeed;    ///< Seed of mA
+    boost::scoped_ptr<utils::BoundingBox<vectord> > mInputBB;  ///< Input space limits
+
+  private:
+    RemboModel();                       ///< Default constructor forbidden.
+  };
+
+
   /**
    * \brief Bayesian optimization for functions in discrete spaces. 
    *
@@ -209,7 +334,7 @@ namespace bayesopt  {
 		     double yNext);
 
     /** Selects the initial set of points to build the surrogate model. */
-    void sampleInitialPoints(matrixd& xPoints, vectord& yPoints);
+    void sampleInitialDesign(matrixd& xPoints);
 
     /** Sample a single point in the input space. Used for epsilon
 	greedy exploration. */
@@ -221,6 +346,10 @@ namespace bayesopt  {
 
     void findOptimal(vectord &xOpt);
 
+    /** Relative to the largest side of the bounding box of the
+	input set, because the inputs are not normalized. */
+    double repeatedDistance();
+
   private:
     vecOfvec mInputSet;               ///< List of input points
 
@@ -26,10 +26,15 @@
 #ifndef  _BAYESOPTBASE_HPP_
 #define  _BAYESOPTBASE_HPP_
 
+#include <string>
 #include <boost/scoped_ptr.hpp>
-#include <boost/random.hpp>
 #include "parameters.h"
+#include "randgen.hpp"
 #include "specialtypes.hpp"
+#include "log.hpp"
+#include "datafile.hpp"
+#include "profiler.hpp"
+#include "tracer.hpp"
 //#include "posteriormodel.hpp"
 
 
@@ -43,6 +48,7 @@ namespace bayesopt {
   class PosteriorModel;
   class ProbabilityDistribution;
   class Dataset;
+  namespace utils { class Executor; class ThreadPool; class AsyncTask; }
 
   /** \addtogroup BayesOpt
    *  \brief Main module for Bayesian optimization
@@ -85,6 +91,22 @@ namespace bayesopt {
      * @return value of the function at the point evaluated.
      */
     virtual double evaluateSample( const vectord &query ) = 0;
+
+    /** 
+     * \brief Evaluates a batch of independent points, like the
+     * initial design. It can be overridden to send the whole batch to
+     * the application (a cluster, a simulator pool...). By default,
+     * it returns false and evaluateSample is called for every point
+     * with n_eval_threads threads, so evaluateSample must be thread
+     * safe if it is not 1.
+     *
+     * @param queries points to be evaluated.
+     * @param values [out] function value at each query, in the same order.
+     * @return true if the batch was evaluated.
+     */
+    virtual bool evaluateSamples( const vecOfvec &/*queries*/, 
+				  vectord &/*values*/ )
+    { return false; };
     
 
     /** 
@@ -121,24 +143,89 @@ namespace bayesopt {
     /** 
      * \brief Execute ONE step the optimization process of the
      * function defined in evaluateSample.  
+     *
+     * With pipelined_relearn, the surrogate model is learned in
+     * another thread while evaluateSample runs (also between ask and
+     * tell), so it must not use the model.
      */  
     void stepOptimization();
 
-    /** Initialize the optimization process.  */
+    /** Initialize the optimization process. If journal_mode requires
+	it, the optimizer is restored from the journal. Otherwise, if
+	load_save_flag requires it, the initial samples are loaded
+	from load_filename instead of being evaluated.  */
     void initializeOptimization();
 
+    /** 
+     * \brief Initialize the optimization process with previous
+     * observations instead of the initial design.
+     * 
+     * @param x inputs in row major order (n x dim)
+     * @param y function values (n)
+     * @param n number of observations
+     */
+    void initializeOptimization(const double *x, const double *y, size_t n);
+
+    /** 
+     * \brief Initial design (in the input space) without evaluating
+     * it. With initializeOptimization(x,y,n), ask and tell, the
+     * application can run the evaluations by itself.
+     * @param xPoints [in/out] one point per row (the number of rows
+     *                is the size of the design)
+     */
+    void getInitialDesign(matrixd& xPoints);
+
+    /** 
+     * \brief Next query (in the input space), to be evaluated by the
+     * application and reported with tell. The optimization must be
+     * initialized.
+     */
+    vectord ask();
+
+    /** 
+     * \brief Adds an observation and updates the surrogate model, as
+     * an iteration of stepOptimization. The query is usually the
+     * result of ask, but it can be any point of the input space.
+     */
+    void tell(const vectord& query, double value);
+
+    /** Mean and standard deviation of the surrogate model at a
+	point of the input space. */
+    void predict(const vectord& query, double& mean, double& std);
+
+    /** Save the current observations in a binary data file
+	(see utils::ObservationFile). */
+    void saveObservations(const std::string& filename);
+
     /** Once the optimization has been perfomed, return the optimal point. */
     virtual vectord getFinalResult() = 0;
 
     ProbabilityDistribution* getPrediction(const vectord& query);
     const Dataset* getData();
     bopt_params* getParameters();
+
+    /** Wall time and counters of the last optimization, per
+	iteration (see utils::Profiler). */
+    const utils::Profiler& getProfiler() const;
+
+    /** 
+     * \brief Runs the parallel loops of the optimizer in an executor
+     * owned by the application (for example, a pool of its own
+     * threads) instead of the internal pool of num_threads.
+     * @param executor not owned, it must outlive the optimization.
+     *                 NULL restores the internal pool.
+     */
+    void setExecutor(utils::Executor* executor);
     double getValueAtMinimum();
     double evaluateCriteria(const vectord& query);
 
   protected:
     vectord getPointAtMinimum();
 
+    /** Groups of input dimensions of additive surrogate models.
+     *  @return false if the model is not additive */
+    bool getInputGroups(vecOfGroups& groups);
+
     /** 
      * Print data for every step according to the verbose level
      * 
@@ -158,6 +245,16 @@ namespace bayesopt {
      */
     virtual double evaluateSampleInternal( const vectord &query ) = 0;
 
+    /** 
+     * \brief Evaluates the rows of xPoints (in the space of the
+     * surrogate model) in a single batch with evaluateSamples or,
+     * if it is not overridden, with evaluateSampleInternal in the
+     * evaluation pool.
+     * @param xPoints points to evaluate, one per row
+     * @param yPoints [out] value of each row
+     */
+    void evaluateSamplesInternal( const matrixd &xPoints, vectord &yPoints );
+
 
     /** 
      * \brief Returns the optimal point acording to certain criteria
@@ -167,34 +264,114 @@ namespace bayesopt {
      */
     virtual void findOptimal(vectord &xOpt) = 0;
   
-    /** Selects the initial set of points to build the surrogate model. */
-    virtual void sampleInitialPoints(matrixd& xPoints, vectord& yPoints) = 0;
+    /** Selects the initial set of points to build the surrogate
+	model (in the space of the model). */
+    virtual void sampleInitialDesign(matrixd& xPoints) = 0;
 
     /** Sample a single point in the input space. Used for epsilon
 	greedy exploration. */
     virtual vectord samplePoint() = 0;
 
+    /** Maps a point of the input space to the space of the
+	surrogate model (used for external observations). */
+    virtual vectord normalizeInput(const vectord& x)
+    { return x; };
+
+    /** Maps a point of the surrogate model to the input space. */
+    virtual vectord unnormalizeInput(const vectord& x)
+    { return x; };
+
+    /** Input space and space of the surrogate model, stored in the
+	journal to refuse the replay of a different problem. The
+	default is an unbounded input space equal to the model. */
+    virtual utils::JournalDomain getJournalDomain();
+
+    /** Distance (in the space of the surrogate model) below which a
+	query repeats a sample (see jump_repeated). The default is
+	for models in the unit hypercube. */
+    virtual double repeatedDistance()
+    { return 1e-6; };
+
   protected:
     bopt_params mParameters;                    ///< Configuration parameters
     size_t mDims;                                   ///< Number of dimensions
     size_t mCurrentIter;                        ///< Current iteration number
-    boost::mt19937 mEngine;                      ///< Random number generator
+    randEngine mEngine;        ///< Random number generator (STREAM_OPTIMIZER)
+    LogSettings mLogSettings;          ///< Log level and stream (see LogScope)
 
   private:
     boost::scoped_ptr<PosteriorModel> mModel;
     double mYPrev;
     size_t mCounterStuck;
+    vectord mAskedQuery;                    ///< Last ask (surrogate space)
+    vectord mAskedInput;                    ///< Last ask (input space)
+    utils::JournalSource mAskedSource;      ///< Origin of the last ask
+    utils::ObservationJournal mJournal;     ///< Journal of observations
+    utils::Profiler mProfiler;              ///< Timers and counters
+    FILE* mLogFile;                         ///< Owned log file or NULL
+    boost::scoped_ptr<utils::ThreadPool> mThreadPool; ///< Internal pool
+    utils::Executor* mExecutor;             ///< Parallel loops (NULL-Serial)
+    boost::scoped_ptr<utils::ThreadPool> mEvalPool; ///< See n_eval_threads
+
+    class EvaluationTask;
+
+    class LearningTask;
+    boost::scoped_ptr<LearningTask> mLearningTask;   ///< See pipelined_relearn
+    boost::scoped_ptr<utils::AsyncTask> mLearning;   ///< Worker of mLearningTask
+    bool mPipelinedFit;          ///< Model learned during the last evaluation
   private:
 
     BayesOptBase();
 
+    /** Learns the model once the initial samples are set. */
+    void fitInitialModel();
+
+    /** Learns the hyperparameters and fits the surrogate model. 
+	@param profiler profiler of the calling thread */
+    void learnAndFit(utils::Profiler& profiler);
+
+    /** True if the hyperparameters are learned in this iteration. */
+    bool isRelearnIteration();
+
+    /** 
+     * \brief If this iteration relearns and pipelined_relearn is set,
+     * learns the model with the current samples in a background
+     * thread. The model must not be used until waitForLearning.
+     */
+    void startPipelinedLearning();
+
+    /** Waits for the background learning (if any). */
+    void waitForLearning();
+
+    /** True if the spans are written to trace_filename. */
+    bool isTracing();
+
+    /** Restores the samples and the iteration from the journal.
+	@return false if there is nothing to replay. */
+    bool replayJournal();
+
+    /** Starts a new journal with the current samples. */
+    void startJournal();
+
     /** 
      * \brief Selects the next point to evaluate according to a certain
      * criteria or metacriteria
      * 
+     * @param source [out] origin of the point (criteria or random)
      * @return next point to evaluate
      */
-    vectord nextPoint();  
+    vectord nextPoint(utils::JournalSource& source);
+
+    /** nextPoint, replaced by a random point if it is repeated. */
+    vectord proposeNext(utils::JournalSource& source);
+
+    /** Counts the iterations without improvement.
+	@return true if a random jump is needed (see force_jump) */
+    bool updateStuck(double yNext);
+
+    /** Adds the sample and updates the model and the criteria. */
+    void addObservation(const vectord& xNext, double yNext,
+			utils::JournalSource source);  
 
   };
 
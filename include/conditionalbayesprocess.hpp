@@ -47,15 +47,6 @@ namespace bayesopt
 			    MeanModel& mean, randEngine& eng);
     virtual ~ConditionalBayesProcess();
 
-    /** 
-     * \brief Function that returns the prediction of the GP for a query point
-     * in the hypercube [0,1].
-     * 
-     * @param query in the hypercube [0,1] to evaluate the Gaussian process
-     * @return pointer to the probability distribution.
-     */	
-    virtual ProbabilityDistribution* prediction(const vectord &query) = 0;
-		 		 
     /** 
      * \brief Computes the score (eg:likelihood) of the kernel
      * parameters.  
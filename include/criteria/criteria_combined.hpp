@@ -74,6 +74,23 @@ namespace bayesopt
 	}
     };
 
+    void update(const vectord &x)
+    {
+      for (size_t i = 0; i < mCriteriaList.size(); ++i)
+	{
+	  mCriteriaList[i].update(x);
+	}
+    };
+
+    void setRandomEngine(randEngine& eng)
+    {
+      mtRandom = &eng;
+      for (size_t i = 0; i < mCriteriaList.size(); ++i)
+	{
+	  mCriteriaList[i].setRandomEngine(eng);
+	}
+    };
+
     size_t nParameters() 
     {
       size_t sum = 0;
@@ -60,6 +60,36 @@ namespace bayesopt
     double mW;
   };
 
+  /**
+   * \brief Distance in input space to the nearest sample in the data.
+   * With a negative weight, it can be combined with other criteria
+   * to avoid clustered queries. It uses the spatial index of the
+   * dataset, so the cost is O(log n).
+   */
+  class DataDistance: public Criteria
+  {
+  public:
+    void init(NonParametricProcess* proc)
+    { 
+      mProc = proc;
+      mW = 1;
+    };
+    virtual ~DataDistance(){};
+    void setParameters(const vectord &params)
+    { mW = params(0); };
+    size_t nParameters() {return 1;};
+ 
+    double operator() (const vectord &x) 
+    { 
+      double dist;
+      mProc->getData()->getNearestSample(x,dist);
+      return mW*dist;
+    };
+    std::string name() {return "cDataDistance";};
+  private:
+    double mW;
+  };
+
 
   //@}
 
@@ -80,7 +80,7 @@ namespace bayesopt
  
   protected:
     virtual double computeLoss(const vectord& query)
-    { return mProc->prediction(query)->sample_query(); }
+    { return mProc->prediction(query)->sample_query(*mtRandom); }
   };
 
 
@@ -33,20 +33,41 @@ namespace bayesopt
   /**\addtogroup CriteriaFunctions */
   //@{
 
-  /// Thompson sampling. Picks a random sample of the surrogate model.
+  /**
+   * \brief Thompson sampling. Picks a random sample of the surrogate
+   * model.
+   *
+   * One function is sampled per iteration (see
+   * NonParametricProcess::sampleFunction), so the inner optimizer
+   * explores a deterministic function. If the surrogate model does
+   * not support function samples, it falls back to independent
+   * samples of the predictive distribution at each query.
+   */
   class ThompsonSampling: public Criteria
   {
   public:
-    ThompsonSampling() {};
+    ThompsonSampling(): mResample(true), mFunctionSample(false) {};
     virtual ~ThompsonSampling(){};
     void setParameters(const vectord &params) { };
     size_t nParameters() {return 0;};
     double operator() (const vectord &x) 
     {
+      if (mResample)
+	{
+	  mFunctionSample = mProc->sampleFunction(*mtRandom);
+	  mResample = false;
+	}
+      if (mFunctionSample)  return mProc->evaluateSampledFunction(x);
+
       ProbabilityDistribution* d_ = mProc->prediction(x);
-      return d_->sample_query();
+      return d_->sample_query(*mtRandom);
     };
+    void update(const vectord &x) { mResample = true; };
     std::string name() {return "cThompsonSampling";};
+
+  protected:
+    bool mResample;          ///< A new function sample is required
+    bool mFunctionSample;    ///< The model supports function samples
   };
 
   /**
@@ -54,18 +75,15 @@ namespace bayesopt
    * A simple variation of Thompson sampling that picks only samples
    * that are better than the best outcome so far.
    */
-  class OptimisticSampling: public Criteria
+  class OptimisticSampling: public ThompsonSampling
   {
   public:
     OptimisticSampling() {};
     virtual ~OptimisticSampling(){};
-    void setParameters(const vectord &params) {};
-    size_t nParameters() {return 0;};
     double operator() (const vectord &x)  
     {
-      ProbabilityDistribution* d_ = mProc->prediction(x);
-      const double yStar = d_->sample_query();
-      const double yPred = d_->getMean();
+      const double yStar = ThompsonSampling::operator()(x);
+      const double yPred = mProc->prediction(x)->getMean();
       return (std::min)(yPred,yStar);
     };
     std::string name() {return "cOptimisticSampling";};
@@ -55,7 +55,7 @@ namespace bayesopt
 
     //Dummy functions. Not all criteria support these methods.
     virtual void reset() { assert(false); };
-    void setRandomEngine(randEngine& eng){ mtRandom = &eng; }
+    virtual void setRandomEngine(randEngine& eng){ mtRandom = &eng; }
 
     // In general, most criteria does not support comparisons!
     // TODO: Consider throwing exception when incorrect calls
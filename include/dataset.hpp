@@ -29,6 +29,7 @@
 #include "log.hpp"
 #include "specialtypes.hpp"
 #include "ublas_extra.hpp"
+#include "kdtree.hpp"
 
 namespace bayesopt
 {
@@ -45,7 +46,9 @@ namespace bayesopt
     virtual ~Dataset();
 
     void setSamples(const matrixd &x, const vectord &y);
+    void setSamples(const vecOfvec &x, const vectord &y);
     void addSample(const vectord &x, double y);
+    void removeSample(size_t index);
     double getSampleY(size_t index) const;
     vectord getSampleX(size_t index) const;
     double getLastSampleY() const;
@@ -55,14 +58,31 @@ namespace bayesopt
 
     vectord getPointAtMinimum() const;
     double getValueAtMinimum() const;
+    size_t getIndexAtMinimum() const;
     size_t getNSamples() const;
     void updateMinMax( size_t i );
 
+    /** 
+     * \brief Nearest sample to x (kd-tree search).
+     * @param dist [out] distance to the nearest sample
+     * @return index of the nearest sample (getNSamples() if empty)
+     */
+    size_t getNearestSample(const vectord& x, double& dist) const;
+
+    /** Indexes of the k nearest samples to x, sorted by distance */
+    void getNearestSamples(const vectord& x, size_t k, 
+			   std::vector<size_t>& indexes) const;
+
+    /** Indexes of the samples within a distance r of x */
+    void getSamplesInRadius(const vectord& x, double r, 
+			    std::vector<size_t>& indexes) const;
+
     vecOfvec mX;                                         ///< Data inputs
     vectord mY;                                          ///< Data values
 
   private:
     size_t mMinIndex, mMaxIndex;	
+    utils::KDTree mTree;           ///< Spatial index of mX
   };
 
 
@@ -71,6 +91,7 @@ namespace bayesopt
   inline void Dataset::addSample(const vectord &x, double y)
   {
     mX.push_back(x); utils::append(mY,y);
+    mTree.insert(x);
     updateMinMax(mY.size()-1);
   }
 
@@ -89,7 +110,19 @@ namespace bayesopt
 
   inline vectord Dataset::getPointAtMinimum() const { return mX[mMinIndex]; };
   inline double Dataset::getValueAtMinimum() const { return mY(mMinIndex); };
+  inline size_t Dataset::getIndexAtMinimum() const { return mMinIndex; };
   inline size_t Dataset::getNSamples() const { return mY.size(); };
+  inline size_t Dataset::getNearestSample(const vectord& x, double& dist) const
+  { return mTree.nearest(x,dist); };
+
+  inline void Dataset::getNearestSamples(const vectord& x, size_t k, 
+					 std::vector<size_t>& indexes) const
+  { mTree.knn(x,k,indexes); };
+
+  inline void Dataset::getSamplesInRadius(const vectord& x, double r,
+					  std::vector<size_t>& indexes) const
+  { mTree.radius(x,r,indexes); };
+
   inline void Dataset::updateMinMax( size_t i )
   {
     if ( mY(mMinIndex) > mY(i) )       mMinIndex = i;
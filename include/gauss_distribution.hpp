@@ -35,7 +35,7 @@ namespace bayesopt
   class GaussianDistribution: public ProbabilityDistribution
   {
   public:
-    GaussianDistribution(randEngine& eng);
+    GaussianDistribution();
     virtual ~GaussianDistribution();
 
     /** 
@@ -84,9 +84,10 @@ namespace bayesopt
 
     /** 
      * Sample outcome acording to the marginal distribution at the query point.
+     * @param eng random number engine
      * @return outcome
      */
-    double sample_query();
+    double sample_query(randEngine& eng);
 
     double getMean() { return mean_; };
     double getStd()  { return std_; };
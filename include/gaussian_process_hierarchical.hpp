@@ -53,6 +53,31 @@ namespace bayesopt
      */
     double negativeTotalLogLikelihood();
 
+    /** 
+     * \brief Same as negativeTotalLogLikelihood, but using conjugate
+     * gradients and a stochastic estimate of the log-determinant
+     * instead of the Cholesky decomposition (LS_CG).
+     */
+    double negativeTotalLogLikelihoodCG();
+
+    /** 
+     * \brief Computes the terms of the marginal likelihood with a
+     * Gaussian prior on the mean weights, that is, with correlation
+     * matrix \f$ K + F^T W F \f$. It uses the Woodbury identity and
+     * the matrix determinant lemma on top of the Cholesky
+     * decomposition of K, so only p x p matrices are factorized.
+     *
+     * @param L Cholesky decomposition of the correlation matrix K
+     * @param KF solution of L*KF = F^T
+     * @param w diagonal of the weight matrix W
+     * @param v vector of the quadratic form (eg: y - F^T w0)
+     * @param zz [out] quadratic form \f$ v^T (K + F^T W F)^{-1} v \f$
+     * @return log trace of the Cholesky decomposition of K + F^T W F
+     */
+    double computeWeightedMarginal(const matrixd& L, const matrixd& KF,
+				   const vectord& w, const vectord& v,
+				   double& zz);
+
   };
 
   /**@}*/
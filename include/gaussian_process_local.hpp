@@ -0,0 +1,138 @@
+/** \file gaussian_process_local.hpp
+    \brief Local (nearest neighbours) Gaussian process */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef  _GAUSSIAN_PROCESS_LOCAL_HPP_
+#define  _GAUSSIAN_PROCESS_LOCAL_HPP_
+
+#include <map>
+#include <boost/shared_ptr.hpp>
+#include "spinlock.hpp"
+#include "gauss_distribution.hpp"
+#include "conditionalbayesprocess.hpp"
+
+
+namespace bayesopt
+{
+  
+  /** \addtogroup NonParametricProcesses */
+  /**@{*/
+
+  /**
+   * \brief Local gaussian process with noisy observations. Each
+   * prediction is computed from the k nearest samples of the query
+   * (bopt_params::n_neighbours), found with the kd-tree of the
+   * dataset.
+   *
+   * The factorization of each neighbourhood is cached, because
+   * consecutive queries of the inner optimizer usually share the
+   * same neighbours. Thus, a prediction costs O(k^3) the first time
+   * and O(k^2) afterwards, independently of the number of samples.
+   *
+   * The hyperparameters are shared by all the neighbourhoods and they
+   * are learned with a composite likelihood of a few neighbourhoods
+   * centered at the incumbent and at samples spread over the data.
+   */
+  class LocalGaussianProcess: public ConditionalBayesProcess
+  {
+  public:
+    LocalGaussianProcess(size_t dim, bopt_params params, const Dataset& data, 
+			 MeanModel& mean, randEngine& eng);
+    virtual ~LocalGaussianProcess();
+
+    /** 
+     * \brief Function that returns the prediction of the GP for a query point
+     * in the hypercube [0,1].
+     * 
+     * @param query in the hypercube [0,1] to evaluate the Gaussian process
+     * @param d [out] distribution created by createPrediction()
+     */	
+    void predict(const vectord &query, ProbabilityDistribution& d) const;
+
+    ProbabilityDistribution* createPrediction() const;
+
+    /** There is no global model. It only clears the cache. */
+    void fitSurrogateModel();
+
+    /** The new sample might change the neighbourhoods. It only clears
+     * the cache. */
+    void updateSurrogateModel();
+
+    /** Neighbourhoods are computed on demand. Nothing to remove. */
+    void removeSample(size_t /*index*/) {};
+
+    /** Not available without a global model. */
+    vectord getLeaveOneOutVariance() { return vectord(); };
+
+  private:
+
+    /** 
+     * \brief Computes the negative log likelihood of the data for all
+     * the parameters.
+     * @return value negative log likelihood
+     */
+    double negativeTotalLogLikelihood();
+
+    /** 
+     * \brief Computes the negative composite log likelihood, that is,
+     * the sum of the likelihood of several neighbourhoods of the data.
+     * @return value negative log likelihood
+     */
+    double negativeLogLikelihood();
+
+    /** Nothing to precompute. The neighbourhoods depend on the query. */
+    void precomputePrediction() {};
+
+    /** Factorization of the correlation matrix of a neighbourhood */
+    struct LocalModel
+    {
+      vecOfvec mX;                ///< Inputs of the neighbours
+      matrixd mL;                 ///< Cholesky decomposition
+      vectord mAlphaV;            ///< Precomputed L\y
+    };
+
+    typedef boost::shared_ptr<const LocalModel> LocalModelPtr;
+    typedef std::map<std::vector<size_t>, LocalModelPtr> LocalModelCache;
+
+    /** 
+     * \brief Computes the local model of a set of samples.
+     * @return nonzero if the decomposition fails
+     */
+    size_t computeLocalModel(const std::vector<size_t>& indexes, 
+			     LocalModel& model) const;
+
+  private:
+    const size_t mNeighbours;     ///< Number of neighbours per prediction
+    /** Cached neighbourhoods. Filled by predict(), so it is guarded
+	by mCacheLock. Models are shared, thus clearing the cache does
+	not invalidate a model in use. */
+    mutable LocalModelCache mCache;
+    mutable utils::SpinLock mCacheLock;
+  };
+
+  /**@}*/
+
+} //namespace bayesopt
+ 
+
+#endif
@@ -51,9 +51,11 @@ namespace bayesopt
      * in the hypercube [0,1].
      * 
      * @param query in the hypercube [0,1] to evaluate the Gaussian process
-     * @return pointer to the probability distribution.
+     * @param d [out] distribution created by createPrediction()
      */	
-    ProbabilityDistribution* prediction(const vectord &query);
+    void predict(const vectord &query, ProbabilityDistribution& d) const;
+
+    ProbabilityDistribution* createPrediction() const;
 
   private:
 
@@ -77,7 +79,6 @@ namespace bayesopt
     vectord mVf;
     matrixd mKF, mD;     
 
-    GaussianDistribution* d_;      //!< Predictive distributions
   };
 
   /**@}*/
@@ -0,0 +1,148 @@
+/** \file gaussian_process_sparse.hpp 
+    \brief Sparse gaussian process based on inducing points (FITC/VFE) */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef  _GAUSSIAN_PROCESS_SPARSE_HPP_
+#define  _GAUSSIAN_PROCESS_SPARSE_HPP_
+
+#include "gauss_distribution.hpp"
+#include "conditionalbayesprocess.hpp"
+
+
+namespace bayesopt
+{
+  
+  /** \addtogroup NonParametricProcesses */
+  /**@{*/
+
+  /**
+   * \brief Sparse gaussian process with noisy observations based on
+   * a set of m inducing points (m << n).
+   *
+   * The inducing points are a subset of the data selected greedily
+   * by their residual variance (pivoted Cholesky). The set grows as
+   * new data arrives until it reaches the maximum size
+   * (bopt_params::n_inducing). Fitting costs O(n m^2), the
+   * predictive mean O(m) and the predictive variance O(m^2).
+   *
+   * It implements both the Fully Independent Training Conditional
+   * (FITC) approximation and the Variational Free Energy (VFE)
+   * bound of Titsias for the marginal likelihood.
+   */
+  class SparseGaussianProcess: public ConditionalBayesProcess
+  {
+  public:
+    SparseGaussianProcess(size_t dim, bopt_params params, const Dataset& data, 
+			  MeanModel& mean, randEngine& eng, bool useVFE = false);
+    virtual ~SparseGaussianProcess();
+
+    /** 
+     * \brief Function that returns the prediction of the GP for a query point
+     * in the hypercube [0,1].
+     * 
+     * @param query in the hypercube [0,1] to evaluate the Gaussian process
+     * @param d [out] distribution created by createPrediction()
+     */	
+    void predict(const vectord &query, ProbabilityDistribution& d) const;
+
+    ProbabilityDistribution* createPrediction() const;
+
+    /** 
+     * \brief Computes the surrogate model from scratch, including a
+     * new selection of the inducing points. 
+     */
+    void fitSurrogateModel();
+
+    /** 
+     * \brief Sequential update of the surrogate model. The last
+     * sample is added to the inducing set if there is room and it is
+     * not already explained by the current inducing points.
+     */   
+    void updateSurrogateModel();
+
+    /** 
+     * \brief The inducing points are kept even if the sample is
+     * removed, so there is nothing to downdate.
+     */
+    void removeSample(size_t /*index*/) {};
+
+    /** Not available for the sparse approximation. */
+    vectord getLeaveOneOutVariance() { return vectord(); };
+
+  private:
+
+    /** 
+     * \brief Computes the negative log likelihood of the data for all
+     * the parameters.
+     * @return value negative log likelihood
+     */
+    double negativeTotalLogLikelihood();
+
+    /** 
+     * \brief Computes the negative log likelihood of the data using
+     * the sparse approximation of the correlation matrix
+     * \f$ Q_{nn} + \Lambda \f$ with \f$ Q_{nn} = K_{nm} K_{mm}^{-1} K_{mn} \f$.
+     *
+     * @return value negative log likelihood
+     */
+    double negativeLogLikelihood();
+
+    /** Precompute some values of the prediction that do not depends
+     *	on the query
+     */
+    void precomputePrediction();
+
+    /** Selects the inducing set from the data by greedy maximization
+     *  of the residual variance. */
+    void selectInducingPoints();
+
+    /** 
+     * \brief Computes the factors of the sparse approximation for the
+     * current inducing set and hyperparameters.
+     *
+     * @param Lm Cholesky decomposition of \f$ K_{mm} \f$
+     * @param La Cholesky decomposition of \f$ I + V \Lambda^{-1} V^T \f$
+     *           where \f$ V = L_m^{-1} K_{mn} \f$
+     * @param b \f$ L_a^{-1} V \Lambda^{-1} (y - \mu) \f$
+     * @param lambda diagonal of \f$ \Lambda \f$
+     * @param trDiff trace of \f$ K_{nn} - Q_{nn} \f$
+     * @return \f$ (y - \mu)^T \Lambda^{-1} (y - \mu) \f$
+     */
+    double computeSparseFactors(matrixd& Lm, matrixd& La, vectord& b,
+				vectord& lambda, double& trDiff);
+
+  private:
+    size_t mMaxInducing;          ///< Maximum size of the inducing set
+    bool mUseVFE;                 ///< VFE bound instead of FITC
+    vecOfvec mInducing;           ///< Inducing points
+    matrixd mLm;                  ///< Cholesky decomposition of Kmm
+    matrixd mLa;                  ///< Cholesky decomposition of I + V Lambda^-1 V'
+    vectord mAlphaM;              ///< Precomputed weights of the mean
+  };
+
+  /**@}*/
+
+} //namespace bayesopt
+ 
+
+#endif
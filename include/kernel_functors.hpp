@@ -25,10 +25,13 @@
 #define  _KERNEL_FUNCTORS_HPP_
 
 #include <map>
+#include <stdexcept>
 #include <boost/scoped_ptr.hpp>
 #include <boost/math/distributions/normal.hpp> 
 #include "parameters.h"
 #include "specialtypes.hpp"
+#include "envelope_cholesky.hpp"
+#include "profiler.hpp"
 
 namespace bayesopt
 {
@@ -46,15 +49,67 @@ namespace bayesopt
     virtual ~Kernel(){};
     virtual void init(size_t input_dim) {};
     virtual void init(size_t input_dim, Kernel* left, Kernel* right) {};
+    virtual void init(size_t /*input_dim*/, 
+		      const std::vector<Kernel*>& /*kernels*/,
+		      const vecOfGroups& /*groups*/)
+    { throw std::invalid_argument("Kernel does not support input groups"); };
 
     virtual void setHyperParameters(const vectord &theta) = 0;
     virtual vectord getHyperParameters() = 0;
     virtual size_t nHyperParameters() = 0;
 
-    virtual double operator()( const vectord &x1, const vectord &x2 ) = 0;
+    virtual double operator()( const vectord &x1, const vectord &x2 ) const = 0;
     virtual double gradient( const vectord &x1, const vectord &x2,
 			     size_t component ) = 0;
 
+    /** 
+     * \brief Maps standard random draws to a sample of the spectral
+     * density of the kernel (Bochner's theorem). Used for random
+     * Fourier features. Only available for some stationary kernels.
+     *
+     * @param z sample of a standard normal distribution (size dim)
+     * @param u sample of a uniform distribution in (0,1)
+     * @param omega [out] random frequency
+     * @return false if the spectral density is not available
+     */
+    virtual bool spectralSample(const vectord &z, double u, vectord &omega)
+    { return false; };
+
+    /** 
+     * \brief Support radius of compactly supported kernels. The
+     * kernel is zero if any component of x1-x2 is larger than the
+     * corresponding radius.
+     * @param radius [out] support radius for each dimension
+     * @return false if the kernel has global support
+     */
+    virtual bool compactSupport(vectord &radius) const
+    { return false; };
+
+    /** 
+     * \brief Computes the Gram matrix of the samples (without
+     * nugget) when the kernel has a cheaper method than evaluating
+     * every pair of full input vectors.
+     * @return false if not available (pairwise evaluation is used)
+     */
+    virtual bool gramMatrix(const vecOfvec& XX, matrixd& K) const
+    { return false; };
+
+    /** 
+     * \brief Groups of input dimensions of additive kernels.
+     * @param groups [out] indexes of the dimensions of each group
+     * @return false if the kernel is not additive
+     */
+    virtual bool inputGroups(vecOfGroups& /*groups*/)
+    { return false; };
+
+    /** 
+     * \brief Reassigns the dimensions of an additive kernel.
+     * @return false if the kernel is not additive or the groups
+     * are not compatible
+     */
+    virtual bool setInputGroups(const vecOfGroups& /*groups*/)
+    { return false; };
+
   protected:
     size_t n_inputs;
   };
@@ -80,6 +135,13 @@ namespace bayesopt
     virtual ~KernelFactory () {};
   
     Kernel* create(std::string name, size_t input_dim);
+
+    /** 
+     * \brief Creates a kernel whose additive components (if any)
+     * act on the given groups of input dimensions.
+     */
+    Kernel* create(std::string name, size_t input_dim, 
+		   const vecOfGroups& groups);
     
   private:
     typedef Kernel* (*create_func_definition)();
@@ -109,24 +171,67 @@ namespace bayesopt
     void setKernel (const vectord &thetav, const vectord &stheta, 
 		   std::string k_name, size_t dim);
 
+    /** 
+     * \brief Select kernel with groups of input dimensions for
+     * additive kernels.
+     * @see setKernel
+     */
+    void setKernel (const vectord &thetav, const vectord &stheta, 
+		   std::string k_name, size_t dim, const vecOfGroups& groups);
+
     /** Wrapper of setKernel for C kernel structure */
     void setKernel (kernel_parameters kernel, size_t dim);
 
-    void computeCorrMatrix(const vecOfvec& XX, matrixd& corrMatrix, double nugget);
+    void computeCorrMatrix(const vecOfvec& XX, matrixd& corrMatrix, 
+			   double nugget) const;
+
+    /** 
+     * \brief Computes the lower triangle of the correlation matrix as
+     * sparse rows. Only for compactly supported kernels. The pairs
+     * within the support are found with a cell grid.
+     */
+    void computeSparseCorrMatrix(const vecOfvec& XX, 
+				 std::vector<utils::sparse_row>& corrMatrix,
+				 double nugget);
+
+    /** 
+     * \brief Computes the product of the correlation matrix and the
+     * columns of V without storing the matrix (matrix-free). Each
+     * kernel value is computed once and applied to all the columns.
+     */
+    void computeCorrProduct(const vecOfvec& XX, const matrixd& V,
+			    double nugget, matrixd& KV);
+
+    /** Groups of input dimensions (false if the kernel is not additive).
+     *  @see Kernel::inputGroups */
+    bool getInputGroups(vecOfGroups& groups);
+
+    /** Reassigns the input dimensions of an additive kernel. Groups
+     *  must keep their sizes. @see Kernel::setInputGroups */
+    bool setInputGroups(const vecOfGroups& groups);
+
+    /** True if the kernel has compact support (sparse correlation). */
+    bool hasCompactSupport() const;
     void computeDerivativeCorrMatrix(const vecOfvec& XX, matrixd& corrMatrix, 
 				    int dth_index);
-    vectord computeCrossCorrelation(const vecOfvec& XX, const vectord &query);
+    vectord computeCrossCorrelation(const vecOfvec& XX, 
+				    const vectord &query) const;
     void computeCrossCorrelation(const vecOfvec& XX, const vectord &query,
-				 vectord& knx);
-    double computeSelfCorrelation(const vectord& query);
+				 vectord& knx) const;
+    double computeSelfCorrelation(const vectord& query) const;
     double kernelLogPrior();
 
+    /** Sample of the spectral density of the kernel. 
+     *  @see Kernel::spectralSample */
+    bool spectralSample(const vectord &z, double u, vectord &omega);
+
   private:
     /** Set prior (Gaussian) for kernel hyperparameters */
     void setKernelPrior (const vectord &theta, const vectord &s_theta);
 
     boost::scoped_ptr<Kernel> mKernel;            ///< Pointer to kernel function
     std::vector<boost::math::normal> priorKernel; ///< Prior of kernel parameters
+    bool mCompactSupport;                         ///< Cached compactSupport
   };
 
   inline Kernel* KernelModel::getKernel()
@@ -142,7 +247,7 @@ namespace bayesopt
   {return mKernel->nHyperParameters();};
 
   inline vectord KernelModel::computeCrossCorrelation(const vecOfvec& XX, 
-						      const vectord &query)
+						      const vectord &query) const
   {
     vectord knx(XX.size());
     computeCrossCorrelation(XX,query,knx);
@@ -151,17 +256,34 @@ namespace bayesopt
 
   inline void KernelModel::computeCrossCorrelation(const vecOfvec& XX, 
 						   const vectord &query,
-						   vectord& knx)
+						   vectord& knx) const
   {
     std::vector<vectord>::const_iterator x_it  = XX.begin();
     vectord::iterator k_it = knx.begin();
     while(x_it != XX.end())
       {	*k_it++ = (*mKernel)(*x_it++, query); }
+    utils::Profiler::count(utils::COUNT_KERNEL, XX.size());
   }
 
 
-  inline double KernelModel::computeSelfCorrelation(const vectord& query)
-  { return (*mKernel)(query,query); }
+  inline double KernelModel::computeSelfCorrelation(const vectord& query) const
+  { 
+    utils::Profiler::count(utils::COUNT_KERNEL);
+    return (*mKernel)(query,query); 
+  }
+
+  inline bool KernelModel::hasCompactSupport() const
+  { return mCompactSupport; }
+
+  inline bool KernelModel::getInputGroups(vecOfGroups& groups)
+  { return mKernel->inputGroups(groups); }
+
+  inline bool KernelModel::setInputGroups(const vecOfGroups& groups)
+  { return mKernel->setInputGroups(groups); }
+
+  inline bool KernelModel::spectralSample(const vectord &z, double u, 
+					  vectord &omega)
+  { return mKernel->spectralSample(z,u,omega); }
 
   inline void KernelModel::setKernelPrior (const vectord &theta, 
 					   const vectord &s_theta)
@@ -29,6 +29,7 @@
 #include "ublas_cholesky.hpp"
 #include "nonparametricprocess.hpp"
 #include "kernel_functors.hpp"
+#include "random_features.hpp"
 
 namespace bayesopt
 {
@@ -68,6 +69,35 @@ namespace bayesopt
      */   
     void updateSurrogateModel();
 
+    /** 
+     * \brief Removes a row of the Cholesky decomposition of the
+     * Kernel matrix in O(n^2). The sparse decomposition is recomputed
+     * in the next update instead.
+     */
+    void removeSample(size_t index);
+
+    /** 
+     * \brief Leave-one-out variances from the diagonal of the inverse
+     * Kernel matrix, \f$ \sigma^2_{-i} = 1/[K^{-1}]_{ii} \f$.
+     * Only for the dense decomposition.
+     */
+    vectord getLeaveOneOutVariance();
+
+    /** 
+     * \brief Draws a sample function from the posterior using random
+     * Fourier features of the kernel. The weights are sampled from
+     * the Bayesian linear regression posterior in feature space.
+     * Drawing costs O(n D^2 + D^3) and evaluating O(D) for D
+     * features, independently of n.
+     *
+     * @return false if the kernel does not have a known spectral density
+     */
+    virtual bool sampleFunction(randEngine& eng);
+    double evaluateSampledFunction(const vectord &query);
+
+    bool getInputGroups(vecOfGroups& groups);
+    bool setInputGroups(const vecOfGroups& groups);
+
 
     // Getters and setters
     double getSignalVariance();
@@ -93,28 +123,86 @@ namespace bayesopt
     /** Computes the derivative of the correlation matrix with respect
      *	to the dth hyperparameter */
     matrixd computeDerivativeCorrMatrix(int dth_index);
-    vectord computeCrossCorrelation(const vectord &query);
-    double computeSelfCorrelation(const vectord& query);
+    vectord computeCrossCorrelation(const vectord &query) const;
+    double computeSelfCorrelation(const vectord& query) const;
 
     /** Computes the Cholesky decomposition of the Correlation matrix */
     void computeCholeskyCorrelation();
 
+    /** 
+     * \brief Computes the sparse (envelope) Cholesky decomposition of
+     * the Correlation matrix. Only for compactly supported kernels.
+     * @return nonzero if the decomposition fails
+     */
+    size_t computeSparseCholeskyCorrelation(utils::EnvelopeCholesky& L);
+
+    /** 
+     * \brief Whether the correlation matrix is sparse (compact
+     * kernel) and the derived class supports the sparse path.
+     */
+    bool useSparseCorrelation() const;
+
+    /** 
+     * \brief Solves \f$ L x = v \f$ in place, with L the Cholesky
+     * decomposition of the Correlation matrix (dense or sparse). In
+     * the sparse case the solution is permuted, so it should only be
+     * used in inner products.
+     */
+    void solveCholeskyCorrelation(vectord& v) const;
+
+    /** Whether the likelihood uses iterative solvers (LS_CG). */
+    bool useIterativeSolver();
+
+    /** 
+     * \brief Solves \f$ K X = B \f$ by preconditioned conjugate
+     * gradients with matrix-free products of the Correlation matrix.
+     * @return false if it did not converge
+     */
+    bool solveCorrelationCG(const matrixd& B, matrixd& X);
+
+    /** 
+     * \brief Estimates \f$ \log|K| \f$ of the Correlation matrix
+     * by stochastic Lanczos quadrature. The probes come from a fixed
+     * seed so the estimate is a deterministic function of the
+     * hyperparameters.
+     */
+    double estimateLogDetCorrelation();
+
+    /** 
+     * \brief Computes the scaled precision of the feature weights
+     * \f$ A = \Phi^T \Phi + \sigma_n I \f$ and \f$ b = \Phi^T (y - \mu) \f$
+     * for the current random feature map.
+     */
+    void computeFeatureCorrelation(matrixd& A, vectord& b);
+
+    /** 
+     * \brief Samples the weights of the random features.
+     * @param L Cholesky decomposition of the weights precision (A)
+     * @param wMean posterior mean of the weights
+     * @param eng random number engine
+     */
+    void sampleFeatureWeights(const matrixd& L, const vectord& wMean,
+			      randEngine& eng);
+
 
   protected:
     matrixd mL;             ///< Cholesky decomposition of the Correlation matrix
+    utils::EnvelopeCholesky mSparseL; ///< Sparse decomposition (compact kernels)
+    bool mSparseSupport;    ///< The derived class supports sparse correlations
     score_type mScoreType;
     learning_type mLearnType;
     int mLearnAll;
+    linsolve_type mSolverType;
     KernelModel mKernel;
+    const double mRegularizer;   ///< Std of the obs. model (also used as nugget)
+    RandomFeatures mFeatures;    ///< Random Fourier features of the kernel
+    vectord mSampledW;           ///< Weights of the last sampled function
 
   private:
     /** Adds a new point to the Cholesky decomposition of the
      * Correlation matrix. */
     void addNewPointToCholesky(const vectord& correlation,
 			      double selfcorrelation);
-
-
-    const double mRegularizer;   ///< Std of the obs. model (also used as nugget)
   };
 
   //// Inline methods
@@ -183,6 +271,12 @@ namespace bayesopt
       }
   };
 
+  inline bool KernelRegressor::getInputGroups(vecOfGroups& groups)
+  { return mKernel.getInputGroups(groups); }
+
+  inline bool KernelRegressor::setInputGroups(const vecOfGroups& groups)
+  { return mKernel.setInputGroups(groups); }
+
   // inline void KernelRegressor::setLearnType(learning_type l_type) 
   // { mLearnType = l_type; };
 
@@ -197,12 +291,36 @@ namespace bayesopt
     return corrMatrix;
   }
 
-  inline vectord KernelRegressor::computeCrossCorrelation(const vectord &query)
+  inline vectord KernelRegressor::computeCrossCorrelation(const vectord &query) const
   { return mKernel.computeCrossCorrelation(mData.mX,query); }
 
-  inline double KernelRegressor::computeSelfCorrelation(const vectord& query)
+  inline double KernelRegressor::computeSelfCorrelation(const vectord& query) const
   { return mKernel.computeSelfCorrelation(query); }
 
+  inline bool KernelRegressor::useSparseCorrelation() const
+  { return mSparseSupport && mKernel.hasCompactSupport(); }
+
+  inline void KernelRegressor::solveCholeskyCorrelation(vectord& v) const
+  {
+    if (useSparseCorrelation())
+      {
+	mSparseL.solveLower(v);
+      }
+    else
+      {
+	inplace_solve(mL,v,boost::numeric::ublas::lower_tag());
+      }
+  }
+
+  inline bool KernelRegressor::useIterativeSolver()
+  { return mSolverType == LS_CG; }
+
+  inline double KernelRegressor::evaluateSampledFunction(const vectord &query)
+  {
+    return mMean.muTimesFeat(query) 
+      + boost::numeric::ublas::inner_prod(mFeatures.getFeatures(query),mSampledW);
+  }
+
   inline void KernelRegressor::addNewPointToCholesky(const vectord& correlation,
 							  double selfcorrelation)
   {
@@ -0,0 +1,193 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+
+#ifndef  _KERNEL_ADDITIVE_HPP_
+#define  _KERNEL_ADDITIVE_HPP_
+
+#include <boost/numeric/ublas/vector_proxy.hpp>
+#include "kernel_functors.hpp"
+
+namespace bayesopt
+{
+  
+  /**\addtogroup KernelFunctions */
+  //@{
+
+  /** 
+   * \brief Additive kernel over groups of input dimensions. 
+   *
+   * It is the average of one kernel per group, each acting only on
+   * the dimensions of its group (Duvenaud et al. 2011, Kandasamy et
+   * al. 2015). The groups are defined with the kernel parameters and,
+   * because they are disjoint, each term of the Gram matrix only
+   * involves a low dimensional subset of the inputs.
+   *
+   * Usage: kAdditive(kSEARD) creates one kSEARD kernel per group.
+   */
+  class AdditiveKernel: public Kernel
+  {
+  public:
+    void init(size_t input_dim, const std::vector<Kernel*>& kernels,
+	      const vecOfGroups& groups)
+    {
+      n_inputs = input_dim;
+      mKernels = kernels;
+      mGroups = groups;
+    };
+
+    virtual ~AdditiveKernel()
+    {
+      for(size_t i=0; i<mKernels.size(); ++i)  delete mKernels[i];
+    };
+
+    void setHyperParameters(const vectord &theta) 
+    {
+      using boost::numeric::ublas::subrange;
+
+      if (theta.size() != nHyperParameters())
+	{
+	  FILE_LOG(logERROR) << "Wrong number of kernel hyperparameters"; 
+	  throw std::invalid_argument("Wrong number of kernel hyperparameters");
+	}
+      size_t start = 0;
+      for(size_t i=0; i<mKernels.size(); ++i)
+	{
+	  const size_t n = mKernels[i]->nHyperParameters();
+	  mKernels[i]->setHyperParameters(subrange(theta,start,start+n));
+	  start += n;
+	}
+    };
+
+    vectord getHyperParameters() 
+    {
+      using boost::numeric::ublas::subrange;
+
+      vectord par(nHyperParameters());
+      size_t start = 0;
+      for(size_t i=0; i<mKernels.size(); ++i)
+	{
+	  const size_t n = mKernels[i]->nHyperParameters();
+	  subrange(par,start,start+n) = mKernels[i]->getHyperParameters();
+	  start += n;
+	}
+      return par;
+    };
+
+    size_t nHyperParameters() 
+    {
+      size_t n = 0;
+      for(size_t i=0; i<mKernels.size(); ++i)
+	{ n += mKernels[i]->nHyperParameters(); }
+      return n;
+    };
+
+    double operator()(const vectord &x1, const vectord &x2) const
+    {
+      double k = 0.0;
+      for(size_t i=0; i<mKernels.size(); ++i)
+	{ k += (*mKernels[i])(project(x1,i),project(x2,i)); }
+      return k / mKernels.size();
+    };
+
+    double gradient(const vectord &x1, const vectord &x2,
+		    size_t component)
+    { 
+      size_t start = 0;
+      for(size_t i=0; i<mKernels.size(); ++i)
+	{
+	  const size_t n = mKernels[i]->nHyperParameters();
+	  if (component < start + n)
+	    {
+	      return mKernels[i]->gradient(project(x1,i),project(x2,i),
+					   component-start) / mKernels.size();
+	    }
+	  start += n;
+	}
+      return 0.0;
+    };
+
+    /** The Gram matrix is accumulated group by group, projecting
+	each sample only once per group. */
+    bool gramMatrix(const vecOfvec& XX, matrixd& K) const
+    {
+      const size_t nSamples = XX.size();
+      const double w = 1.0 / mKernels.size();
+      K = zmatrixd(nSamples,nSamples);
+      
+      vecOfvec XG(nSamples);
+      for(size_t g=0; g<mKernels.size(); ++g)
+	{
+	  for(size_t ii=0; ii<nSamples; ++ii)  XG[ii] = project(XX[ii],g);
+
+	  for(size_t ii=0; ii<nSamples; ++ii)
+	    {
+	      for(size_t jj=0; jj<=ii; ++jj)
+		{ K(ii,jj) += w * (*mKernels[g])(XG[ii],XG[jj]); }
+	    }
+	}
+
+      for(size_t ii=0; ii<nSamples; ++ii)
+	{
+	  for(size_t jj=0; jj<ii; ++jj)  K(jj,ii) = K(ii,jj);
+	}
+      return true;
+    };
+
+    bool inputGroups(vecOfGroups& groups)
+    { 
+      groups = mGroups;
+      return true; 
+    };
+
+    /** The new groups must have the same sizes as the current ones,
+	so the kernel of each group (and its hyperparameters) is kept. */
+    bool setInputGroups(const vecOfGroups& groups)
+    {
+      if (groups.size() != mGroups.size())  return false;
+      for(size_t i=0; i<groups.size(); ++i)
+	{
+	  if (groups[i].size() != mGroups[i].size())  return false;
+	}
+      mGroups = groups;
+      return true;
+    };
+
+  private:
+    /** Subset of the input dimensions of a group */
+    vectord project(const vectord& x, size_t group) const
+    {
+      const std::vector<size_t>& idx = mGroups[group];
+      vectord xg(idx.size());
+      for(size_t i=0; i<idx.size(); ++i)  xg(i) = x(idx[i]);
+      return xg;
+    };
+
+    std::vector<Kernel*> mKernels;     ///< One kernel per group
+    vecOfGroups mGroups;               ///< Input dimensions of each group
+  };
+
+  //@}
+
+} //namespace bayesopt
+
+#endif
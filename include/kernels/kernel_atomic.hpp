@@ -78,12 +78,16 @@ namespace bayesopt
     virtual ~ISOkernel(){};
 
   protected:
-    inline double computeWeightedNorm2(const vectord &x1, const vectord &x2)
+    inline double computeWeightedNorm2(const vectord &x1, const vectord &x2) const
     {  
       assert(n_inputs == x1.size());
       assert(x1.size() == x2.size());
       return norm_2(x1-x2)/params(0); 
     };
+
+    /** Scales a standard sample of the spectral density */
+    inline vectord scaleFrequency(const vectord &z)
+    { return z/params(0); };
   };
 
   /** \brief Abstract class for anisotropic kernel functors using ARD
@@ -95,7 +99,7 @@ namespace bayesopt
     virtual ~ARDkernel(){};
 
   protected:
-    inline double computeWeightedNorm2(const vectord &x1, const vectord &x2)
+    inline double computeWeightedNorm2(const vectord &x1, const vectord &x2) const
     {
       assert(n_inputs == x1.size());
       assert(x1.size() == x2.size());
@@ -105,6 +109,10 @@ namespace bayesopt
       vectord r = utils::ublas_elementwise_div(xd, params);
       return norm_2(r);
     };
+
+    /** Scales a standard sample of the spectral density */
+    inline vectord scaleFrequency(const vectord &z)
+    { return utils::ublas_elementwise_div(z, params); };
   };
 
   //@}
@@ -42,7 +42,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = 1; n_inputs = input_dim;  };
 
-    double operator()(const vectord &x1, const vectord &x2)
+    double operator()(const vectord &x1, const vectord &x2) const
     { return params(0); };
 
     double gradient(const vectord &x1, const vectord &x2,
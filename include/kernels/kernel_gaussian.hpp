@@ -38,7 +38,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = 1; n_inputs = input_dim;  };
 
-    double operator()( const vectord &x1, const vectord &x2)
+    double operator()( const vectord &x1, const vectord &x2) const
     {
       double rl = computeWeightedNorm2(x1,x2);
       double k = rl*rl;
@@ -52,6 +52,9 @@ namespace bayesopt
       double k = rl*rl;
       return exp(-k/2)*k;
     };
+
+    bool spectralSample(const vectord &z, double u, vectord &omega)
+    { omega = scaleFrequency(z);  return true; };
   };
 
 
@@ -62,7 +65,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = input_dim;  n_inputs = input_dim; };
 
-    double operator()( const vectord &x1, const vectord &x2 )
+    double operator()( const vectord &x1, const vectord &x2 ) const
     {
       double rl = computeWeightedNorm2(x1,x2);
       double k = rl*rl;
@@ -77,6 +80,9 @@ namespace bayesopt
       double r = (x1(component) - x2(component))/params(component);
       return exp(-k/2)*r*r;
     };
+
+    bool spectralSample(const vectord &z, double u, vectord &omega)
+    { omega = scaleFrequency(z);  return true; };
   };
 
 
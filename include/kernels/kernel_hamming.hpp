@@ -40,7 +40,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = 1; n_inputs = input_dim;  };
 
-    size_t hammingDistance(const vectori& s1, const vectori& s2)
+    size_t hammingDistance(const vectori& s1, const vectori& s2) const
     {
       size_t hdist = 0;
       vectori::const_iterator i1;
@@ -54,7 +54,7 @@ namespace bayesopt
       return hdist;
     }
 
-    double operator()(const vectord &x1, const vectord &x2)
+    double operator()(const vectord &x1, const vectord &x2) const
     { 
       const size_t n = x1.size();
       const double coef = -params(0)/2.0;
@@ -38,7 +38,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = 0;  n_inputs = input_dim; };
 
-    double operator()(const vectord &x1, const vectord &x2)
+    double operator()(const vectord &x1, const vectord &x2) const
     {
       assert(x1.size() == x2.size());
       return boost::numeric::ublas::inner_prod(x1,x2); 
@@ -57,7 +57,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = input_dim;  n_inputs = input_dim;  };
 
-    double operator()(const vectord &x1, const vectord &x2)
+    double operator()(const vectord &x1, const vectord &x2) const
     {
       assert(x1.size() == x2.size());
       vectord v1 = utils::ublas_elementwise_div(x1, params);
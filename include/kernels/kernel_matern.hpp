@@ -23,6 +23,7 @@
 #ifndef  _KERNEL_MATERN_HPP_
 #define  _KERNEL_MATERN_HPP_
 
+#include <boost/math/special_functions/gamma.hpp>
 #include "kernels/kernel_atomic.hpp"
 
 namespace bayesopt
@@ -31,6 +32,16 @@ namespace bayesopt
   /**\addtogroup KernelFunctions */
   //@{
 
+  /** 
+   * \brief Scale of the spectral density of a Matern kernel of order
+   * 2*nu, which is a Student's t distribution with 2*nu degrees of
+   * freedom (a Gaussian scale mixture).
+   * @param nu half the order of the Matern kernel
+   * @param u sample of a uniform distribution in (0,1)
+   */
+  inline double maternSpectralScale(double nu, double u)
+  { return std::sqrt(nu / boost::math::gamma_p_inv(nu,u)); }
+
 
   /** \brief Matern isotropic kernel of 1st order */
   class MaternIso1: public ISOkernel
@@ -39,7 +50,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = 1;  n_inputs = input_dim;  };
 
-    double operator()(const vectord &x1, const vectord &x2)
+    double operator()(const vectord &x1, const vectord &x2) const
     {
       double r = computeWeightedNorm2(x1,x2);
       return exp(-r);
@@ -51,6 +62,9 @@ namespace bayesopt
       double r = computeWeightedNorm2(x1,x2);
       return r*exp(-r);
     };
+
+    bool spectralSample(const vectord &z, double u, vectord &omega)
+    { omega = scaleFrequency(z) * maternSpectralScale(0.5,u);  return true; };
   };
 
 
@@ -61,7 +75,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = input_dim; n_inputs = input_dim;  };
 
-    double operator()(const vectord &x1, const vectord &x2)
+    double operator()(const vectord &x1, const vectord &x2) const
     {
       double r = computeWeightedNorm2(x1,x2);
       return exp(-r);
@@ -71,6 +85,9 @@ namespace bayesopt
     double gradient(const vectord &x1, const vectord &x2,
 		    size_t component)
     { assert(false);  return 0.0;  };
+
+    bool spectralSample(const vectord &z, double u, vectord &omega)
+    { omega = scaleFrequency(z) * maternSpectralScale(0.5,u);  return true; };
   };
 
 
@@ -81,7 +98,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = 1; n_inputs = input_dim;  };
 
-    double operator()( const vectord &x1, const vectord &x2)
+    double operator()( const vectord &x1, const vectord &x2) const
     {
       double r = sqrt(3.0) * computeWeightedNorm2(x1,x2);
       double er = exp(-r);
@@ -95,6 +112,9 @@ namespace bayesopt
       double er = exp(-r);
       return r*r*er; 
     };
+
+    bool spectralSample(const vectord &z, double u, vectord &omega)
+    { omega = scaleFrequency(z) * maternSpectralScale(1.5,u);  return true; };
   };
 
   /** \brief Matern ARD kernel of 3rd order */
@@ -104,7 +124,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = input_dim;  n_inputs = input_dim; };
 
-    double operator()( const vectord &x1, const vectord &x2)
+    double operator()( const vectord &x1, const vectord &x2) const
     {
       double r = sqrt(3.0) * computeWeightedNorm2(x1,x2);
       double er = exp(-r);
@@ -116,6 +136,9 @@ namespace bayesopt
     {
       assert(false); return 0.0;
     };
+
+    bool spectralSample(const vectord &z, double u, vectord &omega)
+    { omega = scaleFrequency(z) * maternSpectralScale(1.5,u);  return true; };
   };
 
 
@@ -126,7 +149,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = 1; n_inputs = input_dim;  };
 
-    double operator()( const vectord &x1, const vectord &x2)
+    double operator()( const vectord &x1, const vectord &x2) const
     {
       double r = sqrt(5.0) * computeWeightedNorm2(x1,x2);
       double er = exp(-r);
@@ -139,6 +162,9 @@ namespace bayesopt
       double er = exp(-r);
       return r*(1+r)/3*r*er; 
     };
+
+    bool spectralSample(const vectord &z, double u, vectord &omega)
+    { omega = scaleFrequency(z) * maternSpectralScale(2.5,u);  return true; };
   };
 
 
@@ -149,7 +175,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = input_dim;  n_inputs = input_dim; };
 
-    double operator()( const vectord &x1, const vectord &x2)
+    double operator()( const vectord &x1, const vectord &x2) const
     {
       double r = sqrt(5.0) * computeWeightedNorm2(x1,x2);
       double er = exp(-r);
@@ -160,6 +186,9 @@ namespace bayesopt
     double gradient( const vectord &x1, const vectord &x2,
 		     size_t component)
     { assert(false); return 0.0; };
+
+    bool spectralSample(const vectord &z, double u, vectord &omega)
+    { omega = scaleFrequency(z) * maternSpectralScale(2.5,u);  return true; };
   };
 
   //@}
@@ -40,7 +40,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = 2;  n_inputs = input_dim;  };
 
-    double operator()( const vectord &x1, const vectord &x2)
+    double operator()( const vectord &x1, const vectord &x2) const
     {
       double xx = boost::numeric::ublas::inner_prod(x1,x2); 
       return params(0)*params(0) * std::pow((params(1)+xx),static_cast<int>(mExp));
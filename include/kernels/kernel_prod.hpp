@@ -36,7 +36,7 @@ namespace bayesopt
   class KernelProd: public CombinedKernel
   {
   public:
-    double operator()(const vectord &x1, const vectord &x2)
+    double operator()(const vectord &x1, const vectord &x2) const
     { return (*left)(x1,x2) * (*right)(x1,x2); };
 
     //TODO: Not implemented
@@ -38,7 +38,7 @@ namespace bayesopt
     void init(size_t input_dim)
     { n_params = 2; n_inputs = input_dim; };
 
-    double operator()( const vectord &x1, const vectord &x2)
+    double operator()( const vectord &x1, const vectord &x2) const
     {
       double rl = computeWeightedNorm2(x1,x2);
       double k = rl*rl/(2*params(1));
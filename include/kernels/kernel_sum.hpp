@@ -35,7 +35,7 @@ namespace bayesopt
   class KernelSum: public CombinedKernel
   {
   public:
-    double operator()(const vectord &x1, const vectord &x2)
+    double operator()(const vectord &x1, const vectord &x2) const
     { return (*left)(x1,x2) + (*right)(x1,x2); };
 
     double gradient(const vectord &x1, const vectord &x2,
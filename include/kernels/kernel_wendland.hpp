@@ -0,0 +1,143 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef  _KERNEL_WENDLAND_HPP_
+#define  _KERNEL_WENDLAND_HPP_
+
+#include <cmath>
+#include "kernels/kernel_atomic.hpp"
+
+namespace bayesopt
+{
+  
+  /**\addtogroup KernelFunctions */
+  //@{
+
+  /** 
+   * \brief Wendland function \f$ \phi_{d,k}(r) \f$ of smoothness k
+   * (k = 0,1,2), which is zero for \f$ r \geq 1 \f$. It is positive
+   * definite in dimension d for \f$ \ell = \lfloor d/2 \rfloor + k + 1 \f$.
+   */
+  inline double wendlandFunction(double r, double ell, size_t k)
+  {
+    if (r >= 1.0) return 0.0;
+    const double s = 1.0 - r;
+    switch(k)
+      {
+      case 0: return std::pow(s,ell);
+      case 1: return std::pow(s,ell+1) * ((ell+1)*r + 1);
+      case 2: return std::pow(s,ell+2) * ((ell+1)*(ell+3)*r*r 
+					  + 3*(ell+2)*r + 3) / 3;
+      default: assert(false); return 0.0;
+      }
+  }
+
+  /** \brief Derivative of the Wendland function with respect to r */
+  inline double wendlandDerivative(double r, double ell, size_t k)
+  {
+    if (r >= 1.0) return 0.0;
+    const double s = 1.0 - r;
+    switch(k)
+      {
+      case 0: return -ell * std::pow(s,ell-1);
+      case 1: return -(ell+1)*(ell+2) * r * std::pow(s,ell);
+      case 2: return -(ell+3)*(ell+4) * r * ((ell+1)*r + 1) 
+	  * std::pow(s,ell+1) / 3;
+      default: assert(false); return 0.0;
+      }
+  }
+
+
+  /** 
+   * \brief Wendland kernel of compact support. Isotropic version. 
+   * The length scale is the support radius, so the correlation matrix
+   * is sparse if it is small with respect to the sample density.
+   */
+  template <size_t K>
+  class WendlandIso: public ISOkernel
+  {
+  public:
+    void init(size_t input_dim)
+    { 
+      n_params = 1;  n_inputs = input_dim;  
+      ell = static_cast<double>(input_dim/2 + K + 1);
+    };
+
+    double operator()(const vectord &x1, const vectord &x2) const
+    {
+      double r = computeWeightedNorm2(x1,x2);
+      return wendlandFunction(r,ell,K);
+    };
+
+    double gradient(const vectord &x1, const vectord &x2,
+		    size_t /*component*/)
+    {
+      double r = computeWeightedNorm2(x1,x2);
+      return -r*wendlandDerivative(r,ell,K);
+    };
+
+    bool compactSupport(vectord &radius) const
+    { radius = svectord(n_inputs,params(0));  return true; };
+
+  private:
+    double ell;
+  };
+
+
+  /** \brief Wendland kernel of compact support. ARD version. */
+  template <size_t K>
+  class WendlandARD: public ARDkernel
+  {
+  public:
+    void init(size_t input_dim)
+    { 
+      n_params = input_dim;  n_inputs = input_dim;  
+      ell = static_cast<double>(input_dim/2 + K + 1);
+    };
+
+    double operator()(const vectord &x1, const vectord &x2) const
+    {
+      double r = computeWeightedNorm2(x1,x2);
+      return wendlandFunction(r,ell,K);
+    };
+
+    double gradient(const vectord &x1, const vectord &x2,
+		    size_t component)
+    {
+      double r = computeWeightedNorm2(x1,x2);
+      if (r == 0.0) return 0.0;
+      double rc = (x1(component) - x2(component))/params(component);
+      return -wendlandDerivative(r,ell,K)*rc*rc/r;
+    };
+
+    bool compactSupport(vectord &radius) const
+    { radius = params;  return true; };
+
+  private:
+    double ell;
+  };
+
+  //@}
+
+} //namespace bayesopt
+
+#endif
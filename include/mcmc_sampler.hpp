@@ -82,12 +82,17 @@ namespace bayesopt {
 
     vectord getParticle(size_t i);
 
+    /** Log-likelihood of particle i, stored while sampling. */
+    double getLogLikelihood(size_t i);
+
     void printParticles();
 
   private:
-    void randomJump(vectord &x);
+    /** Moves x to a random point and returns its log-likelihood */
+    double randomJump(vectord &x);
     void burnOut(vectord &x);
-    void sliceSample(vectord &x);
+    /** Slice sampling step. Returns the log-likelihood of the new x */
+    double sliceSample(vectord &x);
 
     boost::scoped_ptr<RBOptimizableWrapper> obj;
 
@@ -99,6 +104,7 @@ namespace bayesopt {
 
     vectord mSigma;
     vecOfvec mParticles;
+    std::vector<double> mLogLik;     ///< Log-likelihood of mParticles
     randEngine& mtRandom;
 
   private: //Forbidden
@@ -118,12 +124,15 @@ namespace bayesopt {
   inline vectord MCMCSampler::getParticle(size_t i)
   { return mParticles[i]; };
 
+  inline double MCMCSampler::getLogLikelihood(size_t i)
+  { return mLogLik[i]; };
+
   inline void MCMCSampler::printParticles()
   {
     for(size_t i=0; i<mParticles.size(); ++i)
       { 
 	FILE_LOG(logDEBUG) << i << "->" << mParticles[i] 
-			   << " | Log-lik " << -obj->evaluate(mParticles[i]);
+			   << " | Log-lik " << mLogLik[i];
       }
   }
 
@@ -77,7 +77,7 @@ namespace bayesopt
       return 0;
     };
     double getMean (const vectord& x) { return 0.0; };
-    vectord getFeatures(const vectord& x) { return zvectord(1); };  
+    vectord getFeatures(const vectord& x) const { return zvectord(1); };  
   };
 
   /** \brief Constant one function */
@@ -92,7 +92,7 @@ namespace bayesopt
       return 0;
     };
     double getMean (const vectord& x) { return 1.0; };
-    vectord getFeatures(const vectord& x) { return svectord(1,1.0); };  
+    vectord getFeatures(const vectord& x) const { return svectord(1,1.0); };  
   };
 
 
@@ -109,7 +109,7 @@ namespace bayesopt
       return 0;
     };
     double getMean (const vectord& x) { return mParameters(0); };
-    vectord getFeatures(const vectord& x) { return svectord(1,1.0); };  
+    vectord getFeatures(const vectord& x) const { return svectord(1,1.0); };  
   };
 
 
@@ -127,7 +127,7 @@ namespace bayesopt
     };
     double getMean (const vectord& x)
     { return boost::numeric::ublas::inner_prod(x,mParameters);  };
-    vectord getFeatures(const vectord& x) { return x; };  
+    vectord getFeatures(const vectord& x) const { return x; };  
   };
 
 
@@ -158,7 +158,7 @@ namespace bayesopt
     double getMean (const vectord& x)
     { return boost::numeric::ublas::inner_prod(x,mParameters) + mConstParam;  };
 
-    vectord getFeatures(const vectord& x) 
+    vectord getFeatures(const vectord& x) const 
     {
       using boost::numeric::ublas::range;
       using boost::numeric::ublas::project;
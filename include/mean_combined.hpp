@@ -105,7 +105,7 @@ namespace bayesopt
       return left->getMean(x) + right->getMean(x);
     };
 
-    vectord getFeatures(const vectord &x)
+    vectord getFeatures(const vectord &x) const
     {
       using boost::numeric::ublas::subrange;
 
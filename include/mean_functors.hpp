@@ -29,6 +29,7 @@
 #include <boost/numeric/ublas/matrix_proxy.hpp>
 #include "parameters.h"
 #include "specialtypes.hpp"
+#include "ublas_extra.hpp"
 
 namespace bayesopt
 {
@@ -66,7 +67,7 @@ namespace bayesopt
 
 
     virtual size_t nFeatures() = 0;
-    virtual vectord getFeatures(const vectord& x) = 0;
+    virtual vectord getFeatures(const vectord& x) const = 0;
     virtual matrixd getAllFeatures(const vecOfvec& x)
     {
       size_t nf = nFeatures();
@@ -125,15 +126,16 @@ namespace bayesopt
     vectord getParameters();
     size_t nParameters();
 
-    vectord getFeatures(const vectord& x);  
-    void getFeatures(const vectord& x, vectord& kx);  
+    vectord getFeatures(const vectord& x) const;  
+    void getFeatures(const vectord& x, vectord& kx) const;  
     size_t nFeatures();
 
     void setPoints(const vecOfvec &x);
     void addNewPoint(const vectord &x);
+    void removePoint(size_t index);
 
     vectord muTimesFeat();
-    double muTimesFeat(const vectord& x);
+    double muTimesFeat(const vectord& x) const;
 
     /** 
      * \brief Select the parametric part of the surrogate process.
@@ -170,10 +172,10 @@ namespace bayesopt
   inline vectord MeanModel::getParameters(){return mMean->getParameters();};
   inline size_t MeanModel::nParameters(){return mMean->nParameters();};
 
-  inline vectord MeanModel::getFeatures(const vectord& x) 
+  inline vectord MeanModel::getFeatures(const vectord& x) const
   { return mMean->getFeatures(x); }
 
-  inline void MeanModel::getFeatures(const vectord& x, vectord& kx)
+  inline void MeanModel::getFeatures(const vectord& x, vectord& kx) const
   { kx = mMean->getFeatures(x); }  
 
   inline size_t MeanModel::nFeatures()
@@ -190,10 +192,15 @@ namespace bayesopt
     column(mFeatM,mFeatM.size2()-1) = mMean->getFeatures(x);
   }
 
+  inline void MeanModel::removePoint(size_t index)
+  { 
+    utils::erase_column(mFeatM,index);
+  }
+
   inline vectord MeanModel::muTimesFeat()
   {  return boost::numeric::ublas::prod(mMu,mFeatM); }
     
-  inline double MeanModel::muTimesFeat(const vectord& x)
+  inline double MeanModel::muTimesFeat(const vectord& x) const
   { return boost::numeric::ublas::inner_prod(mMu,mMean->getFeatures(x));}
 
 
@@ -26,6 +26,8 @@
 #ifndef __BAYESIANREGRESSOR_HPP__
 #define __BAYESIANREGRESSOR_HPP__
 
+#include <stdexcept>
+#include <boost/scoped_ptr.hpp>
 #include "dataset.hpp"
 #include "prob_distribution.hpp"
 #include "mean_functors.hpp"
@@ -62,11 +64,33 @@ namespace bayesopt
     /** 
      * \brief Function that returns the prediction of the GP for a query point
      * in the hypercube [0,1].
+     *
+     * The distribution is stored in the process and it is overwritten
+     * by the next call. Use predict() for concurrent or nested calls.
      * 
      * @param query in the hypercube [0,1] to evaluate the Gaussian process
      * @return pointer to the probability distribution.
      */	
-    virtual ProbabilityDistribution* prediction(const vectord &query) = 0;
+    ProbabilityDistribution* prediction(const vectord &query);
+
+    /** 
+     * \brief Reentrant prediction. It does not modify the process, so
+     * it can be called from several threads while the model is not
+     * being updated.
+     * 
+     * @param query in the hypercube [0,1] to evaluate the process
+     * @param d [out] predictive distribution. It must have been
+     *          created by createPrediction() of this process.
+     */	
+    virtual void predict(const vectord &query, 
+			 ProbabilityDistribution& d) const = 0;
+
+    /** 
+     * \brief Creates a predictive distribution of the right type
+     * (Gaussian, Student's t...) to be used with predict(). 
+     * @return new distribution, owned by the caller.
+     */	
+    virtual ProbabilityDistribution* createPrediction() const = 0;
 		 		 
     /** 
      * \brief Computes the initial surrogate model and updates the
@@ -86,6 +110,59 @@ namespace bayesopt
      */   
     virtual void updateSurrogateModel() = 0;
 
+    /** 
+     * \brief Removes a sample from the surrogate model (eg: downdate
+     * of the Kernel decomposition) instead of recomputing it. It is
+     * called before the sample is removed from the dataset and the
+     * model is completed in the next updateSurrogateModel.
+     *
+     * @param index index of the sample in the dataset
+     */
+    virtual void removeSample(size_t index) {};
+
+    /** 
+     * \brief Leave-one-out predictive variance of each sample (up to
+     * a common scale), as a measure of how informative they are.
+     * @return variance per sample or empty vector if not available
+     */
+    virtual vectord getLeaveOneOutVariance() { return vectord(); };
+
+    /** 
+     * \brief Draws a sample function from the posterior of the
+     * surrogate model. Contrary to sampling the predictive
+     * distribution at each query, the sample is a consistent
+     * (deterministic) function that can be evaluated with
+     * evaluateSampledFunction() until the next call.
+     *
+     * @param eng random number engine
+     * @return false if the model does not support function samples
+     */
+    virtual bool sampleFunction(randEngine& /*eng*/) { return false; };
+
+    /** 
+     * \brief Evaluates the function drawn by sampleFunction().
+     * @param query point to evaluate
+     * @return value of the sampled function
+     */
+    virtual double evaluateSampledFunction(const vectord &query)
+    { throw std::runtime_error("Function samples not supported"); };
+
+
+    /** 
+     * \brief Groups of input dimensions of additive models.
+     * @param groups [out] indexes of the dimensions of each group
+     * @return false if the model is not additive
+     */
+    virtual bool getInputGroups(vecOfGroups& /*groups*/) { return false; };
+
+    /** 
+     * \brief Reassigns the input dimensions of the groups of an
+     * additive model. The model must be fitted again afterwards.
+     * @return false if the model is not additive or the groups are
+     * not compatible
+     */
+    virtual bool setInputGroups(const vecOfGroups& /*groups*/) 
+    { return false; };
 
     // Getters and setters
     double getValueAtMinimum();
@@ -102,11 +179,23 @@ namespace bayesopt
     double mSigma;                                   //!< Signal variance
     size_t dim_;
     MeanModel& mMean;
+
+  private:
+    /** Storage of prediction(query) */
+    boost::scoped_ptr<ProbabilityDistribution> mPrediction;
   };
 
   //////////////////////////////////////////////////////////////////////////////
   //// Inlines
 
+  inline ProbabilityDistribution* 
+  NonParametricProcess::prediction(const vectord &query)
+  {
+    if (!mPrediction)  mPrediction.reset(createPrediction());
+    predict(query,*mPrediction);
+    return mPrediction.get();
+  }
+
   inline double NonParametricProcess::getValueAtMinimum() 
   { return mData.getValueAtMinimum(); };
 
@@ -51,6 +51,12 @@ extern "C" {
     SC_ERROR = -1
   } score_type;
 
+  typedef enum {
+    LS_CHOLESKY,
+    LS_CG,
+    LS_ERROR = -1
+  } linsolve_type;
+
 
   /** Kernel configuration parameters */
   typedef struct {
@@ -58,6 +64,10 @@ extern "C" {
     double hp_mean[128];         /**< Kernel hyperparameters prior (mean, log space) */
     double hp_std[128];          /**< Kernel hyperparameters prior (st dev, log space) */
     size_t n_hp;                 /**< Number of kernel hyperparameters */
+    int groups[128];             /**< Group label of each input dimension 
+				    (additive kernels) */
+    size_t n_groups;             /**< Number of group labels (0-One group 
+				    per dimension, or input dim) */
   } kernel_parameters;
 
   typedef struct {
@@ -74,12 +84,24 @@ extern "C" {
     size_t n_iterations;         /**< Maximum BayesOpt evaluations (budget) */
     size_t n_inner_iterations;   /**< Maximum inner optimizer evaluations */
     size_t n_init_samples;       /**< Number of samples before optimization */
+    size_t n_eval_threads;       /**< Threads evaluating the initial samples 
+				    (0-One per core, 1-Serial) */
     size_t n_iter_relearn;       /**< Number of samples before relearn kernel */
+    size_t pipelined_relearn;    /**< Relearn during the evaluation of the
+				    previous query (0-No, 1-Yes) */
+    size_t n_max_samples;        /**< Maximum size of the dataset (0-unbounded) */
+
+    /** Sample removed when the dataset is full 1-Oldest, 2-Least
+     *  informative (min. leave-one-out variance). The incumbent
+     *  is always kept. */
+    size_t evict_method;         
 
     /** Sampling method for initial set 1-LHS, 2-Sobol (if available),
      *  other value-uniformly distributed */
     size_t init_method;          
     int random_seed;             /**< >=0 -> Fixed seed, <0 -> Time based (variable). */    
+    size_t num_threads;          /**< Threads for parallel loops 
+				    (0-One per core, 1-Serial) */
 
     int verbose_level;           /**< Neg-Error,0-Warning,1-Info,2-Debug -> stdout
 				      3-Error,4-Warning,5-Info,>5-Debug -> logfile*/
@@ -90,6 +112,11 @@ extern "C" {
     char* load_filename;          /**< Init data file path (if applicable) */
     char* save_filename;          /**< Sava data file path (if applicable) */
 
+    size_t journal_mode;         /**< 0-No journal, 1-Write journal,
+				    2-Replay journal (if any) and continue */
+    char* journal_filename;      /**< Journal file path (if applicable) */
+    char* trace_filename;        /**< Chrome trace file path (empty-No trace) */
+
     char* surr_name;             /**< Name of the surrogate function */
     double sigma_s;              /**< Signal variance (if known). 
 				    Used in GaussianProcess and GaussianProcessNormal */
@@ -99,10 +126,21 @@ extern "C" {
 				    Used in StudentTProcessNIG */
     double beta;                 /**< Inverse Gamma prior for signal var. 
 				    Used in StudentTProcessNIG */
+    size_t n_inducing;           /**< Maximum number of inducing points.
+				    Used in SparseGaussianProcess */
+    size_t n_features;           /**< Number of random Fourier features. Used
+				    in RandomFeaturesProcess and function
+				    samples (Thompson sampling) */
+    size_t n_neighbours;         /**< Number of nearest samples per 
+				    prediction. Used in LocalGaussianProcess */
 
     score_type sc_type;          /**< Score type for kernel hyperparameters (ML,MAP,etc) */
     learning_type l_type;        /**< Type of learning for the kernel params */
     int l_all;                   /**< Learn all hyperparameters or only kernel */
+    int l_groups;                /**< Learn the groups of additive kernels 
+				    (only with empirical learning) */
+    linsolve_type ls_type;       /**< Linear solver for the likelihood 
+				    (Cholesky or conjugate gradient) */
 
     double epsilon;              /**< For epsilon-greedy exploration */
     size_t force_jump;           /**< If >0, and the difference between two 
@@ -111,6 +149,11 @@ extern "C" {
 				    jump. Avoid getting stuck if model is bad 
 				    and there is few data, however, it might 
 				    reduce the accuracy. */
+    size_t jump_repeated;        /**< If 1, a query repeating a previous 
+				    sample is replaced by a random jump */
+    double tr_length;            /**< Initial side of the trust region 
+				    (normalized input space). 0-Disabled,
+				    global search. */
 
     kernel_parameters kernel;    /**< Kernel parameters */
     mean_parameters mean;        /**< Mean (parametric function) parameters */
@@ -119,6 +162,23 @@ extern "C" {
     double crit_params[128];     /**< Criterion hyperparameters (if needed) */
     size_t n_crit_params;        /**< Number of criterion hyperparameters */
   } bopt_params;
+
+  /** \brief Wall time (seconds) and counters of the optimization, 
+   *  either for one iteration or accumulated.
+   */
+  typedef struct {
+    size_t iteration;            /**< Iteration (0-initialization) or 
+				    number of iterations (accumulated) */
+    double t_learning;           /**< Hyperparameter learning */
+    double t_fit;                /**< Full fit of the surrogate model */
+    double t_update;             /**< Incremental update of the surrogate */
+    double t_criteria;           /**< Optimization of the criteria */
+    double t_evaluation;         /**< Evaluation of the target function */
+    size_t n_kernel;             /**< Kernel function evaluations */
+    size_t n_cholesky;           /**< Cholesky factorizations */
+    size_t n_criteria;           /**< Criteria evaluations */
+    size_t n_likelihood;         /**< Score (likelihood) evaluations */
+  } bopt_profile;
 						    
   /*-----------------------------------------------------------*/
   /* These functions are added to simplify wrapping code       */
@@ -129,6 +189,9 @@ extern "C" {
   BAYESOPT_API score_type str2score(const char* name);
   BAYESOPT_API const char* score2str(score_type name);
 
+  BAYESOPT_API linsolve_type str2linsolve(const char* name);
+  BAYESOPT_API const char* linsolve2str(linsolve_type name);
+
   BAYESOPT_API void set_kernel(bopt_params* params, const char* name);
   BAYESOPT_API void set_mean(bopt_params* params, const char* name);
   BAYESOPT_API void set_criteria(bopt_params* params, const char* name);
@@ -136,8 +199,11 @@ extern "C" {
   BAYESOPT_API void set_log_file(bopt_params* params, const char* name);
   BAYESOPT_API void set_load_file(bopt_params* params, const char* name);
   BAYESOPT_API void set_save_file(bopt_params* params, const char* name);
+  BAYESOPT_API void set_journal_file(bopt_params* params, const char* name);
+  BAYESOPT_API void set_trace_file(bopt_params* params, const char* name);
   BAYESOPT_API void set_learning(bopt_params* params, const char* name);
   BAYESOPT_API void set_score(bopt_params* params, const char* name);
+  BAYESOPT_API void set_linsolve(bopt_params* params, const char* name);
 
   BAYESOPT_API bopt_params initialize_parameters_to_default(void);
 
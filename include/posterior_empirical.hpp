@@ -69,6 +69,11 @@ namespace bayesopt {
     std::string getBestCriteria(vectord& best);
 
     ProbabilityDistribution* getPrediction(const vectord& query);
+    bool getInputGroups(vecOfGroups& groups);
+
+  protected:
+    void removeSurrogateSample(size_t index);
+    vectord getLeaveOneOutVariance();
 
   private:
     EmpiricalBayes();
@@ -76,11 +81,19 @@ namespace bayesopt {
     void setSurrogateModel(randEngine& eng);    
     void setCriteria(randEngine& eng);
 
+    /** 
+     * \brief Selects the groups of input dimensions of additive
+     * kernels by maximizing the score among random reassignments of
+     * the dimensions (Kandasamy et al. 2015).
+     */
+    void learnInputGroups();
+
   private:  // Members
     boost::scoped_ptr<NonParametricProcess> mGP; ///< Pointer to surrogate model
     boost::scoped_ptr<Criteria> mCrit;                   ///< Metacriteria model
 
     boost::scoped_ptr<NLOPT_Optimization> kOptimizer;
+    randEngine mEngine;          ///< Input groups (STREAM_LEARNING)
   };
 
   /**@}*/
@@ -91,6 +104,15 @@ namespace bayesopt {
   inline void EmpiricalBayes::updateSurrogateModel()
   { mGP->updateSurrogateModel(); };
 
+  inline void EmpiricalBayes::removeSurrogateSample(size_t index)
+  { mGP->removeSample(index); };
+
+  inline vectord EmpiricalBayes::getLeaveOneOutVariance()
+  { return mGP->getLeaveOneOutVariance(); };
+
+  inline bool EmpiricalBayes::getInputGroups(vecOfGroups& groups)
+  { return mGP->getInputGroups(groups); };
+
   inline double EmpiricalBayes::evaluateCriteria(const vectord& query)
   { return (*mCrit)(query); };
 
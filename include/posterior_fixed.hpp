@@ -68,6 +68,11 @@ namespace bayesopt {
     std::string getBestCriteria(vectord& best);
 
     ProbabilityDistribution* getPrediction(const vectord& query);
+    bool getInputGroups(vecOfGroups& groups);
+
+  protected:
+    void removeSurrogateSample(size_t index);
+    vectord getLeaveOneOutVariance();
 
   private:
     PosteriorFixed();
@@ -91,6 +96,15 @@ namespace bayesopt {
   inline void PosteriorFixed::updateSurrogateModel()
   { mGP->updateSurrogateModel(); };
 
+  inline void PosteriorFixed::removeSurrogateSample(size_t index)
+  { mGP->removeSample(index); };
+
+  inline vectord PosteriorFixed::getLeaveOneOutVariance()
+  { return mGP->getLeaveOneOutVariance(); };
+
+  inline bool PosteriorFixed::getInputGroups(vecOfGroups& groups)
+  { return mGP->getInputGroups(groups); };
+
   inline double PosteriorFixed::evaluateCriteria(const vectord& query)
   { return (*mCrit)(query); };
 
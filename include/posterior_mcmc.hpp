@@ -75,6 +75,11 @@ namespace bayesopt {
     std::string getBestCriteria(vectord& best);
 
     ProbabilityDistribution* getPrediction(const vectord& query);
+    bool getInputGroups(vecOfGroups& groups);
+
+  protected:
+    void removeSurrogateSample(size_t index);
+    vectord getLeaveOneOutVariance();
    
   private:
     void setSurrogateModel(randEngine& eng);    
@@ -84,7 +89,10 @@ namespace bayesopt {
     size_t nParticles;
     GPVect mGP;                ///< Pointer to surrogate model
     CritVect mCrit;                    ///< Metacriteria model
+    std::vector<randEngine> mGPEngines;     ///< One stream per particle
+    std::vector<randEngine> mCritEngines;   ///< One stream per particle
 
+    randEngine mSamplerEngine;               ///< MCMC (STREAM_MCMC)
     boost::scoped_ptr<MCMCSampler> kSampler;
 
   private: //Forbidden
@@ -94,18 +102,19 @@ namespace bayesopt {
 
   /**@}*/
 
-  inline void MCMCModel::fitSurrogateModel()
-  { 
-    for(GPVect::iterator it=mGP.begin(); it != mGP.end(); ++it)
-      it->fitSurrogateModel(); 
-  };
-
-  inline void MCMCModel::updateSurrogateModel()
+  inline void MCMCModel::removeSurrogateSample(size_t index)
   {     
     for(GPVect::iterator it=mGP.begin(); it != mGP.end(); ++it)
-      it->updateSurrogateModel(); 
+      it->removeSample(index); 
   };
 
+  // As in the prediction, we use the first particle.
+  inline vectord MCMCModel::getLeaveOneOutVariance()
+  { return mGP[0].getLeaveOneOutVariance(); };
+
+  inline bool MCMCModel::getInputGroups(vecOfGroups& groups)
+  { return mGP[0].getInputGroups(groups); };
+
   inline double MCMCModel::evaluateCriteria(const vectord& query)
   { 
     double sum = 0.0;
@@ -49,6 +49,8 @@ namespace bayesopt {
     /** 
      * Constructor
      * @param params set of parameters (see parameters.h)
+     * @param eng engine of the optimizer. The streams of the model
+     *        are derived from its seed (see RandomStream).
      */
     PosteriorModel(size_t dim, bopt_params params, randEngine& eng);
 
@@ -72,6 +74,7 @@ namespace bayesopt {
 
 
     void setSamples(const matrixd &x, const vectord &y);
+    void setSamples(const vecOfvec &x, const vectord &y);
     void setSample(const vectord &x, double y);
     void addSample(const vectord &x, double y);
     double getValueAtMinimum();
@@ -82,12 +85,41 @@ namespace bayesopt {
     const Dataset* getData();
     virtual ProbabilityDistribution* getPrediction(const vectord& query) = 0;
 
+    /** Groups of input dimensions of additive surrogate models.
+     *  @return false if the model is not additive */
+    virtual bool getInputGroups(vecOfGroups& groups) = 0;
+
+
+  protected:
+    /** 
+     * \brief Removes a sample from the surrogate model(s), before it
+     * is removed from the dataset.
+     */
+    virtual void removeSurrogateSample(size_t index) = 0;
+
+    /** Leave-one-out variance of the samples (empty if not available) */
+    virtual vectord getLeaveOneOutVariance() = 0;
+
+    /** 
+     * \brief Selects the sample to remove when the dataset exceeds
+     * n_max_samples. It never selects the incumbent or the last sample.
+     */
+    size_t selectEvictedSample();
+
+    /** 
+     * \brief Removes the oldest samples (except the incumbent) if a
+     * bulk load exceeds n_max_samples. The surrogate is not fitted yet,
+     * so only the data is changed.
+     */
+    void trimSamples();
 
   protected:
     bopt_params mParameters;                     ///< Configuration parameters
     size_t mDims;                                    ///< Number of dimensions
     Dataset mData;                ///< Dataset (x-> inputs, y-> labels/output)
     MeanModel mMean;
+    randEngine mModelEngine;                  ///< Surrogate (STREAM_MODEL)
+    randEngine mCriteriaEngine;            ///< Criteria (STREAM_CRITERIA)
 
   private:
     PosteriorModel();
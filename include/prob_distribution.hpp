@@ -35,7 +35,6 @@ namespace bayesopt
   class ProbabilityDistribution
   {
   public:
-    ProbabilityDistribution(randEngine& eng): mtRandom(eng) {};
     virtual ~ProbabilityDistribution(){};
 
     /** 
@@ -79,13 +78,11 @@ namespace bayesopt
      * @param eng boost.random engine
      * @return outcome
      */
-    virtual double sample_query() = 0;
+    virtual double sample_query(randEngine& eng) = 0;
 
+    virtual void setMeanAndStd(double mean, double std) = 0;
     virtual double getMean() = 0;
     virtual double getStd() = 0;
-
-  protected:
-    randEngine& mtRandom;
   };
 
 } //namespace bayesopt
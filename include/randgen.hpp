@@ -27,10 +27,11 @@
 
 //#include <boost/version.hpp>
 #include <boost/random.hpp>
+#include "philox.hpp"
 
 // Types for pseudorandom number generators.
 
-typedef boost::mt19937                                              randEngine;
+typedef bayesopt::utils::Philox4x32                                 randEngine;
 
 typedef boost::uniform_real<>				       realUniformDist;
 typedef boost::uniform_int<> 					intUniformDist;
@@ -42,4 +43,22 @@ typedef boost::variate_generator<randEngine&, normalDist>           randNFloat;
 typedef boost::variate_generator<randEngine&, gammaDist>            randGFloat;
 typedef boost::variate_generator<randEngine&, realUniformDist>       randFloat;
 
+/** Streams of randEngine for each component of the optimizer. They
+ *  are derived from the same seed, so the numbers drawn by one
+ *  component do not shift those of the others. */
+enum RandomStream {
+  STREAM_OPTIMIZER = 0,    ///< Initial design, exploration, embeddings
+  STREAM_MODEL     = 1,    ///< Surrogate model (e.g.: random features)
+  STREAM_CRITERIA  = 2,    ///< Criteria (e.g.: Thompson sampling, hedge)
+  STREAM_MCMC      = 3,    ///< MCMC sampling of the hyperparameters
+  STREAM_LEARNING  = 4     ///< Other hyperparameter learning (input groups)
+};
+
+/** Stream of the index-th particle or parallel task of a component,
+ *  so tasks that run at once do not share an engine. */
+inline boost::uint64_t taskStream(RandomStream component, size_t index)
+{ 
+  return ((static_cast<boost::uint64_t>(component) + 1) << 32) + index; 
+}
+
 #endif
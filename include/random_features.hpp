@@ -0,0 +1,86 @@
+/** \file random_features.hpp 
+    \brief Random Fourier features of stationary kernels */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef  _RANDOM_FEATURES_HPP_
+#define  _RANDOM_FEATURES_HPP_
+
+#include "randgen.hpp"
+#include "kernel_functors.hpp"
+
+namespace bayesopt
+{
+  
+  /**\addtogroup KernelFunctions */
+  //@{
+
+  /** 
+   * \brief Random Fourier features of a stationary kernel (Rahimi
+   * and Recht, 2007).
+   *
+   * By Bochner's theorem, \f$ k(x,x') \approx \phi(x)^T \phi(x') \f$
+   * with \f$ \phi(x) = \sqrt{2/D} \cos(W x + b) \f$, where the rows of
+   * W are samples of the spectral density of the kernel and b is
+   * uniform in \f$ [0,2\pi] \f$. The random draws are stored in
+   * standard form, so the map can be rescaled when the kernel
+   * hyperparameters change without drawing new samples.
+   */
+  class RandomFeatures
+  {
+  public:
+    RandomFeatures(size_t dim, size_t nFeatures);
+    virtual ~RandomFeatures() {};
+
+    /** Draws new random frequencies and phases */
+    void resample(randEngine& eng);
+
+    /** 
+     * \brief Computes the frequencies for the current kernel
+     * hyperparameters.
+     * @return false if the kernel does not have a known spectral
+     * density.
+     */
+    bool setKernel(KernelModel& kernel);
+
+    /** Feature vector of a point. Evaluation is O(D*dim) */
+    vectord getFeatures(const vectord& x) const;
+
+    size_t nFeatures();
+
+  private:
+    size_t mDim;
+    size_t mNFeatures;
+    matrixd mZ;             ///< Standard normal draws (D x dim)
+    vectord mU;             ///< Uniform draws (for scale mixtures)
+    vectord mPhase;         ///< Uniform phases in [0,2pi]
+    matrixd mW;             ///< Frequencies for the current kernel
+  };
+
+  inline size_t RandomFeatures::nFeatures()
+  { return mNFeatures; }
+
+  //@}
+
+} //namespace bayesopt
+
+#endif
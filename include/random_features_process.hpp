@@ -0,0 +1,118 @@
+/** \file random_features_process.hpp 
+    \brief Bayesian linear regression on random Fourier features */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef  _RANDOM_FEATURES_PROCESS_HPP_
+#define  _RANDOM_FEATURES_PROCESS_HPP_
+
+#include "gauss_distribution.hpp"
+#include "conditionalbayesprocess.hpp"
+
+
+namespace bayesopt
+{
+  
+  /** \addtogroup NonParametricProcesses */
+  /**@{*/
+
+  /**
+   * \brief Gaussian process approximated by Bayesian linear regression
+   * on D random Fourier features of the kernel (sparse spectrum).
+   *
+   * Only stationary kernels with known spectral density are
+   * supported (SE and Matern). Fitting costs O(n D^2 + D^3), the
+   * incremental update O(D^3) and the prediction O(D^2),
+   * independently of the number of samples. The feature map is fixed
+   * at construction and rescaled with the kernel hyperparameters.
+   */
+  class RandomFeaturesProcess: public ConditionalBayesProcess
+  {
+  public:
+    RandomFeaturesProcess(size_t dim, bopt_params params, const Dataset& data, 
+			  MeanModel& mean, randEngine& eng);
+    virtual ~RandomFeaturesProcess();
+
+    /** 
+     * \brief Function that returns the prediction of the GP for a query point
+     * in the hypercube [0,1].
+     * 
+     * @param query in the hypercube [0,1] to evaluate the Gaussian process
+     * @param d [out] distribution created by createPrediction()
+     */	
+    void predict(const vectord &query, ProbabilityDistribution& d) const;
+
+    ProbabilityDistribution* createPrediction() const;
+
+    /** Computes the posterior of the weights from scratch. */
+    void fitSurrogateModel();
+
+    /** Adds the last sample to the posterior of the weights. */
+    void updateSurrogateModel();
+
+    /** Removes a sample from the posterior of the weights (downdate). */
+    void removeSample(size_t index);
+
+    /** Not available in feature space. */
+    vectord getLeaveOneOutVariance() { return vectord(); };
+
+    /** Samples the weights with the current feature map. */
+    bool sampleFunction(randEngine& eng);
+
+  private:
+
+    /** 
+     * \brief Computes the negative log likelihood of the data for all
+     * the parameters.
+     * @return value negative log likelihood
+     */
+    double negativeTotalLogLikelihood();
+
+    /** 
+     * \brief Computes the negative log likelihood of the data using
+     * the low rank correlation matrix \f$ \Phi \Phi^T + \sigma_n I \f$.
+     *
+     * @return value negative log likelihood
+     */
+    double negativeLogLikelihood();
+
+    /** Precompute some values of the prediction that do not depends
+     *	on the query
+     */
+    void precomputePrediction();
+
+    /** Rescales the feature map with the current kernel hyperparameters */
+    void updateFeatureMap();
+
+  private:
+    matrixd mA;                   ///< Phi'Phi + noise*I
+    vectord mB;                   ///< Phi'(y-mu)
+    matrixd mLA;                  ///< Cholesky decomposition of mA
+    vectord mWMean;               ///< Posterior mean of the weights
+  };
+
+  /**@}*/
+
+} //namespace bayesopt
+ 
+
+#endif
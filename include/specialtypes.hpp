@@ -37,6 +37,7 @@ typedef boost::numeric::ublas::matrix<double>                   matrixd;
 typedef boost::numeric::ublas::zero_matrix<double>             zmatrixd;
 
 typedef std::vector<vectord>                                   vecOfvec;
+typedef std::vector<std::vector<size_t> >                   vecOfGroups;
 
 // Surprisingly, this is the most efficient version of a growing
 // matrix for uBlas, but I leave here the old experiments because it
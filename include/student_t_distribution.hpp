@@ -36,7 +36,7 @@ namespace bayesopt
   class StudentTDistribution: public ProbabilityDistribution
   {
   public:
-    StudentTDistribution(randEngine& eng);
+    StudentTDistribution();
     virtual ~StudentTDistribution();
 
     /** 
@@ -95,9 +95,10 @@ namespace bayesopt
 
     /** 
      * Sample outcome acording to the marginal distribution at the query point.
+     * @param eng random number engine
      * @return outcome
      */
-    double sample_query();
+    double sample_query(randEngine& eng);
 
     double getMean() { return mean_; };
     double getStd()  { return std_; };
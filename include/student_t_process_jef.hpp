@@ -51,9 +51,11 @@ namespace bayesopt
      * in the hypercube [0,1].
      * 
      * @param query in the hypercube [0,1] to evaluate the Student T process
-     * @return pointer to the probability distribution.
+     * @param d [out] distribution created by createPrediction()
      */	
-    ProbabilityDistribution* prediction(const vectord &query);
+    void predict(const vectord &query, ProbabilityDistribution& d) const;
+
+    ProbabilityDistribution* createPrediction() const;
 
   private:
 
@@ -72,12 +74,11 @@ namespace bayesopt
 
   private:
     vectord mWML;           //!< GP ML parameters
-    vectord mKn;
     /// Precomputed GP prediction operations
     vectord mAlphaF;
     matrixd mKF, mL2;
 
-    StudentTDistribution* d_;      //!< Predictive distributions
+    size_t mDof;                   //!< Degrees of freedom of the prediction
   };
 
   /**@}*/
@@ -53,9 +53,11 @@ namespace bayesopt
      * in the hypercube [0,1].
      * 
      * @param query in the hypercube [0,1] to evaluate the Gaussian process
-     * @return pointer to the probability distribution.
+     * @param d [out] distribution created by createPrediction()
      */	
-    ProbabilityDistribution* prediction(const vectord &query);
+    void predict(const vectord &query, ProbabilityDistribution& d) const;
+
+    ProbabilityDistribution* createPrediction() const;
 
   private:
 
@@ -79,7 +81,7 @@ namespace bayesopt
     vectord mVf;
     matrixd mKF, mD;     
 
-    StudentTDistribution* d_;      //!< Predictive distributions
+    size_t mDof;                   //!< Degrees of freedom of the prediction
   };
 
 
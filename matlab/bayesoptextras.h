@@ -37,6 +37,7 @@
 
 static void struct_value(const mxArray *s, const char *name, double *result);
 static void struct_array(const mxArray *s, const char *name, size_t *n, double *result);
+static void struct_int_array(const mxArray *s, const char *name, size_t *n, int *result);
 static void struct_size(const mxArray *s, const char *name, size_t *result);
 static void struct_int(const mxArray *s, const char *name, int *result);
 static void struct_string(const mxArray *s, const char *name, char* result);
@@ -108,6 +109,30 @@ void struct_array(const mxArray *s, const char *name, size_t *n, double *result)
 }
 
 
+void struct_int_array(const mxArray *s, const char *name, size_t *n, int *result)
+{
+  mxArray *val = mxGetField(s, 0, name);
+  size_t i;
+  if (val) 
+    {
+      if(!(mxIsNumeric(val) && !mxIsComplex(val)))
+	{
+	  mexErrMsgTxt("Param fields must be vector");
+	}
+      else
+	{	   
+	  *n = mxGetM(val) * mxGetN(val);
+	  for (i = 0; i < *n; ++i)  result[i] = (int)(mxGetPr(val)[i]);
+	}
+    }
+  else
+    {
+      mexPrintf("Field %s not found. Default not modified.\n", name);
+    }
+  return;
+}
+
+
 void struct_size(const mxArray *s, const char *name, size_t *result)
 {
   mxArray *val = mxGetField(s, 0, name);
@@ -222,7 +247,7 @@ bopt_params load_parameters(const mxArray* params)
   
   /* See parameters.h for the available options */
   
-  char l_str[100], sc_str[100], name[100];
+  char l_str[100], sc_str[100], ls_str[100], name[100];
   size_t n_hp_test, n_coef_test;
 
   bopt_params parameters = initialize_parameters_to_default();
@@ -234,12 +259,24 @@ bopt_params load_parameters(const mxArray* params)
   struct_size(params,"n_inner_iterations", &parameters.n_inner_iterations);
   struct_size(params, "n_init_samples", &parameters.n_init_samples);
   struct_size(params, "n_iter_relearn", &parameters.n_iter_relearn);
+  struct_size(params, "pipelined_relearn", &parameters.pipelined_relearn);
+  struct_size(params, "n_max_samples", &parameters.n_max_samples);
+  struct_size(params, "evict_method", &parameters.evict_method);
 
   struct_size(params, "init_method", &parameters.init_method);
   struct_int(params, "random_seed", &parameters.random_seed);
+  struct_size(params, "num_threads", &parameters.num_threads);
   
   struct_int(params, "verbose_level", &parameters.verbose_level);
   struct_string(params, "log_filename", parameters.log_filename);
+
+  struct_size(params, "load_save_flag", &parameters.load_save_flag);
+  struct_string(params, "load_filename", parameters.load_filename);
+  struct_string(params, "save_filename", parameters.save_filename);
+
+  struct_size(params, "journal_mode", &parameters.journal_mode);
+  struct_string(params, "journal_filename", parameters.journal_filename);
+  struct_string(params, "trace_filename", parameters.trace_filename);
   
   struct_string(params, "surr_name", parameters.surr_name);
 
@@ -247,6 +284,9 @@ bopt_params load_parameters(const mxArray* params)
   struct_value(params, "noise", &parameters.noise);
   struct_value(params, "alpha", &parameters.alpha);
   struct_value(params, "beta",  &parameters.beta);
+  struct_size(params, "n_inducing",  &parameters.n_inducing);
+  struct_size(params, "n_features",  &parameters.n_features);
+  struct_size(params, "n_neighbours",  &parameters.n_neighbours);
   
 
   strcpy( l_str, learn2str(parameters.l_type));
@@ -257,9 +297,17 @@ bopt_params load_parameters(const mxArray* params)
   struct_string(params, "sc_type", sc_str);
   parameters.sc_type = str2score(sc_str);
 
+  struct_int(params, "l_groups", &parameters.l_groups);
+
+  strcpy( ls_str, linsolve2str(parameters.ls_type));
+  struct_string(params, "ls_type", ls_str);
+  parameters.ls_type = str2linsolve(ls_str);
+
 
   struct_value(params, "epsilon",  &parameters.epsilon);
+  struct_value(params, "tr_length",  &parameters.tr_length);
   struct_size(params, "force_jump",  &parameters.force_jump);
+  struct_size(params, "jump_repeated",  &parameters.jump_repeated);
 
   struct_string(params, "crit_name", parameters.crit_name);
   struct_array(params, "crit_params", &parameters.n_crit_params, 
@@ -275,6 +323,9 @@ bopt_params load_parameters(const mxArray* params)
   CHECK0(parameters.kernel.n_hp == n_hp_test, 
 	 "Error processing kernel parameters");
 
+  struct_int_array(params, "kernel_groups", &parameters.kernel.n_groups, 
+	       &parameters.kernel.groups[0]);
+
   /* Mean function parameters */
   struct_string(params, "mean_name", parameters.mean.name);
   struct_array(params, "mean_coef_mean", &parameters.mean.n_coef, 
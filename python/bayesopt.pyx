@@ -43,11 +43,16 @@ cdef extern from "parameters.h":
     ctypedef enum score_type:
         pass
 
+    ctypedef enum linsolve_type:
+        pass
+
     ctypedef struct kernel_parameters:
         char*  name
         double* hp_mean
         double* hp_std
         unsigned int n_hp
+        int* groups
+        unsigned int n_groups
 
     ctypedef struct mean_parameters:
         char* name
@@ -59,22 +64,37 @@ cdef extern from "parameters.h":
         unsigned int n_iterations
         unsigned int n_inner_iterations
         unsigned int n_init_samples
+        unsigned int n_eval_threads
         unsigned int n_iter_relearn
+        unsigned int pipelined_relearn
+        unsigned int n_max_samples
+        unsigned int evict_method
         unsigned int init_method
         int random_seed
+        unsigned int num_threads
         int verbose_level
         char* log_filename
         unsigned int load_save_flag
         char* load_filename
         char* save_filename
+        unsigned int journal_mode
+        char* journal_filename
+        char* trace_filename
         char* surr_name
         double sigma_s
         double noise
         double alpha, beta
+        unsigned int n_inducing
+        unsigned int n_features
+        unsigned int n_neighbours
         score_type sc_type
         learning_type l_type
+        int l_groups
+        linsolve_type ls_type
         double epsilon
+        double tr_length
         unsigned int force_jump
+        unsigned int jump_repeated
         kernel_parameters kernel
         mean_parameters mean
         char* crit_name
@@ -87,6 +107,14 @@ cdef extern from "parameters.h":
     score_type str2score(char* name)
     char* score2str(score_type name)
 
+    linsolve_type str2linsolve(char* name)
+    char* linsolve2str(linsolve_type name)
+
+    ctypedef struct bopt_profile:
+        size_t iteration
+        double t_learning, t_fit, t_update, t_criteria, t_evaluation
+        size_t n_kernel, n_cholesky, n_criteria, n_likelihood
+
     void set_kernel(bopt_params* params, char* name)
     void set_mean(bopt_params* params, char* name)
     void set_criteria(bopt_params* params, char* name)
@@ -94,21 +122,43 @@ cdef extern from "parameters.h":
     void set_log_file(bopt_params* params, char* name)
     void set_load_file(bopt_params* params, char* name)
     void set_save_file(bopt_params* params, char* name)
+    void set_journal_file(bopt_params* params, char* name)
+    void set_trace_file(bopt_params* params, char* name)
     void set_learning(bopt_params* params, const char* name)
     void set_score(bopt_params* params, const char* name)
+    void set_linsolve(bopt_params* params, const char* name)
     
     bopt_params initialize_parameters_to_default()
 
 ###########################################################################
-cdef extern from "bayesopt.h":
+# The optimizer runs without the GIL. The callbacks take it back to
+# evaluate the Python function.
+cdef extern from "bayesopt.h" nogil:
     ctypedef double (*eval_func)(unsigned int n, const_double_ptr x,
                                  double *gradient, void *func_data)
 
+    ctypedef void (*eval_batch_func)(unsigned int n, unsigned int nDim,
+                                     const_double_ptr x, double *y,
+                                     void *func_data)
+
     int bayes_optimization(int nDim, eval_func f, void* f_data,
                            double *lb, double *ub, double *x,
                            double *minf,
                            bopt_params params)
 
+    int bayes_optimization_warm(int nDim, eval_func f, void* f_data,
+                                double *lb, double *ub,
+                                double *x_init, double *y_init,
+                                size_t n_init, double *x, double *minf,
+                                bopt_params params)
+
+    int bayes_optimization_batch(int nDim, eval_batch_func f, void* f_data,
+                                 double *lb, double *ub, double *x,
+                                 double *minf,
+                                 bopt_params params)
+
+    int bayes_optimization_last_profile(bopt_profile* profile)
+
     int bayes_optimization_disc(int nDim, eval_func f, void* f_data,
                                 double *valid_x, size_t n_points,
                                 double *x, double *minf,
@@ -118,6 +168,21 @@ cdef extern from "bayesopt.h":
                                         int *categories, double *x,
                                         double *minf, bopt_params parameters)
 
+    ctypedef struct bopt_optimizer:
+        pass
+
+    int bayes_optimizer_create(bopt_optimizer** opt, int nDim,
+                               double *lb, double *ub, bopt_params parameters)
+    void bayes_optimizer_free(bopt_optimizer* opt)
+    int bayes_optimizer_design(bopt_optimizer* opt, size_t n, double *x)
+    int bayes_optimizer_initialize(bopt_optimizer* opt, double *x_init,
+                                   double *y_init, size_t n_init)
+    int bayes_optimizer_ask(bopt_optimizer* opt, double *x)
+    int bayes_optimizer_tell(bopt_optimizer* opt, double *x, double y)
+    int bayes_optimizer_predict(bopt_optimizer* opt, size_t n, double *x,
+                                double *mean, double *std)
+    int bayes_optimizer_best(bopt_optimizer* opt, double *x, double *minf)
+
 ###########################################################################
 cdef bopt_params dict2structparams(dict dparams):
 
@@ -127,15 +192,33 @@ cdef bopt_params dict2structparams(dict dparams):
     params.n_inner_iterations = dparams.get('n_inner_iterations',
                                             params.n_inner_iterations)
     params.n_init_samples = dparams.get('n_init_samples',params.n_init_samples)
+    params.n_eval_threads = dparams.get('n_eval_threads',params.n_eval_threads)
     params.n_iter_relearn = dparams.get('n_iter_relearn',params.n_iter_relearn)
+    params.pipelined_relearn = dparams.get('pipelined_relearn',
+                                           params.pipelined_relearn)
 
+    params.n_max_samples = dparams.get('n_max_samples',params.n_max_samples)
+    params.evict_method = dparams.get('evict_method',params.evict_method)
     params.init_method = dparams.get('init_method',params.init_method)
     params.random_seed = dparams.get('random_seed',params.random_seed)
+    params.num_threads = dparams.get('num_threads',params.num_threads)
 
     params.verbose_level = dparams.get('verbose_level',params.verbose_level)
     name = dparams.get('log_filename',params.log_filename)
     set_log_file(&params,name)
 
+    params.load_save_flag = dparams.get('load_save_flag',params.load_save_flag)
+    name = dparams.get('load_filename',params.load_filename)
+    set_load_file(&params,name)
+    name = dparams.get('save_filename',params.save_filename)
+    set_save_file(&params,name)
+
+    params.journal_mode = dparams.get('journal_mode',params.journal_mode)
+    name = dparams.get('journal_filename',params.journal_filename)
+    set_journal_file(&params,name)
+    name = dparams.get('trace_filename',params.trace_filename)
+    set_trace_file(&params,name)
+
     name = dparams.get('surr_name',params.surr_name)
     set_surrogate(&params,name)
 
@@ -143,6 +226,9 @@ cdef bopt_params dict2structparams(dict dparams):
     params.noise = dparams.get('noise',params.noise)
     params.alpha = dparams.get('alpha',params.alpha)
     params.beta = dparams.get('beta',params.beta)
+    params.n_inducing = dparams.get('n_inducing',params.n_inducing)
+    params.n_features = dparams.get('n_features',params.n_features)
+    params.n_neighbours = dparams.get('n_neighbours',params.n_neighbours)
 
     learning = dparams.get('l_type', None)
     if learning is not None:
@@ -151,9 +237,17 @@ cdef bopt_params dict2structparams(dict dparams):
     score = dparams.get('sc_type', None)
     if score is not None:
         set_score(&params,score)
+
+    params.l_groups = dparams.get('l_groups',params.l_groups)
+
+    linsolve = dparams.get('ls_type', None)
+    if linsolve is not None:
+        set_linsolve(&params,linsolve)
     
     params.epsilon = dparams.get('epsilon',params.epsilon)
+    params.tr_length = dparams.get('tr_length',params.tr_length)
     params.force_jump= dparams.get('force_jump',params.force_jump)
+    params.jump_repeated = dparams.get('jump_repeated',params.jump_repeated)
 
     name = dparams.get('kernel_name',params.kernel.name)
     set_kernel(&params,name)
@@ -166,6 +260,12 @@ cdef bopt_params dict2structparams(dict dparams):
             params.kernel.hp_mean[i] = theta[i]
             params.kernel.hp_std[i] = stheta[i]
 
+    groups = dparams.get('kernel_groups',None)
+    if groups is not None:
+        params.kernel.n_groups = len(groups)
+        for i in range(0,params.kernel.n_groups):
+            params.kernel.groups[i] = groups[i]
+
     name = dparams.get('mean_name',params.mean.name)
     set_mean(&params,name)
     
@@ -188,19 +288,30 @@ cdef bopt_params dict2structparams(dict dparams):
 
     return params
 
+# The query is copied in a single block, because the function might
+# keep it after the call (e.g.: in a history of queries).
 cdef double callback(unsigned int n, const_double_ptr x,
-                     double *gradient, void *func_data):
+                     double *gradient, void *func_data) noexcept with gil:
     try:
-        x_np = np.zeros(n)
-
-        for i in range(0,n):
-            x_np[i] = <double>x[i]
+        x_np = np.array(<double[:n]><double*>x)
 
         result = (<object>func_data)(x_np)
         return result
     except:
         return HUGE_VAL
 
+cdef void callback_batch(unsigned int n, unsigned int nDim,
+                         const_double_ptr x, double *y,
+                         void *func_data) noexcept with gil:
+    try:
+        x_np = np.array(<double[:n,:nDim]><double*>x)
+
+        result = (<object>func_data)(x_np)
+        np.asarray(<double[:n]>y)[:] = result
+    except:
+        for i in range(0,n):
+            y[i] = HUGE_VAL
+
 def raise_problem(error_code):
     # This is a little bit hacky, but we lose track of the C++
     # exception since we use the C wrapper for interface:
@@ -232,12 +343,102 @@ def optimize(f, int nDim, np.ndarray[np.double_t] np_lb,
     ub = np.ascontiguousarray(np_ub,dtype=np.double)
     x  = np.ascontiguousarray(np_x,dtype=np.double)
 
+    cdef int error_code
+    cdef void* f_data = <void *> f
+    cdef double* plb = &lb[0]
+    cdef double* pub = &ub[0]
+    cdef double* px = &x[0]
+
+    Py_INCREF(f)
+
+    with nogil:
+        error_code = bayes_optimization(nDim, callback, f_data,
+                                        plb, pub, px, minf, params)
+
+    Py_DECREF(f)
+
+    raise_problem(error_code)
+    
+    min_value = minf[0]
+    return min_value,np_x,error_code
+
+
+def optimize_batch(f, int nDim, np.ndarray[np.double_t] np_lb,
+                   np.ndarray[np.double_t] np_ub, dict dparams):
+    # f receives an array of points (n x nDim) and returns n values
+
+    cdef bopt_params params = dict2structparams(dparams)
+    cdef double minf[1]
+    cdef np.ndarray np_x = np.ones([nDim], dtype=np.double)*0.5
+
+    cdef np.ndarray[np.double_t, ndim=1, mode="c"] lb
+    cdef np.ndarray[np.double_t, ndim=1, mode="c"] ub
+    cdef np.ndarray[np.double_t, ndim=1, mode="c"] x
+
+    lb = np.ascontiguousarray(np_lb,dtype=np.double)
+    ub = np.ascontiguousarray(np_ub,dtype=np.double)
+    x  = np.ascontiguousarray(np_x,dtype=np.double)
+
+    cdef int error_code
+    cdef void* f_data = <void *> f
+    cdef double* plb = &lb[0]
+    cdef double* pub = &ub[0]
+    cdef double* px = &x[0]
+
     Py_INCREF(f)
 
-    error_code = bayes_optimization(nDim, callback, <void *> f,
-                                    &lb[0], &ub[0], &x[0], minf, params)
+    with nogil:
+        error_code = bayes_optimization_batch(nDim, callback_batch, f_data,
+                                              plb, pub, px, minf, params)
+
+    Py_DECREF(f)
 
+    raise_problem(error_code)
     
+    min_value = minf[0]
+    return min_value,np_x,error_code
+
+
+def optimize_warm(f, int nDim, np.ndarray[np.double_t] np_lb,
+                  np.ndarray[np.double_t] np_ub,
+                  np.ndarray[np.double_t,ndim=2] np_x_init,
+                  np.ndarray[np.double_t] np_y_init, dict dparams):
+
+    cdef bopt_params params = dict2structparams(dparams)
+    cdef double minf[1]
+    cdef np.ndarray np_x = np.ones([nDim], dtype=np.double)*0.5
+
+    cdef np.ndarray[np.double_t, ndim=1, mode="c"] lb
+    cdef np.ndarray[np.double_t, ndim=1, mode="c"] ub
+    cdef np.ndarray[np.double_t, ndim=1, mode="c"] x
+    cdef np.ndarray[np.double_t, ndim=2, mode="c"] x_init
+    cdef np.ndarray[np.double_t, ndim=1, mode="c"] y_init
+
+    if np_x_init.shape[1] != nDim or np_x_init.shape[0] != np_y_init.shape[0]:
+        raise ValueError('Invalid shape of the initial observations')
+
+    lb = np.ascontiguousarray(np_lb,dtype=np.double)
+    ub = np.ascontiguousarray(np_ub,dtype=np.double)
+    x  = np.ascontiguousarray(np_x,dtype=np.double)
+    x_init = np.ascontiguousarray(np_x_init,dtype=np.double)
+    y_init = np.ascontiguousarray(np_y_init,dtype=np.double)
+
+    cdef int error_code
+    cdef void* f_data = <void *> f
+    cdef double* plb = &lb[0]
+    cdef double* pub = &ub[0]
+    cdef double* px = &x[0]
+    cdef double* px_init = &x_init[0,0]
+    cdef double* py_init = &y_init[0]
+    cdef size_t n_init = y_init.shape[0]
+
+    Py_INCREF(f)
+
+    with nogil:
+        error_code = bayes_optimization_warm(nDim, callback, f_data,
+                                             plb, pub, px_init, py_init,
+                                             n_init, px, minf, params)
+
     Py_DECREF(f)
 
     raise_problem(error_code)
@@ -251,7 +452,7 @@ def optimize_discrete(f, np.ndarray[np.double_t,ndim=2] np_valid_x,
 
     cdef bopt_params params = dict2structparams(dparams)
     
-    nDim = np_valid_x.shape[1]
+    cdef int nDim = np_valid_x.shape[1]
 
     cdef double minf[1]
     cdef np.ndarray np_x = np.zeros([nDim], dtype=np.double)
@@ -262,11 +463,18 @@ def optimize_discrete(f, np.ndarray[np.double_t,ndim=2] np_valid_x,
     x  = np.ascontiguousarray(np_x,dtype=np.double)
     valid_x = np.ascontiguousarray(np_valid_x,dtype=np.double)
 
+    cdef int error_code
+    cdef void* f_data = <void *> f
+    cdef double* pvalid_x = &valid_x[0,0]
+    cdef size_t n_points = valid_x.shape[0]
+    cdef double* px = &x[0]
+
     Py_INCREF(f)
 
-    error_code = bayes_optimization_disc(nDim, callback, <void *> f,
-                                         &valid_x[0,0], np_valid_x.shape[0],
-                                         &x[0], minf, params)
+    with nogil:
+        error_code = bayes_optimization_disc(nDim, callback, f_data,
+                                             pvalid_x, n_points,
+                                             px, minf, params)
 
     Py_DECREF(f)
 
@@ -280,7 +488,7 @@ def optimize_categorical(f, np.ndarray[np.int_t,ndim=1] np_categories,
 
     cdef bopt_params params = dict2structparams(dparams)
     
-    nDim = np_categories.shape[0]
+    cdef int nDim = np_categories.shape[0]
 
     cdef double minf[1]
     cdef np.ndarray np_x = np.zeros([nDim], dtype=np.double)
@@ -291,11 +499,17 @@ def optimize_categorical(f, np.ndarray[np.int_t,ndim=1] np_categories,
     x  = np.ascontiguousarray(np_x,dtype=np.double)
     categories = np.ascontiguousarray(np_categories,dtype=np.int)
 
+    cdef int error_code
+    cdef void* f_data = <void *> f
+    cdef int* pcategories = <int *>&categories[0]
+    cdef double* px = &x[0]
+
     Py_INCREF(f)
 
-    error_code = bayes_optimization_categorical(nDim, callback, <void *> f,
-                                                <int *>&categories[0], &x[0],
-                                                minf, params)
+    with nogil:
+        error_code = bayes_optimization_categorical(nDim, callback, f_data,
+                                                    pcategories, px,
+                                                    minf, params)
 
     Py_DECREF(f)
 
@@ -303,3 +517,137 @@ def optimize_categorical(f, np.ndarray[np.int_t,ndim=1] np_categories,
     
     min_value = minf[0]
     return min_value,np_x,error_code
+
+def last_profile():
+    # Wall time (seconds) and counters of the last optimization
+    cdef bopt_profile profile
+    error_code = bayes_optimization_last_profile(&profile)
+    raise_problem(error_code)
+    return profile
+
+
+cdef class Optimizer:
+    # Ask/tell interface of the continuous optimizer. The application
+    # evaluates the queries (e.g.: in a pool of workers). The arrays
+    # are passed to C++ without copies if they are C contiguous
+    # doubles, and the GIL is released while the model is fitted and
+    # the criterion is optimized. The methods of one Optimizer must
+    # not be called concurrently.
+    cdef bopt_optimizer* opt
+    cdef readonly int n_dim
+
+    def __cinit__(self, int nDim, np.ndarray[np.double_t] np_lb,
+                  np.ndarray[np.double_t] np_ub, dict dparams):
+        cdef bopt_params params = dict2structparams(dparams)
+
+        cdef np.ndarray[np.double_t, ndim=1, mode="c"] lb
+        cdef np.ndarray[np.double_t, ndim=1, mode="c"] ub
+
+        self.opt = NULL
+        if np_lb.shape[0] != nDim or np_ub.shape[0] != nDim:
+            raise ValueError('Invalid shape of the bounds')
+
+        lb = np.ascontiguousarray(np_lb,dtype=np.double)
+        ub = np.ascontiguousarray(np_ub,dtype=np.double)
+
+        error_code = bayes_optimizer_create(&self.opt, nDim, &lb[0], &ub[0],
+                                            params)
+        raise_problem(error_code)
+        self.n_dim = nDim
+
+    def __dealloc__(self):
+        if self.opt != NULL:
+            bayes_optimizer_free(self.opt)
+
+    def design(self, size_t n):
+        # Initial design (n x nDim), to be evaluated by the application
+        cdef np.ndarray[np.double_t, ndim=2, mode="c"] x
+        x = np.empty([n,self.n_dim], dtype=np.double)
+        if n == 0:
+            return x
+
+        cdef int error_code
+        cdef double* px = &x[0,0]
+        with nogil:
+            error_code = bayes_optimizer_design(self.opt, n, px)
+        raise_problem(error_code)
+        return x
+
+    def initialize(self, np_x_init, np_y_init):
+        # First observations (e.g.: the initial design or prior data)
+        cdef np.ndarray[np.double_t, ndim=2, mode="c"] x_init
+        cdef np.ndarray[np.double_t, ndim=1, mode="c"] y_init
+
+        x_init = np.ascontiguousarray(np_x_init,dtype=np.double)
+        y_init = np.ascontiguousarray(np_y_init,dtype=np.double)
+        if (x_init.shape[1] != self.n_dim or 
+            x_init.shape[0] != y_init.shape[0] or y_init.shape[0] == 0):
+            raise ValueError('Invalid shape of the initial observations')
+
+        cdef int error_code
+        cdef double* px_init = &x_init[0,0]
+        cdef double* py_init = &y_init[0]
+        cdef size_t n_init = y_init.shape[0]
+        with nogil:
+            error_code = bayes_optimizer_initialize(self.opt, px_init,
+                                                    py_init, n_init)
+        raise_problem(error_code)
+
+    def ask(self):
+        # Next query to evaluate
+        cdef np.ndarray[np.double_t, ndim=1, mode="c"] x
+        x = np.empty([self.n_dim], dtype=np.double)
+
+        cdef int error_code
+        cdef double* px = &x[0]
+        with nogil:
+            error_code = bayes_optimizer_ask(self.opt, px)
+        raise_problem(error_code)
+        return x
+
+    def tell(self, np_x, double y):
+        # Observation of a query, usually the last one asked
+        cdef np.ndarray[np.double_t, ndim=1, mode="c"] x
+        x = np.ascontiguousarray(np_x,dtype=np.double)
+        if x.shape[0] != self.n_dim:
+            raise ValueError('Invalid shape of the query')
+
+        cdef int error_code
+        cdef double* px = &x[0]
+        with nogil:
+            error_code = bayes_optimizer_tell(self.opt, px, y)
+        raise_problem(error_code)
+
+    def predict(self, np_x):
+        # Mean and standard deviation of the surrogate at each row of x
+        cdef np.ndarray[np.double_t, ndim=2, mode="c"] x
+        cdef np.ndarray[np.double_t, ndim=1, mode="c"] mean
+        cdef np.ndarray[np.double_t, ndim=1, mode="c"] std
+
+        x = np.ascontiguousarray(np.atleast_2d(np_x),dtype=np.double)
+        if x.shape[1] != self.n_dim:
+            raise ValueError('Invalid shape of the points')
+        mean = np.empty([x.shape[0]], dtype=np.double)
+        std = np.empty([x.shape[0]], dtype=np.double)
+        if x.shape[0] == 0:
+            return mean,std
+
+        cdef int error_code
+        cdef size_t n = x.shape[0]
+        cdef double* px = &x[0,0]
+        cdef double* pmean = &mean[0]
+        cdef double* pstd = &std[0]
+        with nogil:
+            error_code = bayes_optimizer_predict(self.opt, n, px, pmean, pstd)
+        raise_problem(error_code)
+        return mean,std
+
+    def best(self):
+        # Best observation so far (value and point)
+        cdef double minf[1]
+        cdef np.ndarray[np.double_t, ndim=1, mode="c"] x
+        x = np.empty([self.n_dim], dtype=np.double)
+
+        error_code = bayes_optimizer_best(self.opt, &x[0], minf)
+        raise_problem(error_code)
+        return minf[0],x
@@ -89,6 +89,17 @@ class BayesOptContinuous(object):
         
         return min_val, x_out, error
 
+    ## Same as optimize, but using previous observations instead of
+    # the initial design.
+    def optimize_warm(self, x_init, y_init):
+        min_val, x_out, error = bo.optimize_warm(self.evaluateSample,
+                                                 self.n_dim,
+                                                 self.lb, self.ub,
+                                                 x_init, y_init,
+                                                 self.params)
+        
+        return min_val, x_out, error
+
 
 ## Python Module for BayesOptDiscrete
 #
@@ -0,0 +1,68 @@
+#!/usr/bin/env python
+# -------------------------------------------------------------------------
+#    This file is part of BayesOpt, an efficient C++ library for 
+#    Bayesian optimization.
+#
+#    Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+# 
+#    BayesOpt is free software: you can redistribute it and/or modify it 
+#    under the terms of the GNU General Public License as published by
+#    the Free Software Foundation, either version 3 of the License, or
+#    (at your option) any later version.
+#
+#    BayesOpt is distributed in the hope that it will be useful, but 
+#    WITHOUT ANY WARRANTY; without even the implied warranty of
+#    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#    GNU General Public License for more details.
+#
+#    You should have received a copy of the GNU General Public License
+#    along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+# ------------------------------------------------------------------------
+
+# Ask/tell interface: the application evaluates the queries, here in a
+# pool of processes. The optimizer releases the GIL, so the main thread
+# could also attend other tasks while it computes the next query.
+
+import numpy as np
+import bayesopt
+from multiprocessing import Pool
+
+# Function for testing.
+def testfunc(Xin):
+    total = 5.0
+    for value in Xin:
+        total = total + (value -0.33)*(value-0.33)
+    return total
+
+
+if __name__ == '__main__':
+    params = {
+        'n_iterations' : 50,
+        'n_init_samples' : 20,
+        'verbose_level' : 0
+    } 
+
+    n = 5                     # n dimensions
+    lb = np.zeros((n,))
+    ub = np.ones((n,))
+
+    pool = Pool(4)
+    opt = bayesopt.Optimizer(n, lb, ub, params)
+
+    # The initial design is evaluated in parallel
+    x_init = opt.design(params['n_init_samples'])
+    y_init = np.array(pool.map(testfunc, x_init))
+    opt.initialize(x_init, y_init)
+
+    for i in range(params['n_iterations']):
+        query = opt.ask()
+        opt.tell(query, pool.apply(testfunc, (query,)))
+
+    pool.close()
+    pool.join()
+
+    mvalue, x_out = opt.best()
+    print("Result %f at %s" % (mvalue, x_out))
+
+    mean, std = opt.predict(x_out)
+    print("Prediction %f +- %f" % (mean[0], std[0]))
@@ -22,41 +22,100 @@
 
 #include "bayesoptbase.hpp"
 
+#include <cmath>
+#include <stdexcept>
 #include "log.hpp"
+#include "datafile.hpp"
 #include "posteriormodel.hpp"
+#include "threadpool.hpp"
 
 
 namespace bayesopt
 {
+  /** Evaluation of one point (a row) of a batch. */
+  class BayesOptBase::EvaluationTask: public utils::ParallelTask
+  {
+  public:
+    EvaluationTask(BayesOptBase& opt, const matrixd& xPoints, 
+		   vectord& yPoints):
+      mOpt(opt), mPoints(xPoints), mValues(yPoints) {};
+
+    void operator()(size_t index)
+    { mValues(index) = mOpt.evaluateSampleInternal(row(mPoints,index)); };
+
+  private:
+    BayesOptBase& mOpt;
+    const matrixd& mPoints;
+    vectord& mValues;
+  };
+
+  /** Learning of the surrogate model in the background worker (see
+      pipelined_relearn). */
+  class BayesOptBase::LearningTask: public utils::ParallelTask
+  {
+  public:
+    explicit LearningTask(BayesOptBase& opt): mOpt(opt) {};
+
+    void operator()(size_t /*index*/)
+    {
+      LogScope logging(mOpt.mLogSettings);
+      utils::ExecutorScope parallel(mOpt.mExecutor);
+      mProfiler.reset();
+      utils::ProfilerActivation profiling(mProfiler);
+      mOpt.learnAndFit(mProfiler);
+    };
 
+    utils::Profiler mProfiler;                   ///< Work of the last run
+
+  private:
+    BayesOptBase& mOpt;
+  };
 
   BayesOptBase::BayesOptBase(size_t dim, bopt_params parameters):
-    mParameters(parameters), mDims(dim)
+    mParameters(parameters), mDims(dim), mLogFile(NULL), mExecutor(NULL),
+    mPipelinedFit(false)
   {
-    // Random seed
-    if (mParameters.random_seed < 0) mParameters.random_seed = std::time(0); 
-    mEngine.seed(mParameters.random_seed);
-
-    // Posterior surrogate model
-    mModel.reset(PosteriorModel::create(dim,parameters,mEngine));
-    
-    // Setting verbose stuff (files, levels, etc.)
+    // Setting verbose stuff (files, levels, etc.). They belong to
+    // this optimizer, so several optimizers can run in one process.
     int verbose = mParameters.verbose_level;
+    mLogSettings.stream = Output2FILE::Stream();
     if (verbose>=3)
       {
-	FILE* log_fd = fopen( mParameters.log_filename , "w" );
-	Output2FILE::Stream() = log_fd; 
+	mLogFile = fopen( mParameters.log_filename , "w" );
+	mLogSettings.stream = mLogFile; 
 	verbose -= 3;
       }
 
     switch(verbose)
       {
-      case 0: FILELog::ReportingLevel() = logWARNING; break;
-      case 1: FILELog::ReportingLevel() = logINFO; break;
-      case 2: FILELog::ReportingLevel() = logDEBUG4; break;
+      case 0: mLogSettings.level = logWARNING; break;
+      case 1: mLogSettings.level = logINFO; break;
+      case 2: mLogSettings.level = logDEBUG4; break;
       default:
-	FILELog::ReportingLevel() = logERROR; break;
+	mLogSettings.level = logERROR; break;
+      }
+    LogScope logging(mLogSettings);
+
+    // Random seed
+    if (mParameters.random_seed < 0) mParameters.random_seed = std::time(0); 
+    mEngine = randEngine(mParameters.random_seed, STREAM_OPTIMIZER);
+
+    // Posterior surrogate model (with its own streams)
+    mModel.reset(PosteriorModel::create(dim,parameters,mEngine));
+
+    if (isTracing())  utils::Tracer::start();
+
+    if (mParameters.num_threads != 1)
+      {
+	mThreadPool.reset(new utils::ThreadPool(mParameters.num_threads));
+	mExecutor = mThreadPool.get();
       }
+    if (mParameters.n_eval_threads != 1)
+      {
+	mEvalPool.reset(new utils::ThreadPool(mParameters.n_eval_threads));
+      }
+    mLearningTask.reset(new LearningTask(*this));
+    mLearning.reset(new utils::AsyncTask());
 
     // Configure iteration parameters
     if (mParameters.n_init_samples <= 0)
@@ -67,51 +126,253 @@ namespace bayesopt
   }
 
   BayesOptBase::~BayesOptBase()
-  { } // Default destructor
+  {
+    try
+      {
+	mLearning->wait();      // The background learning uses the model
+      }
+    catch (std::runtime_error& e)
+      {
+	LogScope logging(mLogSettings);
+	FILE_LOG(logERROR) << e.what();
+      }
+
+    if (isTracing())
+      {
+	LogScope logging(mLogSettings);
+	utils::Tracer::stop();
+	try 
+	  { 
+	    utils::Tracer::write(mParameters.trace_filename); 
+	  }
+	catch (std::runtime_error& e)
+	  {
+	    FILE_LOG(logERROR) << e.what();
+	  }
+      }
+
+    if (mLogFile != NULL)
+      {
+	Output2FILE::Flush();   // The writer might still have messages
+	fclose(mLogFile);
+      }
+  } // Default destructor
+
+  void BayesOptBase::evaluateSamplesInternal(const matrixd& xPoints, 
+					     vectord& yPoints)
+  {
+    vecOfvec queries(xPoints.size1());
+    for (size_t i = 0; i < queries.size(); ++i)
+      {
+	queries[i] = unnormalizeInput(row(xPoints,i));
+      }
+
+    if (!evaluateSamples(queries,yPoints))
+      {
+	yPoints.resize(queries.size(),false);
+	EvaluationTask task(*this,xPoints,yPoints);
+	if (mEvalPool)  mEvalPool->run(queries.size(),task);
+	else for (size_t i = 0; i < queries.size(); ++i)  task(i);
+	return;
+      }
+
+    if (yPoints.size() != queries.size())
+      {
+	throw std::runtime_error("Wrong number of values in the batch "
+				 "of evaluations.");
+      }
+    for (size_t i = 0; i < yPoints.size(); ++i)
+      {
+	if (yPoints(i) == HUGE_VAL)
+	  {
+	    throw std::runtime_error("Function evaluation out of range");
+	  }
+      }
+  }
+
+  void BayesOptBase::setExecutor(utils::Executor* executor)
+  { mExecutor = (executor != NULL) ? executor : mThreadPool.get(); }
+
+  bool BayesOptBase::isTracing()
+  { return mParameters.trace_filename[0] != '\0'; }
 
 
   void BayesOptBase::stepOptimization()
   {
+    mProfiler.startIteration();
+    LogScope logging(mLogSettings);
+    utils::ExecutorScope parallel(mExecutor);
+    utils::ProfilerActivation profiling(mProfiler);
+    utils::TraceSpan span("iteration");
+    waitForLearning();       // Previous iteration or a repeated ask
+
     // Find what is the next point.
-    vectord xNext = nextPoint(); 
-    double yNext = evaluateSampleInternal(xNext);
+    utils::JournalSource source;
+    vectord xNext;
+    {
+      utils::ProfileTimer timer(mProfiler,utils::PHASE_CRITERIA);
+      xNext = proposeNext(source); 
+    }
+    startPipelinedLearning();
+
+    double yNext;
+    {
+      utils::ProfileTimer timer(mProfiler,utils::PHASE_EVALUATION);
+      yNext = evaluateSampleInternal(xNext);
+    }
 
     // If we are stuck in the same point for several iterations, try a random jump!
-    if (mParameters.force_jump)
+    if (updateStuck(yNext))
+      {
+	FILE_LOG(logINFO) << "Forced random query!";
+	xNext = samplePoint();
+	source = utils::JOURNAL_RANDOM;
+	utils::ProfileTimer timer(mProfiler,utils::PHASE_EVALUATION);
+	yNext = evaluateSampleInternal(xNext);
+	mCounterStuck = 0;
+      }
+
+    addObservation(xNext,yNext,source);
+  }
+
+  vectord BayesOptBase::ask()
+  {
+    mProfiler.startIteration();
+    LogScope logging(mLogSettings);
+    utils::ExecutorScope parallel(mExecutor);
+    utils::ProfilerActivation profiling(mProfiler);
+    utils::TraceSpan span("ask");
+
+    if (mModel->getData()->getNSamples() == 0)
       {
-	if (std::pow(mYPrev - yNext,2) < mParameters.noise)
+	throw std::runtime_error("The optimization must be initialized "
+				 "before asking for queries.");
+      }
+    waitForLearning();       // Repeated ask
+    if (mParameters.force_jump && (mCounterStuck > mParameters.force_jump))
+      {
+	FILE_LOG(logINFO) << "Forced random query!";
+	mAskedQuery = samplePoint();
+	mAskedSource = utils::JOURNAL_RANDOM;
+	mCounterStuck = 0;
+      }
+    else
+      {
+	utils::ProfileTimer timer(mProfiler,utils::PHASE_CRITERIA);
+	mAskedQuery = proposeNext(mAskedSource); 
+      }
+    mAskedInput = unnormalizeInput(mAskedQuery);
+    startPipelinedLearning();
+    return mAskedInput;
+  }
+
+  void BayesOptBase::tell(const vectord& query, double value)
+  {
+    LogScope logging(mLogSettings);
+    utils::ExecutorScope parallel(mExecutor);
+    utils::ProfilerActivation profiling(mProfiler);
+    utils::TraceSpan span("tell");
+
+    if (mModel->getData()->getNSamples() == 0)
+      {
+	throw std::runtime_error("The optimization must be initialized "
+				 "before telling observations.");
+      }
+    if (value == HUGE_VAL)
+      {
+	throw std::runtime_error("Function evaluation out of range");
+      }
+
+    // The last query is reused, because some models (Rembo) cannot
+    // map the input space back.
+    vectord xNext;
+    utils::JournalSource source = utils::JOURNAL_INIT;
+    if ((query.size() == mAskedInput.size()) && 
+	std::equal(query.begin(),query.end(),mAskedInput.begin()))
+      {
+	xNext = mAskedQuery;
+	source = mAskedSource;
+      }
+    else
+      {
+	xNext = normalizeInput(query);
+      }
+    mAskedInput.resize(0);
+
+    updateStuck(value);
+    addObservation(xNext,value,source);
+  }
+
+  vectord BayesOptBase::proposeNext(utils::JournalSource& source)
+  {
+    vectord xNext = nextPoint(source); 
+
+    // A repeated query does not add information and makes the kernel
+    // matrix ill-conditioned, so we try a random jump instead.
+    if (mParameters.jump_repeated)
+      {
+	double dist;
+	mModel->getData()->getNearestSample(xNext,dist);
+	if (dist <= repeatedDistance())
 	  {
-	    mCounterStuck++;
-	    FILE_LOG(logDEBUG) << "Stuck for "<< mCounterStuck << " steps";
+	    FILE_LOG(logINFO) << "Repeated query. Forced random query!";
+	    xNext = samplePoint();
+	    source = utils::JOURNAL_RANDOM;
 	  }
-	else
+      }
+    return xNext;
+  }
+
+  bool BayesOptBase::updateStuck(double yNext)
+  {
+    if (!mParameters.force_jump)  return false;
+
+    if (std::pow(mYPrev - yNext,2) < mParameters.noise)
+      {
+	mCounterStuck++;
+	FILE_LOG(logDEBUG) << "Stuck for "<< mCounterStuck << " steps";
+      }
+    else
+      {
+	mCounterStuck = 0;
+      }
+    mYPrev = yNext;
+    return mCounterStuck > mParameters.force_jump;
+  }
+
+  void BayesOptBase::addObservation(const vectord& xNext, double yNext,
+				    utils::JournalSource source)
+  {
+    // If the hyperparameters were learned during the evaluation, the
+    // new sample is just an incremental update.
+    const bool learned = mPipelinedFit;
+    mPipelinedFit = false;
+    waitForLearning();
+
+    mModel->addSample(xNext,yNext);   // Might evict a sample
+
+    if (mJournal.isOpen())
+      {
+	try
 	  {
-	    mCounterStuck = 0;
+	    mJournal.append(mCurrentIter,source,unnormalizeInput(xNext),
+			    xNext,yNext);
+	    mJournal.flush();
 	  }
-	mYPrev = yNext;
-
-	if (mCounterStuck > mParameters.force_jump)
+	catch (std::runtime_error& e)
 	  {
-	    FILE_LOG(logINFO) << "Forced random query!";
-	    xNext = samplePoint();
-	    yNext = evaluateSampleInternal(xNext);
-	    mCounterStuck = 0;
+	    FILE_LOG(logERROR) << "Journal disabled. " << e.what();
 	  }
       }
 
-    mModel->addSample(xNext,yNext);
-
     // Update surrogate model
-    bool retrain = ((mParameters.n_iter_relearn > 0) && 
-		    ((mCurrentIter + 1) % mParameters.n_iter_relearn == 0));
-
-    if (retrain)  // Full update
+    if (isRelearnIteration() && !learned)  // Full update
       {
-	mModel->updateHyperParameters();
-	mModel->fitSurrogateModel();
+	learnAndFit(mProfiler);
       }
     else          // Incremental update
       {
+	utils::ProfileTimer timer(mProfiler,utils::PHASE_UPDATE);
 	mModel->updateSurrogateModel();
       } 
     plotStepData(mCurrentIter,xNext,yNext);
@@ -121,43 +382,248 @@ namespace bayesopt
 
   void BayesOptBase::initializeOptimization()
   {
+    LogScope logging(mLogSettings);
+    utils::ExecutorScope parallel(mExecutor);
+    waitForLearning();
+    mPipelinedFit = false;
+    mProfiler.reset();
+    utils::ProfilerActivation profiling(mProfiler);
+    utils::TraceSpan span("initialization");
+
+    if ((mParameters.journal_mode == 2) && replayJournal())  return;
+
+    if (mParameters.load_save_flag & 1)
+      {
+	utils::ObservationFile data(mParameters.load_filename);
+	if (data.getNDims() != mDims)
+	  {
+	    throw std::invalid_argument("Data file dimension does not "
+					"match the problem dimension.");
+	  }
+	FILE_LOG(logINFO) << "Loading " << data.getNSamples() 
+			  << " samples from " << mParameters.load_filename;
+	initializeOptimization(data.getInputs(),data.getOutputs(),
+			       data.getNSamples());
+	return;
+      }
+
     size_t nSamples = mParameters.n_init_samples;
 
     matrixd xPoints(nSamples,mDims);
     vectord yPoints(nSamples);
 
-    sampleInitialPoints(xPoints,yPoints);
+    {
+      utils::ProfileTimer timer(mProfiler,utils::PHASE_EVALUATION);
+      sampleInitialDesign(xPoints);
+      evaluateSamplesInternal(xPoints,yPoints);
+    }
     mModel->setSamples(xPoints,yPoints);
- 
+    startJournal();
+    fitInitialModel();
+  }
+
+  void BayesOptBase::initializeOptimization(const double *x, const double *y,
+					    size_t n)
+  {
+    if (n == 0)
+      {
+	throw std::invalid_argument("Empty set of initial observations.");
+      }
+    LogScope logging(mLogSettings);
+    utils::ExecutorScope parallel(mExecutor);
+    waitForLearning();
+    mPipelinedFit = false;
+    mProfiler.reset();
+    utils::ProfilerActivation profiling(mProfiler);
+    utils::TraceSpan span("initialization");
+
+    vecOfvec xPoints(n);
+    vectord yPoints(n);
+    vectord xi(mDims);
+
+    for (size_t i = 0; i < n; ++i)
+      {
+	std::copy(x+i*mDims, x+(i+1)*mDims, xi.begin());
+	xPoints[i] = normalizeInput(xi);
+      }
+    std::copy(y, y+n, yPoints.begin());
+
+    mModel->setSamples(xPoints,yPoints);
+    startJournal();
+    fitInitialModel();
+  }
+
+  void BayesOptBase::fitInitialModel()
+  {
     if(mParameters.verbose_level > 0)
       {
 	mModel->plotDataset(logDEBUG);
       }
     
-    mModel->updateHyperParameters();
-    mModel->fitSurrogateModel();
+    learnAndFit(mProfiler);
     mCurrentIter = 0;
 
-	mCounterStuck = 0;
-	mYPrev = 0.0;
+    mCounterStuck = 0;
+    mYPrev = 0.0;
+  }
+
+  bool BayesOptBase::replayJournal()
+  {
+    vecOfvec xPoints;
+    vectord yPoints;
+    size_t nIterations;
+
+    const utils::JournalDomain domain = getJournalDomain();
+
+    if (!utils::ObservationJournal::read(mParameters.journal_filename,domain,
+					 xPoints,yPoints,nIterations) ||
+	xPoints.empty())
+      {
+	return false;
+      }
+    FILE_LOG(logINFO) << "Replaying " << xPoints.size() << " samples from " 
+		      << mParameters.journal_filename;
+
+    mModel->setSamples(xPoints,yPoints);
+    fitInitialModel();
+    mCurrentIter = nIterations;
+    try
+      {
+	mJournal.open(mParameters.journal_filename,domain,true);
+      }
+    catch (std::runtime_error& e)
+      {
+	FILE_LOG(logERROR) << "Journal disabled. " << e.what();
+      }
+    return true;
   }
 
+  void BayesOptBase::startJournal()
+  {
+    if (mParameters.journal_mode == 0)  return;
+
+    // The journal is not essential for the optimization, thus an
+    // unwritable file is reported, but it does not stop the run.
+    const Dataset* data = mModel->getData();
+    try
+      {
+	mJournal.open(mParameters.journal_filename,getJournalDomain(),false);
+	for (size_t i = 0; i < data->getNSamples(); ++i)
+	  {
+	    mJournal.append(0,utils::JOURNAL_INIT,
+			    unnormalizeInput(data->mX[i]),
+			    data->mX[i],data->mY(i));
+	  }
+	mJournal.flush();
+      }
+    catch (std::runtime_error& e)
+      {
+	FILE_LOG(logERROR) << "Journal disabled. " << e.what();
+      }
+  }
+
+  utils::JournalDomain BayesOptBase::getJournalDomain()
+  {
+    utils::JournalDomain domain;
+    domain.nInputDims = mDims;
+    domain.nDims = mDims;
+    return domain;
+  }
+
+  void BayesOptBase::learnAndFit(utils::Profiler& profiler)
+  {
+    {
+      utils::ProfileTimer timer(profiler,utils::PHASE_LEARNING);
+      mModel->updateHyperParameters();
+    }
+    utils::ProfileTimer timer(profiler,utils::PHASE_FIT);
+    mModel->fitSurrogateModel();
+  }
+
+  bool BayesOptBase::isRelearnIteration()
+  {
+    return ((mParameters.n_iter_relearn > 0) && 
+	    ((mCurrentIter + 1) % mParameters.n_iter_relearn == 0));
+  }
+
+  void BayesOptBase::startPipelinedLearning()
+  {
+    if (!mParameters.pipelined_relearn || !isRelearnIteration())  return;
+
+    // The new sample is not available yet, so the model is learned
+    // with the previous ones.
+    mPipelinedFit = true;
+    mLearning->start(*mLearningTask);
+  }
+
+  void BayesOptBase::waitForLearning()
+  {
+    if (!mLearning->isStarted())  return;
+
+    mLearning->wait();
+    mProfiler.merge(mLearningTask->mProfiler);
+  }
+
+  void BayesOptBase::getInitialDesign(matrixd& xPoints)
+  {
+    LogScope logging(mLogSettings);
+    if (xPoints.size2() != mDims)
+      {
+	throw std::invalid_argument("Wrong dimension of the initial design.");
+      }
+    matrixd design(xPoints.size1(),mDims);
+    sampleInitialDesign(design);
+    for (size_t i = 0; i < design.size1(); ++i)
+      {
+	row(xPoints,i) = unnormalizeInput(row(design,i));
+      }
+  }
+
+  void BayesOptBase::predict(const vectord& query, double& mean, double& std)
+  {
+    LogScope logging(mLogSettings);
+    waitForLearning();
+    ProbabilityDistribution* pd = mModel->getPrediction(normalizeInput(query));
+    mean = pd->getMean();
+    std = pd->getStd();
+  }
+
+  void BayesOptBase::saveObservations(const std::string& filename)
+  {
+    LogScope logging(mLogSettings);
+    const Dataset* data = mModel->getData();
+    vecOfvec xPoints(data->mX.size());
+
+    for (size_t i = 0; i < xPoints.size(); ++i)
+      {
+	xPoints[i] = unnormalizeInput(data->mX[i]);
+      }
+    utils::ObservationFile::save(filename,xPoints,data->mY);
+  }
 
   void BayesOptBase::optimize(vectord &bestPoint)
   {
+    LogScope logging(mLogSettings);
     initializeOptimization();
-    assert(mDims == bestPoint.size());
     
-    for (size_t ii = 0; ii < mParameters.n_iterations; ++ii)
+    // After replaying a journal, some iterations are already done.
+    for (size_t ii = mCurrentIter; ii < mParameters.n_iterations; ++ii)
       {      
 	stepOptimization();
       }
    
     bestPoint = getFinalResult();
+
+    if (mParameters.load_save_flag & 2)
+      {
+	saveObservations(mParameters.save_filename);
+      }
+    Output2FILE::Flush();
   } // optimize
 
-  vectord BayesOptBase::nextPoint()
+  vectord BayesOptBase::nextPoint(utils::JournalSource& source)
   {
+    source = utils::JOURNAL_RANDOM;
 
     //Epsilon-Greedy exploration (see Bull 2011)
     if ((mParameters.epsilon > 0.0) && (mParameters.epsilon < 1.0))
@@ -172,6 +638,8 @@ namespace bayesopt
 	  }
       }
 
+    source = utils::JOURNAL_CRITERIA;
+
     //TODO: Try to solve this without bringing the pointer to the
     //criteria. Right now it does not work with MCMC.
     vectord Xnext(mDims);    
@@ -203,6 +671,7 @@ namespace bayesopt
   // structure.
   double BayesOptBase::evaluateCriteria(const vectord& query)
   {
+    mProfiler.addCount(utils::COUNT_CRITERIA,1);
     if (checkReachability(query)) return mModel->evaluateCriteria(query);
     else return 0.0;
   }
@@ -213,8 +682,14 @@ namespace bayesopt
   double BayesOptBase::getValueAtMinimum()
   { return mModel->getValueAtMinimum(); };
 
+  bool BayesOptBase::getInputGroups(vecOfGroups& groups)
+  { return mModel->getInputGroups(groups); };
+
   ProbabilityDistribution* BayesOptBase::getPrediction(const vectord& query)
-  { return mModel->getPrediction(query); };
+  { 
+    waitForLearning();
+    return mModel->getPrediction(query); 
+  };
 
    const Dataset* BayesOptBase::getData()
   { return mModel->getData(); };
@@ -222,6 +697,9 @@ namespace bayesopt
   bopt_params* BayesOptBase::getParameters() 
   {return &mParameters;};
 
+  const utils::Profiler& BayesOptBase::getProfiler() const
+  { return mProfiler; };
+
 
 } //namespace bayesopt
 
@@ -35,6 +35,12 @@
 
 namespace bayesopt  {
 
+  // Trust region settings (see Eriksson et al. 2019)
+  const double TR_MIN_LENGTH = 0.0078125;   // 2^-7
+  const double TR_MAX_LENGTH = 1.6;
+  const size_t TR_SUCCESS_TOLERANCE = 3;
+  const size_t TR_MIN_FAILURE_TOLERANCE = 4;
+
   class CritCallback: public RBOptimizable
   {
   public:
@@ -46,9 +52,29 @@ namespace bayesopt  {
   private:
     ContinuousModel* mBO;
   };
+
+  /** Criterion restricted to a group of dimensions. The remaining
+      dimensions are fixed to those of the anchor point. */
+  class GroupCritCallback: public RBOptimizable
+  {
+  public:
+    GroupCritCallback(ContinuousModel* model, const vectord& anchor,
+		      const std::vector<size_t>& group):
+      mBO(model), mX(anchor), mGroup(group) {};
+    double evaluate(const vectord &query) 
+    {
+      for(size_t i=0; i<mGroup.size(); ++i)  mX(mGroup[i]) = query(i);
+      return mBO->evaluateCriteria(mX);
+    }
+  private:
+    ContinuousModel* mBO;
+    vectord mX;
+    const std::vector<size_t>& mGroup;
+  };
   
   ContinuousModel::ContinuousModel(size_t dim, bopt_params parameters):
-    BayesOptBase(dim,parameters)
+    BayesOptBase(dim,parameters), mTrLength(parameters.tr_length),
+    mTrBest(HUGE_VAL), mTrIter(0), mTrSuccess(0), mTrFailure(0)
   { 
     mCallback.reset(new CritCallback(this));
     cOptimizer.reset(new NLOPT_Optimization(mCallback.get(),dim));
@@ -82,10 +108,40 @@ namespace bayesopt  {
     return yNext;
   }; 
 
+  vectord ContinuousModel::normalizeInput(const vectord& x)
+  { return mBB->normalizeVector(x); };
+
+  vectord ContinuousModel::unnormalizeInput(const vectord& x)
+  { return mBB->unnormalizeVector(x); };
+
+  utils::JournalDomain ContinuousModel::getJournalDomain()
+  {
+    utils::JournalDomain domain;
+    domain.nInputDims = mDims;
+    domain.nDims = mDims;
+    domain.lower = mBB->unnormalizeVector(zvectord(mDims));
+    domain.upper = mBB->unnormalizeVector(svectord(mDims,1.0));
+    return domain;
+  }
+
 
   void ContinuousModel::findOptimal(vectord &xOpt)
   { 
-    double minf = cOptimizer->run(xOpt);
+    vecOfGroups groups;
+    double minf;
+    if (mParameters.tr_length > 0.0)  
+      {
+	updateTrustRegion();
+	minf = cOptimizer->run(xOpt);
+      }
+    else if (getInputGroups(groups) && (groups.size() > 1))
+      {
+	minf = findOptimalByGroups(groups,xOpt);
+      }
+    else
+      {
+	minf = cOptimizer->run(xOpt);
+      }
 
     //Let's try some local exploration like spearmint
     randNFloat drawSample(mEngine,normalDist(0,0.001));
@@ -113,6 +169,103 @@ namespace bayesopt  {
       }
   };
 
+  double ContinuousModel::findOptimalByGroups(const vecOfGroups& groups,
+					     vectord &xOpt)
+  {
+    const vectord anchor = getPointAtMinimum();
+    xOpt = anchor;
+
+    // The groups only share the anchor, so they are independent
+    // low dimensional problems.
+    double minSingle = HUGE_VAL;
+    vectord xSingle = anchor;
+    for(size_t g=0; g<groups.size(); ++g)
+      {
+	const std::vector<size_t>& group = groups[g];
+	GroupCritCallback callback(this,anchor,group);
+	NLOPT_Optimization optimizer(&callback,group.size());
+	optimizer.setAlgorithm(COMBINED);
+	optimizer.setMaxEvals(mParameters.n_inner_iterations);
+
+	vectord xg(group.size());
+	for(size_t i=0; i<group.size(); ++i)  xg(i) = anchor(group[i]);
+	const double minf = optimizer.run(xg);
+
+	for(size_t i=0; i<group.size(); ++i)  xOpt(group[i]) = xg(i);
+	if (minf < minSingle)
+	  {
+	    minSingle = minf;
+	    xSingle = anchor;
+	    for(size_t i=0; i<group.size(); ++i)  xSingle(group[i]) = xg(i);
+	  }
+      }
+
+    // Without exact additivity of the criterion, the combination
+    // might be worse than a single group move.
+    const double minJoint = evaluateCriteria(xOpt);
+    if (minSingle < minJoint)
+      {
+	xOpt = xSingle;
+	return minSingle;
+      }
+    return minJoint;
+  }
+
+  void ContinuousModel::updateTrustRegion()
+  {
+    const double best = getValueAtMinimum();
+    if (mCurrentIter == 0)   // New optimization
+      {
+	mTrLength = mParameters.tr_length;
+	mTrSuccess = 0;  mTrFailure = 0;
+	mTrBest = best;  mTrIter = 0;
+      }
+    else if (mCurrentIter != mTrIter)
+      {
+	// With several criteria (eg: GP-Hedge) this is called once per
+	// criterion, but only the first call of the iteration sees the
+	// last sample.
+	if (best < mTrBest - 1e-3 * std::fabs(mTrBest))
+	  {
+	    ++mTrSuccess;  mTrFailure = 0;
+	  }
+	else
+	  {
+	    ++mTrFailure;  mTrSuccess = 0;
+	  }
+	mTrBest = best;  mTrIter = mCurrentIter;
+
+	const size_t failureTolerance = std::max(TR_MIN_FAILURE_TOLERANCE,mDims);
+	if (mTrSuccess >= TR_SUCCESS_TOLERANCE)
+	  {
+	    mTrLength = std::min(2.0*mTrLength,TR_MAX_LENGTH);
+	    mTrSuccess = 0;
+	  }
+	else if (mTrFailure >= failureTolerance)
+	  {
+	    mTrLength /= 2.0;
+	    mTrFailure = 0;
+	  }
+
+	if (mTrLength < TR_MIN_LENGTH)
+	  {
+	    FILE_LOG(logINFO) << "Trust region collapsed. Restarting.";
+	    mTrLength = mParameters.tr_length;
+	  }
+      }
+
+    const vectord center = getPointAtMinimum();
+    vectord lower(mDims), upper(mDims);
+    for (size_t i = 0; i < mDims; ++i)
+      {
+	lower(i) = std::max(center(i) - mTrLength/2.0, 0.0);
+	upper(i) = std::min(center(i) + mTrLength/2.0, 1.0);
+      }
+    cOptimizer->setLimits(lower,upper);
+    FILE_LOG(logDEBUG) << "Trust region side: " << mTrLength;
+  }
+
+
   vectord ContinuousModel::samplePoint()
   {	    
     randFloat drawSample(mEngine,realUniformDist(0,1));
@@ -128,6 +281,7 @@ namespace bayesopt  {
   void ContinuousModel::setBoundingBox(const vectord &lowerBound,
 				       const vectord &upperBound)
   {
+    LogScope logging(mLogSettings);
     // We don't change the bounds of the inner optimization because,
     // thanks to this bounding box model, everything is mapped to the
     // unit hypercube, thus the default inner optimization are just
@@ -157,14 +311,8 @@ namespace bayesopt  {
       }
   } //plotStepData
 
-  void ContinuousModel::sampleInitialPoints(matrixd& xPoints, vectord& yPoints)
+  void ContinuousModel::sampleInitialDesign(matrixd& xPoints)
   {   
     utils::samplePoints(xPoints,mParameters.init_method,mEngine);
-
-    for(size_t i = 0; i < yPoints.size(); i++)
-      {
-	const vectord sample = row(xPoints,i);
-	yPoints(i) = evaluateSampleInternal(sample);
-      }
   }
 }  //namespace bayesopt
@@ -21,6 +21,7 @@
 ------------------------------------------------------------------------
 */
 
+#include <algorithm>
 #include "bayesopt.hpp"
 
 #include <boost/numeric/ublas/matrix_proxy.hpp>
@@ -62,6 +63,22 @@ namespace bayesopt
     return getPointAtMinimum();
   }
 
+  double DiscreteModel::repeatedDistance()
+  {
+    double side = 0.0;
+    for (size_t j = 0; j < mDims; ++j)
+      {
+	double lower = mInputSet[0](j), upper = mInputSet[0](j);
+	for (size_t i = 1; i < mInputSet.size(); ++i)
+	  {
+	    lower = std::min(lower,mInputSet[i](j));
+	    upper = std::max(upper,mInputSet[i](j));
+	  }
+	side = std::max(side,upper-lower);
+      }
+    return 1e-6 * side;
+  }
+
   vectord DiscreteModel::samplePoint()
   {   
     randInt sample(mEngine, intUniformDist(0,mInputSet.size()-1));
@@ -96,7 +113,7 @@ namespace bayesopt
   }
 
 
-  void DiscreteModel::sampleInitialPoints(matrixd& xPoints, vectord& yPoints)
+  void DiscreteModel::sampleInitialDesign(matrixd& xPoints)
   {
 
     vecOfvec perms = mInputSet;
@@ -105,12 +122,9 @@ namespace bayesopt
     // the same point is not selected twice
     utils::randomPerms(perms,mEngine);
     
-    // vectord xPoint(mInputSet[0].size());
-    for(size_t i = 0; i < yPoints.size(); i++)
+    for(size_t i = 0; i < xPoints.size1(); i++)
       {
-	const vectord xP = perms[i];
-	row(xPoints,i) = xP;
-	yPoints(i) = evaluateSample(xP);
+	row(xPoints,i) = perms[i];
       }
   }
   
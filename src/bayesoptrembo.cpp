@@ -0,0 +1,169 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include "bayesopt.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+#include "randgen.hpp"
+#include "log.hpp"
+#include "boundingbox.hpp"
+
+
+namespace bayesopt  {
+
+  RemboModel::RemboModel(size_t dim, size_t embeddedDim, 
+			 bopt_params parameters):
+    ContinuousModel(embeddedDim,parameters), mInputDims(dim)
+  { 
+    if ((embeddedDim == 0) || (embeddedDim > dim))
+      {
+	throw std::invalid_argument("The embedding must have between 1 "
+				    "and dim dimensions.");
+      }
+
+    vectord lowerBound = zvectord(mInputDims);
+    vectord upperBound = svectord(mInputDims,1.0);
+    mInputBB.reset(new utils::BoundingBox<vectord>(lowerBound,upperBound));
+
+    resetEmbedding();
+  } // Constructor
+
+  RemboModel::~RemboModel()
+  { } // Default destructor
+
+  vectord RemboModel::getFinalResult()
+  {
+    return projectToInputSpace(getPointAtMinimum());
+  }
+
+  void RemboModel::setBoundingBox(const vectord &lowerBound,
+				  const vectord &upperBound)
+  {
+    LogScope logging(mLogSettings);
+    mInputBB.reset(new utils::BoundingBox<vectord>(lowerBound,upperBound));
+    
+    FILE_LOG(logINFO) << "Bounds: ";
+    FILE_LOG(logINFO) << lowerBound;
+    FILE_LOG(logINFO) << upperBound;
+  } //setBoundingBox
+
+  void RemboModel::optimizeEmbeddings(vectord &bestPoint, size_t nEmbeddings)
+  {
+    LogScope logging(mLogSettings);
+    double bestValue = HUGE_VAL;
+    vectord result(mInputDims);
+    for (size_t ii = 0; ii < nEmbeddings; ++ii)
+      {
+	if (ii > 0)  resetEmbedding();
+	optimize(result);
+
+	const double value = getValueAtMinimum();
+	FILE_LOG(logINFO) << "Embedding: " << ii+1 << " of " << nEmbeddings
+			  << " | Best outcome: " << value;
+	if (value < bestValue)
+	  {
+	    bestValue = value;
+	    bestPoint = result;
+	  }
+      }
+  }
+
+  void RemboModel::resetEmbedding()
+  {
+    // The embedding is drawn from its own seed, so it can be stored
+    // in the journal and checked before a replay.
+    mEmbeddingSeed = static_cast<boost::uint64_t>(mEngine()) << 32;
+    mEmbeddingSeed |= mEngine();
+    randEngine embeddingEngine(mEmbeddingSeed);
+    randNFloat drawSample(embeddingEngine,normalDist(0,1));
+    mA.resize(mInputDims,mDims,false);
+    for (size_t i = 0; i < mInputDims; ++i)
+      {
+	for (size_t j = 0; j < mDims; ++j)
+	  {
+	    mA(i,j) = drawSample();
+	  }
+      }
+  }
+
+  vectord RemboModel::projectToInputSpace(const vectord &query)
+  {
+    // From [0,1]^d to the embedded box [-sqrt(d),sqrt(d)]^d
+    const double side = std::sqrt(static_cast<double>(mDims));
+    const vectord y = side * (2.0 * query - svectord(mDims,1.0));
+
+    // From [-1,1]^D to the bounding box
+    const vectord x = 0.5 * (prod(mA,y) + svectord(mInputDims,1.0));
+    return mInputBB->clipVector(mInputBB->unnormalizeVector(x));
+  }
+
+  //////////////////////////////////////////////////////////////////////
+
+  double RemboModel::evaluateSampleInternal( const vectord &query )
+  { 
+    const double yNext = evaluateSample(projectToInputSpace(query)); 
+    if (yNext == HUGE_VAL)
+      {
+	throw std::runtime_error("Function evaluation out of range");
+      }
+    return yNext;
+  }; 
+
+  vectord RemboModel::normalizeInput(const vectord& /*x*/)
+  { 
+    throw std::invalid_argument("Observations in the input space cannot be "
+				"mapped to the random embedding.");
+  };
+
+  vectord RemboModel::unnormalizeInput(const vectord& x)
+  { return projectToInputSpace(x); };
+
+  utils::JournalDomain RemboModel::getJournalDomain()
+  {
+    utils::JournalDomain domain;
+    domain.nInputDims = mInputDims;
+    domain.nDims = mDims;
+    domain.lower = mInputBB->unnormalizeVector(zvectord(mInputDims));
+    domain.upper = mInputBB->unnormalizeVector(svectord(mInputDims,1.0));
+    domain.seed = mEmbeddingSeed;
+    return domain;
+  }
+
+  void RemboModel::plotStepData(size_t iteration, const vectord& xNext,
+				double yNext)
+  {
+    if(mParameters.verbose_level >0)
+      { 
+	FILE_LOG(logINFO) << "Iteration: " << iteration+1 << " of " 
+			  << mParameters.n_iterations << " | Total samples: " 
+			  << iteration+1+mParameters.n_init_samples ;
+	// The input space might be too large to be printed.
+	FILE_LOG(logINFO) << "Embedded query: " << xNext;
+	FILE_LOG(logINFO) << "Query outcome: " << yNext ;
+	FILE_LOG(logINFO) << "Best embedded query: " << getPointAtMinimum(); 
+	FILE_LOG(logINFO) << "Best outcome: " <<  getValueAtMinimum();
+      }
+  } //plotStepData
+
+}  //namespace bayesopt
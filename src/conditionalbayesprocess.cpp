@@ -24,6 +24,7 @@
 
 #include "conditionalbayesprocess.hpp"
 #include "log.hpp"
+#include "profiler.hpp"
 //#include "optimizekernel.hpp"	
 
 
@@ -41,6 +42,8 @@ namespace bayesopt
 
   double ConditionalBayesProcess::evaluateKernelParams()
   { 
+    utils::Profiler::count(utils::COUNT_LIKELIHOOD);
+    utils::TraceSpan span("likelihood");
     switch(mScoreType)
       {
       case SC_MTL:
@@ -81,8 +84,7 @@ namespace bayesopt
 	const vectord x = data.getSampleX(0);
 
 	// Remove it for cross validation
-	data.mX.erase(data.mX.begin()); 
-	utils::erase(data.mY,data.mY.begin());
+	data.removeSample(0);
 	utils::erase_column(mMean.mFeatM,0);
 
 	// Compute the cross validation
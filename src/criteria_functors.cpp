@@ -60,6 +60,7 @@ namespace bayesopt
     registry["cOptimisticSampling"] = & create_func<OptimisticSampling>;
     registry["cThompsonSampling"] = & create_func<ThompsonSampling>;
     registry["cDistance"] = & create_func<InputDistance>;
+    registry["cDataDistance"] = & create_func<DataDistance>;
 
     registry["cSum"] = & create_func<SumCriteria>;
     registry["cProd"] = & create_func<ProdCriteria>;
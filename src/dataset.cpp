@@ -21,6 +21,7 @@
 */
 
 #include "dataset.hpp"
+#include <cassert>
 
 #include <boost/numeric/ublas/matrix_proxy.hpp>
 
@@ -40,11 +41,40 @@ namespace bayesopt
   void Dataset::setSamples(const matrixd &x, const vectord &y)
   {
     mY = y;
+    mX.clear();
+    mMinIndex = 0;  mMaxIndex = 0;
     for (size_t i=0; i<x.size1(); ++i)
       {
 	mX.push_back(row(x,i));
 	updateMinMax(i);
       } 
+    mTree.build(mX);
+  };
+
+  void Dataset::setSamples(const vecOfvec &x, const vectord &y)
+  {
+    assert(x.size() == y.size());
+    mX = x;  mY = y;
+    mMinIndex = 0;  mMaxIndex = 0;
+    for (size_t i=0; i<mX.size(); ++i)  updateMinMax(i);
+    mTree.build(mX);
+  };
+
+
+  void Dataset::removeSample(size_t index)
+  {
+    assert(index < mX.size());
+    mX.erase(mX.begin()+index);
+    utils::erase(mY,mY.begin()+index);
+    mTree.build(mX);    // Indexes have changed
+
+    // The indexes are shifted, so we need to find them again.
+    mMinIndex = 0;  mMaxIndex = 0;
+    for (size_t i = 1; i < mY.size(); ++i)
+      {
+	if (mY(mMinIndex) > mY(i))  mMinIndex = i;
+	if (mY(mMaxIndex) < mY(i))  mMaxIndex = i;
+      }
   };
 
 
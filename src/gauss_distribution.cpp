@@ -5,8 +5,7 @@
 namespace bayesopt
 {
 
-  GaussianDistribution::GaussianDistribution(randEngine& eng): 
-    ProbabilityDistribution(eng)
+  GaussianDistribution::GaussianDistribution()
   {
     mean_ = 0.0;  std_ = 1.0;
   }
@@ -63,9 +62,9 @@ namespace bayesopt
   }  // negativeProbabilityOfImprovement
 
 
-  double GaussianDistribution::sample_query()
+  double GaussianDistribution::sample_query(randEngine& eng)
   { 
-    randNFloat sample(mtRandom,normalDist(mean_,std_));
+    randNFloat sample(eng,normalDist(mean_,std_));
     return sample();
   } // sample_query
 
@@ -20,6 +20,7 @@
 ------------------------------------------------------------------------
 */
 
+#include <limits>
 #include "ublas_trace.hpp"
 #include "gaussian_process.hpp"
 
@@ -33,14 +34,13 @@ namespace bayesopt
 				   randEngine& eng):
     ConditionalBayesProcess(dim, params, data, mean, eng)
   {
+    mSparseSupport = true;
     mSigma = params.sigma_s;
-    d_ = new GaussianDistribution(eng);
   }  // Constructor
 
 
   GaussianProcess::~GaussianProcess()
   {
-    delete d_;
   } // Default destructor
 
 
@@ -53,6 +53,32 @@ namespace bayesopt
 
   double GaussianProcess::negativeLogLikelihood()
   {
+    if (useSparseCorrelation())
+      {
+	utils::EnvelopeCholesky L;
+	if (computeSparseCholeskyCorrelation(L))
+	  {
+	    // Not positive definite: discard these hyperparameters
+	    return std::numeric_limits<double>::max();
+	  }
+	vectord alpha(mData.mY-mMean.muTimesFeat());
+	L.solveLower(alpha);
+	return ublas::inner_prod(alpha,alpha)/(2*mSigma) + L.logTrace();
+      }
+
+    if (useIterativeSolver())
+      {
+	const vectord res(mData.mY-mMean.muTimesFeat());
+	matrixd B(res.size(),1), X;
+	column(B,0) = res;
+	if (!solveCorrelationCG(B,X))
+	  {
+	    return std::numeric_limits<double>::max();
+	  }
+	return ublas::inner_prod(res,column(X,0))/(2*mSigma) 
+	  + 0.5*estimateLogDetCorrelation();
+      }
+
     const matrixd K = computeCorrMatrix();
     const size_t n = K.size1();
     matrixd L(n,n);
@@ -65,20 +91,25 @@ namespace bayesopt
     return loglik;
   }
 
-  ProbabilityDistribution* GaussianProcess::prediction(const vectord &query)
+  void GaussianProcess::predict(const vectord &query,
+				ProbabilityDistribution& d) const
   {
     const double kq = computeSelfCorrelation(query);
     const vectord kn = computeCrossCorrelation(query);
     
 
     vectord vd(kn);
-    inplace_solve(mL,vd,ublas::lower_tag());
+    solveCholeskyCorrelation(vd);
     double basisPred = mMean.muTimesFeat(query);
     double yPred = basisPred + ublas::inner_prod(vd,mAlphaV);
     double sPred = sqrt(mSigma*(kq - ublas::inner_prod(vd,vd)));
     
-    d_->setMeanAndStd(yPred,sPred);
-    return d_;
+    d.setMeanAndStd(yPred,sPred);
+  }
+
+  ProbabilityDistribution* GaussianProcess::createPrediction() const
+  {
+    return new GaussianDistribution();
   }
 
 
@@ -88,7 +119,7 @@ namespace bayesopt
   
     mAlphaV.resize(n,false);
     mAlphaV = mData.mY-mMean.muTimesFeat();
-    inplace_solve(mL,mAlphaV,ublas::lower_tag());
+    solveCholeskyCorrelation(mAlphaV);
   }
 	
 } //namespace bayesopt
@@ -21,6 +21,7 @@
 */
 
 #include "gaussian_process_hierarchical.hpp"
+#include <limits>
 #include "ublas_trace.hpp"
 
 namespace bayesopt
@@ -39,6 +40,8 @@ namespace bayesopt
     /*This is the restricted version. For the unrestricted, make p=0
       and remove the last term of loglik*/
 
+    if (useIterativeSolver())  return negativeTotalLogLikelihoodCG();
+
     const matrixd K = computeCorrMatrix();
     const size_t n = K.size1();
     const size_t p = mMean.mFeatM.size1(); 
@@ -68,5 +71,70 @@ namespace bayesopt
       + utils::log_trace(L) + utils::log_trace(L2);
     return loglik;
   }
+
+  double HierarchicalGaussianProcess::negativeTotalLogLikelihoodCG()
+  {
+    const size_t n = mData.getNSamples();
+    const size_t p = mMean.mFeatM.size1(); 
+
+    // Solve K [KinvF | Kinvy] = [F' | y] together
+    matrixd B(n,p+1), X;
+    ublas::subrange(B,0,n,0,p) = ublas::trans(mMean.mFeatM);
+    column(B,p) = mData.mY;
+    if (!solveCorrelationCG(B,X))
+      {
+	return std::numeric_limits<double>::max();
+      }
+
+    const matrixd KinvF = ublas::subrange(X,0,n,0,p);
+    const vectord Kinvy = column(X,p);
+
+    matrixd FKF = prod(mMean.mFeatM,KinvF);
+    matrixd L2(p,p);
+    if (utils::cholesky_decompose(FKF,L2))
+      {
+	return std::numeric_limits<double>::max();
+      }
+
+    const vectord FKy = prod(mMean.mFeatM,Kinvy);
+    vectord wML(FKy);
+    utils::cholesky_solve(L2,wML,ublas::lower());
+
+    // (y-F'w)' K^-1 (y-F'w) = y' K^-1 y - w' F K^-1 y
+    const double zz = ublas::inner_prod(mData.mY,Kinvy) 
+      - ublas::inner_prod(wML,FKy);
+    if (zz <= 0)  return std::numeric_limits<double>::max();
+
+    return .5*(n-p)*log(zz) + 0.5*estimateLogDetCorrelation()
+      + utils::log_trace(L2);
+  }
+
+  double HierarchicalGaussianProcess::computeWeightedMarginal(const matrixd& L,
+							      const matrixd& KF,
+							      const vectord& w,
+							      const vectord& v,
+							      double& zz)
+  {
+    const size_t p = w.size();
+
+    vectord a(v);
+    inplace_solve(L,a,ublas::lower_tag());
+    vectord b = prod(a,KF);
+
+    // (K + F'WF)^-1 = K^-1 - K^-1 F' (W^-1 + F K^-1 F')^-1 F K^-1
+    matrixd M = prod(ublas::trans(KF),KF);
+    double logw = 0.0;
+    for (size_t ii = 0; ii < p; ++ii)
+      {
+	M(ii,ii) += 1/w(ii);
+	logw += std::log(w(ii));
+      }
+    matrixd C(p,p);
+    utils::cholesky_decompose(M,C);
+    inplace_solve(C,b,ublas::lower_tag());
+    zz = ublas::inner_prod(a,a) - ublas::inner_prod(b,b);
+
+    // |K + F'WF| = |K| |W| |W^-1 + F K^-1 F'|
+    return utils::log_trace(L) + 0.5*logw + utils::log_trace(C);
+  }
 }
-  
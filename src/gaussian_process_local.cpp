@@ -0,0 +1,181 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <boost/lexical_cast.hpp>
+#include "ublas_trace.hpp"
+#include "gaussian_process_local.hpp"
+
+namespace bayesopt
+{
+
+  namespace ublas = boost::numeric::ublas;
+
+  // Maximum number of cached neighbourhoods and of neighbourhoods in
+  // the composite likelihood.
+  const size_t MAX_CACHED_MODELS = 256;
+  const size_t MAX_LIKELIHOOD_BLOCKS = 10;
+
+  LocalGaussianProcess::LocalGaussianProcess(size_t dim, bopt_params params, 
+					     const Dataset& data, MeanModel& mean,
+					     randEngine& eng):
+    ConditionalBayesProcess(dim, params, data, mean, eng),
+    mNeighbours(params.n_neighbours)
+  {
+    if (mNeighbours == 0)
+      {
+	throw std::invalid_argument("Local process requires at least "
+				    "one neighbour");
+      }
+    mSigma = params.sigma_s;
+  }  // Constructor
+
+
+  LocalGaussianProcess::~LocalGaussianProcess()
+  {
+  } // Default destructor
+
+
+  void LocalGaussianProcess::fitSurrogateModel()
+  {
+    mCache.clear();
+  }
+
+
+  void LocalGaussianProcess::updateSurrogateModel()
+  {
+    mCache.clear();
+  }
+
+
+  double LocalGaussianProcess::negativeTotalLogLikelihood()
+  {
+    // In this case it is equivalent.
+    return negativeLogLikelihood();
+  }
+
+
+  double LocalGaussianProcess::negativeLogLikelihood()
+  {
+    const size_t n = mData.getNSamples();
+    const size_t k = (std::min)(mNeighbours,n);
+    const size_t nBlocks = (std::min)(MAX_LIKELIHOOD_BLOCKS, (n+k-1)/k);
+
+    // The first block is around the incumbent, where the model
+    // matters the most. The rest are spread over the data.
+    std::vector<size_t> centers(1,mData.getIndexAtMinimum());
+    for (size_t ii = 1; ii < nBlocks; ++ii)  centers.push_back(ii*n/nBlocks);
+
+    double loglik = 0.0;
+    std::vector<size_t> indexes;
+    LocalModel model;
+    for (size_t ii = 0; ii < centers.size(); ++ii)
+      {
+	mData.getNearestSamples(mData.getSampleX(centers[ii]),k,indexes);
+	if (computeLocalModel(indexes,model))
+	  {
+	    // Not positive definite: discard these hyperparameters
+	    return std::numeric_limits<double>::max();
+	  }
+	loglik += ublas::inner_prod(model.mAlphaV,model.mAlphaV)/(2*mSigma)
+	  + utils::log_trace(model.mL);
+      }
+    return loglik;
+  }
+
+
+  void LocalGaussianProcess::predict(const vectord &query,
+				     ProbabilityDistribution& d) const
+  {
+    std::vector<size_t> indexes;
+    mData.getNearestSamples(query,mNeighbours,indexes);
+    std::sort(indexes.begin(),indexes.end());
+
+    LocalModelPtr cached;
+    {
+      utils::SpinLockGuard guard(mCacheLock);
+      LocalModelCache::const_iterator it = mCache.find(indexes);
+      if (it != mCache.end())  cached = it->second;
+    }
+    if (!cached)
+      {
+	// Computed out of the lock. Concurrent misses of the same
+	// neighbourhood might compute it twice, but that is harmless.
+	boost::shared_ptr<LocalModel> newModel(new LocalModel);
+	size_t line_error = computeLocalModel(indexes,*newModel);
+	if (line_error) 
+	  {
+	    throw std::runtime_error("Cholesky decomposition error at line " + 
+				     boost::lexical_cast<std::string>(line_error));
+	  }
+	cached = newModel;
+
+	utils::SpinLockGuard guard(mCacheLock);
+	if (mCache.size() >= MAX_CACHED_MODELS)  mCache.clear();
+	mCache[indexes] = cached;
+      }
+    const LocalModel& model = *cached;
+
+    const double kq = computeSelfCorrelation(query);
+    vectord vd = mKernel.computeCrossCorrelation(model.mX,query);
+    inplace_solve(model.mL,vd,ublas::lower_tag());
+
+    double basisPred = mMean.muTimesFeat(query);
+    double yPred = basisPred + ublas::inner_prod(vd,model.mAlphaV);
+    double sPred = sqrt(mSigma*(kq - ublas::inner_prod(vd,vd)));
+    
+    d.setMeanAndStd(yPred,sPred);
+  }
+
+  ProbabilityDistribution* LocalGaussianProcess::createPrediction() const
+  {
+    return new GaussianDistribution();
+  }
+
+
+  size_t LocalGaussianProcess::computeLocalModel(const std::vector<size_t>& indexes,
+						 LocalModel& model) const
+  {
+    const size_t k = indexes.size();
+    model.mX.resize(k);
+    model.mAlphaV.resize(k,false);
+    for (size_t ii = 0; ii < k; ++ii)
+      {
+	const size_t index = indexes[ii];
+	model.mX[ii] = mData.getSampleX(index);
+	model.mAlphaV(ii) = mData.getSampleY(index) 
+	  - mMean.muTimesFeat(model.mX[ii]);
+      }
+
+    matrixd K(k,k);
+    mKernel.computeCorrMatrix(model.mX,K,mRegularizer);
+    model.mL.resize(k,k,false);
+    size_t line_error = utils::cholesky_decompose(K,model.mL);
+    if (line_error)  return line_error;
+
+    inplace_solve(model.mL,model.mAlphaV,ublas::lower_tag());
+    return 0;
+  }
+	
+} //namespace bayesopt
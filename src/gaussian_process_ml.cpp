@@ -33,14 +33,12 @@ namespace bayesopt
 				       MeanModel& mean, randEngine& eng):
     HierarchicalGaussianProcess(dim, params, data, mean, eng)
   {
-    d_ = new GaussianDistribution(eng);
   }  // Constructor
 
 
 
   GaussianProcessML::~GaussianProcessML()
   {
-    delete d_;
   } // Default destructor
 
 
@@ -53,7 +51,8 @@ namespace bayesopt
   }
 
 
-  ProbabilityDistribution* GaussianProcessML::prediction( const vectord &query )
+  void GaussianProcessML::predict(const vectord &query,
+				  ProbabilityDistribution& d) const
   {
     double kq = computeSelfCorrelation(query);
     vectord kn = computeCrossCorrelation(query);
@@ -71,8 +70,12 @@ namespace bayesopt
     double sPred = sqrt( mSigma * (kq - inner_prod(v,v) 
 				   + inner_prod(rho,rho)));
 
-    d_->setMeanAndStd(yPred,sPred);
-    return d_;
+    d.setMeanAndStd(yPred,sPred);
+  }
+
+  ProbabilityDistribution* GaussianProcessML::createPrediction() const
+  {
+    return new GaussianDistribution();
   }
 
   void GaussianProcessML::precomputePrediction()
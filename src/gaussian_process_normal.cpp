@@ -49,19 +49,17 @@ namespace bayesopt
 	double varii = params.mean.coef_std[ii] * params.mean.coef_std[ii];
 	mInvVarW(ii) = 1/varii;
       }
-     d_ = new GaussianDistribution(eng);
   }  // Constructor
 
 
 
   GaussianProcessNormal::~GaussianProcessNormal()
   {
-    delete d_;
   } // Default destructor
 
 
-  ProbabilityDistribution* 
-  GaussianProcessNormal::prediction(const vectord &query)
+  void GaussianProcessNormal::predict(const vectord &query,
+				      ProbabilityDistribution& d) const
   {
     const double kq = computeSelfCorrelation(query);
     const vectord phi = mMean.getFeatures(query);
@@ -85,29 +83,31 @@ namespace bayesopt
       }
 					
 
-    d_->setMeanAndStd(yPred,sPred);
-    return d_;
+    d.setMeanAndStd(yPred,sPred);
+  }
+
+  ProbabilityDistribution* GaussianProcessNormal::createPrediction() const
+  {
+    return new GaussianDistribution();
   }
 
 
   double GaussianProcessNormal::negativeLogLikelihood()
   {
-    matrixd KK = computeCorrMatrix();
-    const size_t n = KK.size1();
-    const size_t p = mMean.nFeatures();
+    const matrixd K = computeCorrMatrix();
+    const size_t n = K.size1();
   
     vectord v0 = mData.mY - prod(trans(mMean.mFeatM),mW0);
-    matrixd WW = zmatrixd(p,p);  //TODO: diagonal matrix
-    utils::add_to_diagonal(WW,mInvVarW);
-    matrixd FW = prod(trans(mMean.mFeatM),WW);
-    KK += prod(FW,mMean.mFeatM);
-    matrixd BB(n,n);
-    utils::cholesky_decompose(KK,BB);
-    inplace_solve(BB,v0,ublas::lower_tag());
-    double zz = inner_prod(v0,v0);
+    matrixd L(n,n);
+    utils::cholesky_decompose(K,L);
+    matrixd KF(trans(mMean.mFeatM));
+    inplace_solve(L,KF,ublas::lower_tag());
+
+    double zz;
+    const double logtraceBB = computeWeightedMarginal(L,KF,mInvVarW,v0,zz);
 
     double lik = 1/(2*mSigma) * zz;
-    lik += utils::log_trace(BB);
+    lik += logtraceBB;
     return lik;
   }
 
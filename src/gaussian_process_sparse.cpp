@@ -0,0 +1,243 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <algorithm>
+#include <stdexcept>
+#include <boost/lexical_cast.hpp>
+#include "ublas_trace.hpp"
+#include "gaussian_process_sparse.hpp"
+
+namespace bayesopt
+{
+
+  namespace ublas = boost::numeric::ublas;
+
+  SparseGaussianProcess::SparseGaussianProcess(size_t dim, bopt_params params, 
+					       const Dataset& data, MeanModel& mean,
+					       randEngine& eng, bool useVFE):
+    ConditionalBayesProcess(dim, params, data, mean, eng),
+    mMaxInducing(params.n_inducing), mUseVFE(useVFE)
+  {
+    if (mMaxInducing == 0)
+      {
+	throw std::invalid_argument("Sparse process requires at least "
+				    "one inducing point");
+      }
+    mSigma = params.sigma_s;
+  }  // Constructor
+
+
+  SparseGaussianProcess::~SparseGaussianProcess()
+  {
+  } // Default destructor
+
+
+  void SparseGaussianProcess::fitSurrogateModel()
+  {
+    selectInducingPoints();
+    precomputePrediction();
+  }
+
+
+  void SparseGaussianProcess::updateSurrogateModel()
+  {
+    if (mInducing.size() < mMaxInducing)
+      {
+	const vectord lastX = mData.getLastSampleX();
+	vectord v = mKernel.computeCrossCorrelation(mInducing,lastX);
+	inplace_solve(mLm,v,ublas::lower_tag());
+	const double residual = computeSelfCorrelation(lastX) 
+	  - ublas::inner_prod(v,v);
+	if (residual > mRegularizer)  mInducing.push_back(lastX);
+      }
+    precomputePrediction();
+  } // updateSurrogateModel
+
+
+  double SparseGaussianProcess::negativeTotalLogLikelihood()
+  {
+    // In this case it is equivalent.
+    return negativeLogLikelihood();
+  }
+
+
+  double SparseGaussianProcess::negativeLogLikelihood()
+  {
+    // The inducing set is kept fixed while learning the kernel
+    // hyperparameters. It might be empty before the first fit.
+    if (mInducing.empty())  selectInducingPoints();
+
+    matrixd Lm, La;
+    vectord b, lambda;
+    double trDiff;
+    const double quad = computeSparseFactors(Lm,La,b,lambda,trDiff);
+
+    // |Qnn + Lambda| = |Lambda| |I + V Lambda^-1 V'|
+    double loglik = (quad - ublas::inner_prod(b,b))/(2*mSigma);
+    loglik += utils::log_trace(La);
+    for (size_t ii = 0; ii < lambda.size(); ++ii)
+      {
+	loglik += 0.5*std::log(lambda(ii));
+      }
+
+    if (mUseVFE)  loglik += trDiff/(2*mRegularizer);
+    return loglik;
+  }
+
+
+  void SparseGaussianProcess::predict(const vectord &query,
+				      ProbabilityDistribution& d) const
+  {
+    const double kq = computeSelfCorrelation(query);
+    const vectord km = mKernel.computeCrossCorrelation(mInducing,query);
+
+    double basisPred = mMean.muTimesFeat(query);
+    double yPred = basisPred + ublas::inner_prod(km,mAlphaM);
+
+    vectord v(km);
+    inplace_solve(mLm,v,ublas::lower_tag());
+    vectord w(v);
+    inplace_solve(mLa,w,ublas::lower_tag());
+    double sPred = sqrt(mSigma*(kq - ublas::inner_prod(v,v) 
+				+ ublas::inner_prod(w,w)));
+    
+    d.setMeanAndStd(yPred,sPred);
+  }
+
+  ProbabilityDistribution* SparseGaussianProcess::createPrediction() const
+  {
+    return new GaussianDistribution();
+  }
+
+
+  void SparseGaussianProcess::precomputePrediction()
+  {
+    vectord lambda;
+    double trDiff;
+    computeSparseFactors(mLm,mLa,mAlphaM,lambda,trDiff);
+
+    // alpha = Lm' \ (La' \ b)
+    inplace_solve(ublas::trans(mLa),mAlphaM,ublas::upper_tag());
+    inplace_solve(ublas::trans(mLm),mAlphaM,ublas::upper_tag());
+  }
+
+
+  void SparseGaussianProcess::selectInducingPoints()
+  {
+    const size_t n = mData.getNSamples();
+    const size_t m = (std::min)(mMaxInducing,n);
+
+    vectord diag(n);
+    for (size_t ii = 0; ii < n; ++ii)
+      {
+	diag(ii) = computeSelfCorrelation(mData.mX[ii]);
+      }
+
+    // Rows of the partial (pivoted) Cholesky factor
+    matrixd V(m,n);
+    mInducing.clear();
+    for (size_t k = 0; k < m; ++k)
+      {
+	const size_t jj = std::max_element(diag.begin(),diag.end()) - diag.begin();
+	const double pivot = diag(jj);
+	if (pivot <= mRegularizer) break;
+
+	const vectord& xj = mData.mX[jj];
+	mInducing.push_back(xj);
+
+	const ublas::matrix_range<matrixd> Vk = ublas::subrange(V,0,k,0,n);
+	const vectord vj = ublas::column(Vk,jj);
+	ublas::row(V,k) = (computeCrossCorrelation(xj) 
+			   - ublas::prod(ublas::trans(Vk),vj)) / std::sqrt(pivot);
+
+	for (size_t ii = 0; ii < n; ++ii)
+	  {
+	    diag(ii) -= V(k,ii) * V(k,ii);
+	  }
+	diag(jj) = 0.0;
+      }
+  }
+
+
+  double SparseGaussianProcess::computeSparseFactors(matrixd& Lm, matrixd& La, 
+						     vectord& b, vectord& lambda,
+						     double& trDiff)
+  {
+    const size_t n = mData.getNSamples();
+    const size_t m = mInducing.size();
+
+    matrixd Kmm(m,m);
+    mKernel.computeCorrMatrix(mInducing,Kmm,mRegularizer);
+    Lm.resize(m,m,false);
+    size_t line_error = utils::cholesky_decompose(Kmm,Lm);
+    if (line_error) 
+      {
+	throw std::runtime_error("Cholesky decomposition error at line " + 
+				 boost::lexical_cast<std::string>(line_error));
+      }
+
+    // V = Lm \ Kmn
+    matrixd V(m,n);
+    for (size_t jj = 0; jj < n; ++jj)
+      {
+	ublas::column(V,jj) = mKernel.computeCrossCorrelation(mInducing,
+							      mData.mX[jj]);
+      }
+    inplace_solve(Lm,V,ublas::lower_tag());
+
+    // Scale everything by Lambda^-1/2
+    vectord r = mData.mY - mMean.muTimesFeat();
+    lambda.resize(n,false);
+    trDiff = 0.0;
+    double quad = 0.0;
+    for (size_t jj = 0; jj < n; ++jj)
+      {
+	ublas::matrix_column<matrixd> vj(V,jj);
+	const double diff = (std::max)(computeSelfCorrelation(mData.mX[jj]) 
+				       - ublas::inner_prod(vj,vj), 0.0);
+	trDiff += diff;
+	lambda(jj) = (mUseVFE ? 0.0 : diff) + mRegularizer;
+
+	const double scale = 1/std::sqrt(lambda(jj));
+	vj *= scale;
+	r(jj) *= scale;
+	quad += r(jj) * r(jj);
+      }
+
+    matrixd A(m,m);
+    noalias(A) = ublas::prod(V,ublas::trans(V));
+    for (size_t ii = 0; ii < m; ++ii)  A(ii,ii) += 1.0;
+
+    La.resize(m,m,false);
+    line_error = utils::cholesky_decompose(A,La);
+    if (line_error) 
+      {
+	throw std::runtime_error("Cholesky decomposition error at line " + 
+				 boost::lexical_cast<std::string>(line_error));
+      }
+
+    b = ublas::prod(V,r);
+    inplace_solve(La,b,ublas::lower_tag());
+    return quad;
+  }
+
+} //namespace bayesopt
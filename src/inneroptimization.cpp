@@ -23,6 +23,7 @@
 #include <nlopt.hpp>
 #include "parameters.h"
 #include "log.hpp"
+#include "tracer.hpp"
 #include "inneroptimization.hpp"
 
 namespace bayesopt
@@ -138,6 +139,7 @@ namespace bayesopt
 
     vectord start = Xnext;
 
+    utils::TraceSpan span("local trial");
     double fmin = run_nlopt(algo,fpointer,Xnext,nIter,
 			    mDown,mUp,objPointer);
 
@@ -174,27 +176,28 @@ namespace bayesopt
 
     //    nlopt_opt opt;
     nlopt::algorithm algo;
+    const char* spanName;
     switch(alg)
       {
       case DIRECT: // Pure global. No gradient
-	algo = nlopt::GN_DIRECT_L;
+	algo = nlopt::GN_DIRECT_L;      spanName = "DIRECT";
 	fpointer = &(NLOPT_Optimization::evaluate_nlopt);
 	objPointer = static_cast<void *>(rbobj);
 	break;
       case COMBINED: // Combined local-global (80% DIRECT -> 20% BOBYQA). No gradient
-	algo = nlopt::GN_DIRECT_L;
+	algo = nlopt::GN_DIRECT_L;      spanName = "DIRECT";
 	maxf2 = static_cast<int>(static_cast<double>(maxf1)*coef_local);
 	maxf1 -= maxf2;  // That way, the number of evaluations is the same in all methods.
 	fpointer = &(NLOPT_Optimization::evaluate_nlopt);
 	objPointer = static_cast<void *>(rbobj);
 	break;
       case BOBYQA:  // Pure local. No gradient
-	algo = nlopt::LN_BOBYQA;
+	algo = nlopt::LN_BOBYQA;        spanName = "BOBYQA";
 	fpointer = &(NLOPT_Optimization::evaluate_nlopt);
 	objPointer = static_cast<void *>(rbobj);
 	break;
       case LBFGS:  // Pure local. Gradient based
-	algo = nlopt::LD_LBFGS;
+	algo = nlopt::LD_LBFGS;         spanName = "LBFGS";
 	fpointer = &(NLOPT_Optimization::evaluate_nlopt_grad);
 	objPointer = static_cast<void *>(rgbobj);
 	break;
@@ -209,8 +212,11 @@ namespace bayesopt
 				    "(gradient/no gradient)");
       }
 
-    fmin = run_nlopt(algo,fpointer,Xnext,maxf1,
-		     mDown,mUp,objPointer);
+    {
+      utils::TraceSpan span(spanName);
+      fmin = run_nlopt(algo,fpointer,Xnext,maxf1,
+		       mDown,mUp,objPointer);
+    }
 
     FILE_LOG(logDEBUG) << "1st opt " << maxf1 << "-> " << Xnext 
 		       << " f() ->" << fmin;
@@ -223,6 +229,7 @@ namespace bayesopt
 	    if (mUp[i] - Xnext(i) < 0.0001) Xnext(i) -= 0.0001;
 	  }
 
+	utils::TraceSpan span("local refinement");
 	fmin = run_nlopt(nlopt::LN_BOBYQA,fpointer,Xnext,maxf2,
 			 mDown,mUp,objPointer);
 	FILE_LOG(logDEBUG) << "2nd opt " << maxf2 << "-> " << Xnext 
@@ -25,6 +25,8 @@
 #include "parser.hpp"
 #include "ublas_extra.hpp"
 #include "kernel_functors.hpp"
+#include "cellgrid.hpp"
+#include "threadpool.hpp"
 
 #include "kernels/kernel_atomic.hpp"
 #include "kernels/kernel_const.hpp"
@@ -34,10 +36,12 @@
 #include "kernels/kernel_polynomial.hpp"
 #include "kernels/kernel_gaussian.hpp"
 #include "kernels/kernel_rq.hpp"
+#include "kernels/kernel_wendland.hpp"
 
 #include "kernels/kernel_combined.hpp"
 #include "kernels/kernel_sum.hpp"
 #include "kernels/kernel_prod.hpp"
+#include "kernels/kernel_additive.hpp"
 
 namespace bayesopt
 {
@@ -69,8 +73,16 @@ namespace bayesopt
 
     registry["kRQISO"] = & create_func<RQIso>;
 
+    registry["kWendlandISO0"] = & create_func< WendlandIso<0> >;
+    registry["kWendlandISO1"] = & create_func< WendlandIso<1> >;
+    registry["kWendlandISO2"] = & create_func< WendlandIso<2> >;
+    registry["kWendlandARD0"] = & create_func< WendlandARD<0> >;
+    registry["kWendlandARD1"] = & create_func< WendlandARD<1> >;
+    registry["kWendlandARD2"] = & create_func< WendlandARD<2> >;
+
     registry["kSum"] = & create_func<KernelSum>;
     registry["kProd"] = & create_func<KernelProd>;
+    registry["kAdditive"] = & create_func<AdditiveKernel>;
   }
 
 
@@ -85,6 +97,24 @@ namespace bayesopt
    * @return kernel pointer
    */
   Kernel* KernelFactory::create(std::string name, size_t input_dim)
+  {
+    // By default, additive kernels have one group per dimension
+    vecOfGroups groups(input_dim);
+    for (size_t i = 0; i < input_dim; ++i)  groups[i].push_back(i);
+    return create(name,input_dim,groups);
+  };
+
+  /** 
+   * \brief Factory model for kernel functions with groups of input
+   * dimensions. Expressions with a single child, like
+   * kAdditive(kSEARD), create one child kernel per group.
+   * @param name string with the kernel structure
+   * @param imput_dim number of input dimensions
+   * @param groups indexes of the dimensions of each group
+   * @return kernel pointer
+   */
+  Kernel* KernelFactory::create(std::string name, size_t input_dim,
+				const vecOfGroups& groups)
   {
     Kernel *kFunc;
     std::string os, os1, os2;
@@ -102,9 +132,19 @@ namespace bayesopt
       {
 	kFunc->init(input_dim);
       } 
+    else if (os2.length() == 0) // Additive kernel, one child per group
+      {
+	std::vector<Kernel*> kernels;
+	for (size_t i = 0; i < groups.size(); ++i)
+	  {
+	    kernels.push_back(create(os1,groups[i].size()));
+	  }
+	kFunc->init(input_dim, kernels, groups);
+      }
     else // Combined kernel
       {
-	kFunc->init(input_dim, create(os1,input_dim), create(os2,input_dim));
+	kFunc->init(input_dim, create(os1,input_dim,groups), 
+		    create(os2,input_dim,groups));
       }
     return kFunc;
   };
@@ -119,10 +159,24 @@ namespace bayesopt
 			      const vectord &stheta,
 			      std::string k_name, 
 			      size_t dim)
+  {
+    vecOfGroups groups(dim);
+    for (size_t i = 0; i < dim; ++i)  groups[i].push_back(i);
+    setKernel(thetav, stheta, k_name, dim, groups);
+  }
+
+  void KernelModel::setKernel (const vectord &thetav, 
+			      const vectord &stheta,
+			      std::string k_name, 
+			      size_t dim,
+			      const vecOfGroups& groups)
   {
     KernelFactory mKFactory;
 
-    mKernel.reset(mKFactory.create(k_name, dim));
+    mKernel.reset(mKFactory.create(k_name, dim, groups));
+
+    vectord radius;
+    mCompactSupport = mKernel->compactSupport(radius);
 
     if ((thetav.size() == 1) && (stheta.size() == 1) && (mKernel->nHyperParameters() != 1))
       {
@@ -151,25 +205,162 @@ namespace bayesopt
     size_t n = kernel.n_hp;
     vectord th = utils::array2vector(kernel.hp_mean,n);
     vectord sth = utils::array2vector(kernel.hp_std,n);
-    setKernel(th, sth, kernel.name, dim);
+
+    // Group of each input dimension (ordered by group label)
+    std::map<int,std::vector<size_t> > labels;
+    if (kernel.n_groups == 0)
+      {
+	for (size_t i = 0; i < dim; ++i)  labels[i].push_back(i);
+      }
+    else if (kernel.n_groups == dim)
+      {
+	for (size_t i = 0; i < dim; ++i)  
+	  labels[kernel.groups[i]].push_back(i);
+      }
+    else
+      {
+	throw std::invalid_argument("The kernel groups must have one "
+				    "element per input dimension.");
+      }
+
+    vecOfGroups groups;
+    std::map<int,std::vector<size_t> >::iterator g_it;
+    for (g_it = labels.begin(); g_it != labels.end(); ++g_it)
+      {
+	groups.push_back(g_it->second);
+      }
+    setKernel(th, sth, kernel.name, dim, groups);
   };
 
 
+  // Rows of the correlation matrix per parallel task, and minimum
+  // number of samples to split the matrix.
+  const size_t CORR_ROWS_GRAIN = 16;
+  const size_t CORR_PARALLEL_MIN = 128;
+
+  namespace
+  {
+    /** Rows [begin,end) of a symmetric correlation matrix. The
+	elements of each row are only written by its task. */
+    class CorrRowsTask: public utils::RangeTask
+    {
+    public:
+      CorrRowsTask(const Kernel& kernel, const vecOfvec& XX, 
+		   matrixd& corrMatrix, double nugget):
+	mKernel(kernel), mX(XX), mCorr(corrMatrix), mNugget(nugget) {};
+
+      void operator()(size_t begin, size_t end)
+      {
+	for (size_t ii = begin; ii < end; ++ii)
+	  {
+	    for (size_t jj=0; jj < ii; ++jj)
+	      {
+		mCorr(ii,jj) = mKernel(mX[ii], mX[jj]);
+		mCorr(jj,ii) = mCorr(ii,jj);
+	      }
+	    mCorr(ii,ii) = mKernel(mX[ii],mX[ii]) + mNugget;
+	  }
+      };
+
+    private:
+      const Kernel& mKernel;
+      const vecOfvec& mX;
+      matrixd& mCorr;
+      double mNugget;
+    };
+  }
+
   void KernelModel::computeCorrMatrix(const vecOfvec& XX, matrixd& corrMatrix, 
-				     double nugget)
+				     double nugget) const
   {
     assert(corrMatrix.size1() == XX.size());
     assert(corrMatrix.size2() == XX.size());
     const size_t nSamples = XX.size();
+
+    utils::Profiler::count(utils::COUNT_KERNEL, nSamples*(nSamples+1)/2);
+
+    if (mKernel->gramMatrix(XX,corrMatrix))
+      {
+	for (size_t ii=0; ii< nSamples; ++ii)  corrMatrix(ii,ii) += nugget;
+	return;
+      }
+  
+    CorrRowsTask rows(*mKernel,XX,corrMatrix,nugget);
+    if (nSamples < CORR_PARALLEL_MIN)  rows(0,nSamples);
+    else  utils::parallelFor(0,nSamples,CORR_ROWS_GRAIN,rows);
+  }
+
+  void KernelModel::computeCorrProduct(const vecOfvec& XX, const matrixd& V,
+				       double nugget, matrixd& KV)
+  {
+    assert(V.size1() == XX.size());
+    const size_t nSamples = XX.size();
+    const size_t nCols = V.size2();
+    KV.resize(nSamples,nCols,false);
+    utils::Profiler::count(utils::COUNT_KERNEL, nSamples*(nSamples+1)/2);
   
     for (size_t ii=0; ii< nSamples; ++ii)
       {
+	const double kii = (*mKernel)(XX[ii],XX[ii]) + nugget;
+	for (size_t cc=0; cc < nCols; ++cc)  KV(ii,cc) = kii * V(ii,cc);
+
 	for (size_t jj=0; jj < ii; ++jj)
 	  {
-	    corrMatrix(ii,jj) = (*mKernel)(XX[ii], XX[jj]);
-	    corrMatrix(jj,ii) = corrMatrix(ii,jj);
+	    const double kij = (*mKernel)(XX[ii], XX[jj]);
+	    for (size_t cc=0; cc < nCols; ++cc)
+	      {
+		KV(ii,cc) += kij * V(jj,cc);
+		KV(jj,cc) += kij * V(ii,cc);
+	      }
+	  }
+      }
+  }
+
+  void KernelModel::computeSparseCorrMatrix(const vecOfvec& XX, 
+					    std::vector<utils::sparse_row>& corrMatrix,
+					    double nugget)
+  {
+    vectord radius;
+    if (!mKernel->compactSupport(radius))
+      {
+	throw std::invalid_argument("Sparse correlation requires a kernel "
+				    "with compact support");
+      }
+
+    const size_t nSamples = XX.size();
+    corrMatrix.assign(nSamples,utils::sparse_row());
+
+    // The grid only pays off if there are less cells than samples.
+    const bool useGrid = std::pow(3.0,static_cast<double>(radius.size())) 
+      < nSamples;
+    utils::CellGrid grid(radius);
+    std::vector<size_t> candidates;
+
+    for (size_t ii=0; ii< nSamples; ++ii)
+      {
+	if (useGrid)
+	  {
+	    grid.query(XX[ii],candidates);
+	  }
+	else
+	  {
+	    candidates.resize(ii);
+	    for (size_t jj=0; jj < ii; ++jj)  candidates[jj] = jj;
+	  }
+
+	for (size_t kk=0; kk < candidates.size(); ++kk)
+	  {
+	    const size_t jj = candidates[kk];
+	    const double value = (*mKernel)(XX[ii], XX[jj]);
+	    if (value != 0.0)
+	      {
+		corrMatrix[ii].push_back(std::make_pair(jj,value));
+	      }
 	  }
-	corrMatrix(ii,ii) = (*mKernel)(XX[ii],XX[ii]) + nugget;
+	corrMatrix[ii].push_back(std::make_pair(ii,
+				 (*mKernel)(XX[ii],XX[ii]) + nugget));
+	utils::Profiler::count(utils::COUNT_KERNEL, candidates.size()+1);
+	if (useGrid)  grid.insert(ii,XX[ii]);
       }
   }
 
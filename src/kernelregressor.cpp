@@ -30,19 +30,47 @@
 
 #include "log.hpp"
 #include "ublas_extra.hpp"
+#include "ublas_iterative.hpp"
 
 
 namespace bayesopt
 {
+  namespace ublas = boost::numeric::ublas;
+
+  // Settings of the iterative solvers (LS_CG)
+  const double CG_TOLERANCE     = 1e-6;
+  const size_t CG_MAX_ITERS     = 1000;
+  const size_t LANCZOS_PROBES   = 10;
+  const size_t LANCZOS_STEPS    = 50;
+  const size_t LANCZOS_SEED     = 1;
+
+  /** Functor of the matrix-free product with the Correlation matrix */
+  class CorrProductOp
+  {
+  public:
+    CorrProductOp(KernelModel& kernel, const vecOfvec& XX, double nugget):
+      mKernel(kernel), mX(XX), mNugget(nugget) {};
+    void operator()(const matrixd& V, matrixd& KV)
+    { mKernel.computeCorrProduct(mX,V,mNugget,KV); };
+  private:
+    KernelModel& mKernel;
+    const vecOfvec& mX;
+    double mNugget;
+  };
+
+
   KernelRegressor::KernelRegressor(size_t dim, bopt_params parameters,
 				   const Dataset& data,
 				   MeanModel& mean, randEngine& eng):
     NonParametricProcess(dim,parameters,data,mean,eng), 
-    mRegularizer(parameters.noise),
-    mKernel(dim, parameters),
+    mSparseSupport(false),
     mScoreType(parameters.sc_type),
     mLearnType(parameters.l_type),
-    mLearnAll(parameters.l_all)
+    mLearnAll(parameters.l_all),
+    mSolverType(parameters.ls_type),
+    mKernel(dim, parameters),
+    mRegularizer(parameters.noise),
+    mFeatures(dim, parameters.n_features)
   { }
 
   KernelRegressor::~KernelRegressor(){}
@@ -54,13 +82,79 @@ namespace bayesopt
     const vectord lastX = mData.getLastSampleX();
     vectord newK = computeCrossCorrelation(lastX);
     newK(newK.size()-1) += mRegularizer;   // We add it to the last element
-    utils::cholesky_add_row(mL,newK);
+
+    if (useSparseCorrelation() && 
+	(mSparseL.size() != mData.getNSamples()-1))
+      {
+	// Some samples were removed. The envelope cannot be downdated.
+	computeCholeskyCorrelation();
+      }
+    else if (useSparseCorrelation())
+      {
+	utils::sparse_row row;
+	for (size_t ii = 0; ii < newK.size(); ++ii)
+	  {
+	    if (newK(ii) != 0.0)  row.push_back(std::make_pair(ii,newK(ii)));
+	  }
+	size_t line_error = mSparseL.addRow(row);
+	if (line_error) 
+	  {
+	    throw std::runtime_error("Cholesky decomposition error at line " + 
+				     boost::lexical_cast<std::string>(line_error));
+	  }
+      }
+    else
+      {
+	utils::cholesky_add_row(mL,newK);
+      }
     precomputePrediction(); 
   } // updateSurrogateModel
 
 
+  void KernelRegressor::removeSample(size_t index)
+  {
+    if (!useSparseCorrelation())
+      {
+	utils::cholesky_remove_row(mL,index);
+      }
+  }
+
+
+  vectord KernelRegressor::getLeaveOneOutVariance()
+  {
+    if (useSparseCorrelation())  return vectord();
+
+    const size_t n = mL.size1();
+    matrixd Linv = ublas::identity_matrix<double>(n);
+    inplace_solve(mL,Linv,ublas::lower_tag());
+
+    // diag(K^-1) are the squared norms of the columns of L^-1
+    vectord loo(n);
+    for (size_t ii = 0; ii < n; ++ii)
+      {
+	const double kinv = ublas::inner_prod(ublas::project(column(Linv,ii),
+							     ublas::range(ii,n)),
+					      ublas::project(column(Linv,ii),
+							     ublas::range(ii,n)));
+	loo(ii) = mSigma / kinv;
+      }
+    return loo;
+  }
+
+
   void KernelRegressor::computeCholeskyCorrelation()
   {
+    if (useSparseCorrelation())
+      {
+	size_t line_error = computeSparseCholeskyCorrelation(mSparseL);
+	if (line_error) 
+	  {
+	    throw std::runtime_error("Cholesky decomposition error at line " + 
+				     boost::lexical_cast<std::string>(line_error));
+	  }
+	return;
+      }
+
     size_t nSamples = mData.getNSamples();
     mL.resize(nSamples,nSamples);
   
@@ -75,6 +169,104 @@ namespace bayesopt
       }
   }
 
+  size_t KernelRegressor::computeSparseCholeskyCorrelation(utils::EnvelopeCholesky& L)
+  {
+    std::vector<utils::sparse_row> K;
+    mKernel.computeSparseCorrMatrix(mData.mX,K,mRegularizer);
+    return L.decompose(K);
+  }
+
+
+  bool KernelRegressor::solveCorrelationCG(const matrixd& B, matrixd& X)
+  {
+    const size_t n = mData.getNSamples();
+    vectord diag(n);
+    for (size_t ii = 0; ii < n; ++ii)
+      {
+	diag(ii) = computeSelfCorrelation(mData.mX[ii]) + mRegularizer;
+      }
+
+    CorrProductOp op(mKernel,mData.mX,mRegularizer);
+    const size_t maxIter = (std::min)(CG_MAX_ITERS,10*n);
+    size_t iters = utils::pcg_solve(op,diag,B,X,CG_TOLERANCE,maxIter);
+    if (iters >= maxIter)
+      {
+	FILE_LOG(logDEBUG) << "Conjugate gradient did not converge in " 
+			   << iters << " iterations.";
+	return false;
+      }
+    return true;
+  }
+
+
+  double KernelRegressor::estimateLogDetCorrelation()
+  {
+    randEngine eng(LANCZOS_SEED);
+    CorrProductOp op(mKernel,mData.mX,mRegularizer);
+    return utils::lanczos_logdet(op,mData.getNSamples(),
+				 LANCZOS_PROBES,LANCZOS_STEPS,eng);
+  }
+
+
+  bool KernelRegressor::sampleFunction(randEngine& eng)
+  {
+    mFeatures.resample(eng);
+    if (!mFeatures.setKernel(mKernel))  return false;
+
+    const size_t nf = mFeatures.nFeatures();
+    matrixd A(nf,nf);
+    vectord b(nf);
+    computeFeatureCorrelation(A,b);
+
+    matrixd L(nf,nf);
+    size_t line_error = utils::cholesky_decompose(A,L);
+    if (line_error) 
+      {
+	FILE_LOG(logWARNING) << "Cholesky decomposition error in random "
+			     << "features. Function sample not available.";
+	return false;
+      }
+    utils::cholesky_solve(L,b,ublas::lower());
+    sampleFeatureWeights(L,b,eng);
+    return true;
+  }
+
+
+  void KernelRegressor::computeFeatureCorrelation(matrixd& A, vectord& b)
+  {
+    const size_t nf = mFeatures.nFeatures();
+    A.resize(nf,nf,false);
+    b.resize(nf,false);
+    A = mRegularizer * ublas::identity_matrix<double>(nf);
+    b = zvectord(nf);
+
+    const vectord res = mData.mY - mMean.muTimesFeat();
+    for (size_t ii = 0; ii < mData.getNSamples(); ++ii)
+      {
+	const vectord phi = mFeatures.getFeatures(mData.mX[ii]);
+	A += ublas::outer_prod(phi,phi);
+	b += res(ii) * phi;
+      }
+  }
+
+
+  void KernelRegressor::sampleFeatureWeights(const matrixd& L, 
+					     const vectord& wMean,
+					     randEngine& eng)
+  {
+    randNFloat normal(eng, normalDist(0,1));
+    vectord eps(wMean.size());
+    for (vectord::iterator it = eps.begin(); it != eps.end(); ++it)
+      {
+	*it = normal();
+      }
+
+    // Posterior covariance of the weights is sigma*noise*A^-1
+    inplace_solve(ublas::trans(L),eps,ublas::upper_tag());
+    mSampledW = wMean + std::sqrt(mSigma*mRegularizer) * eps;
+  }
+
+
   matrixd KernelRegressor::computeDerivativeCorrMatrix(int dth_index)
   {
     const size_t nSamples = mData.getNSamples();
@@ -39,7 +39,7 @@ namespace bayesopt
   MCMCSampler::~MCMCSampler()
   {};
 
-  void MCMCSampler::randomJump(vectord &x)
+  double MCMCSampler::randomJump(vectord &x)
   {
     randNFloat sample( mtRandom, normalDist(0,1) );
     FILE_LOG(logERROR) << "Doing random jump.";
@@ -47,7 +47,9 @@ namespace bayesopt
       {
 	*it = sample()*6;
       }
-    FILE_LOG(logERROR) << "Likelihood." << x << " | " << obj->evaluate(x);
+    const double logLik = -obj->evaluate(x);
+    FILE_LOG(logERROR) << "Likelihood." << x << " | " << -logLik;
+    return logLik;
   }
 
   //TODO: Include new algorithms when we add them.
@@ -68,7 +70,7 @@ namespace bayesopt
   }
 
 
-  void MCMCSampler::sliceSample(vectord &x)
+  double MCMCSampler::sliceSample(vectord &x)
   {
     randFloat sample( mtRandom, realUniformDist(0,1) );
     size_t n = x.size();
@@ -77,12 +79,14 @@ namespace bayesopt
 
     utils::randomPerms(perms, mtRandom);
 
+    // Log-likelihood of the current point. After each coordinate
+    // move it is the value of the accepted point.
+    double y_max = -obj->evaluate(x);
     for (size_t i = 0; i<n; ++i)
       {
 	const size_t ind = perms[i];
 	const double sigma = mSigma(ind);
 
-	const double y_max = -obj->evaluate(x);
 	const double y = y_max+std::log(sample());  
 	//y = y_max * sample(), but we are in negative log space
 	//std::cout << y_max << "|||" << y << std::endl;
@@ -115,7 +119,8 @@ namespace bayesopt
 	while (!on_slice)
 	  {
 	    x(ind) = (xr-xl) * sample() + xl;
-	    if (-obj->evaluate(x) < y)
+	    const double logLik = -obj->evaluate(x);
+	    if (logLik < y)
 	      {
 		if      (x(ind) > x_cur)  xr = x(ind);
 		else if (x(ind) < x_cur)  xl = x(ind);
@@ -124,9 +129,11 @@ namespace bayesopt
 	    else
 	      {
 		on_slice = true;
+		y_max = logLik;
 	      }
 	  }
       }
+    return y_max;
   }
 
   //TODO: Include new algorithms when we add them.
@@ -136,18 +143,21 @@ namespace bayesopt
     if (nBurnOut>0) burnOut(Xnext);
 
     mParticles.clear();
+    mLogLik.clear();
     for(size_t i=0; i<nSamples; ++i)  
       {
+	double logLik;
 	try
 	  {
-	    sliceSample(Xnext);
+	    logLik = sliceSample(Xnext);
 	  }
 	catch(std::runtime_error& e)
 	  {
 	    FILE_LOG(logERROR) << e.what();
-	    randomJump(Xnext);
+	    logLik = randomJump(Xnext);
 	  }
 	mParticles.push_back(Xnext);
+	mLogLik.push_back(logLik);
       }
     printParticles();
   }
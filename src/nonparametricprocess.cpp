@@ -27,6 +27,9 @@
 #include "gaussian_process.hpp"
 #include "gaussian_process_ml.hpp"
 #include "gaussian_process_normal.hpp"
+#include "gaussian_process_sparse.hpp"
+#include "gaussian_process_local.hpp"
+#include "random_features_process.hpp"
 #include "student_t_process_jef.hpp"
 #include "student_t_process_nig.hpp"
 
@@ -39,7 +42,7 @@ namespace bayesopt
   NonParametricProcess::NonParametricProcess(size_t dim, bopt_params parameters, 
 					     const Dataset& data, 
 					     MeanModel& mean,
-					     randEngine& eng):
+					     randEngine& /*eng*/):
     mData(data), dim_(dim), mMean(mean), mSigma(parameters.sigma_s)
   {}
 
@@ -66,6 +69,14 @@ namespace bayesopt
       s_ptr = new StudentTProcessJeffreys(dim,parameters,data,mean,eng); 
     else if (!name.compare("sStudentTProcessNIG"))
       s_ptr = new StudentTProcessNIG(dim,parameters,data,mean,eng); 
+    else if (!name.compare("sSparseGaussianProcess"))
+      s_ptr = new SparseGaussianProcess(dim,parameters,data,mean,eng); 
+    else if (!name.compare("sSparseGaussianProcessVFE"))
+      s_ptr = new SparseGaussianProcess(dim,parameters,data,mean,eng,true); 
+    else if (!name.compare("sRandomFeatures"))
+      s_ptr = new RandomFeaturesProcess(dim,parameters,data,mean,eng); 
+    else if (!name.compare("sLocalGaussianProcess"))
+      s_ptr = new LocalGaussianProcess(dim,parameters,data,mean,eng); 
     else
       {
 	throw std::invalid_argument("Surrogate function not supported");
@@ -36,6 +36,9 @@ const double PRIOR_ALPHA     = 1.0;
 const double PRIOR_BETA      = 1.0;
 const double DEFAULT_SIGMA   = 1.0;
 const double DEFAULT_NOISE   = 1e-6;
+const size_t DEFAULT_INDUCING = 100;
+const size_t DEFAULT_FEATURES = 256;
+const size_t DEFAULT_NEIGHBOURS = 50;
 
 /* Algorithm parameters */
 const size_t DEFAULT_ITERATIONS         = 190;
@@ -91,6 +94,24 @@ const char* score2str(score_type name)
     }
 }
 
+linsolve_type str2linsolve(const char* name)
+{
+  if      (!strcmp(name,"LS_CHOLESKY") || !strcmp(name,"cholesky")) return LS_CHOLESKY;
+  else if (!strcmp(name,"LS_CG")       || !strcmp(name,"cg"))       return LS_CG;
+  else return LS_ERROR;
+}
+
+const char* linsolve2str(linsolve_type name)
+{
+  switch(name)
+    {
+    case LS_CHOLESKY: return "LS_CHOLESKY"; 
+    case LS_CG:       return "LS_CG"; 
+    case LS_ERROR:
+    default: return "ERROR!";
+    }
+}
+
 
 void set_kernel(bopt_params* params, const char* name)
 {
@@ -127,6 +148,16 @@ void set_save_file(bopt_params* params, const char* name)
   strcpy(params->save_filename, name);
 };
 
+void set_journal_file(bopt_params* params, const char* name)
+{
+  strcpy(params->journal_filename, name);
+};
+
+void set_trace_file(bopt_params* params, const char* name)
+{
+  strcpy(params->trace_filename, name);
+};
+
 void set_learning(bopt_params* params, const char* name)
 {
   params->l_type = str2learn(name);
@@ -137,6 +168,11 @@ void set_score(bopt_params* params, const char* name)
   params->sc_type = str2score(name);
 };
 
+void set_linsolve(bopt_params* params, const char* name)
+{
+  params->ls_type = str2linsolve(name);
+};
+
 bopt_params initialize_parameters_to_default(void)
 {
   kernel_parameters kernel;
@@ -146,6 +182,7 @@ bopt_params initialize_parameters_to_default(void)
   kernel.hp_mean[0] = KERNEL_THETA;
   kernel.hp_std[0]  = KERNEL_SIGMA;
   kernel.n_hp       = 1;
+  kernel.n_groups   = 0;
   
   mean_parameters mean;
   mean.name = new char[128];
@@ -161,10 +198,15 @@ bopt_params initialize_parameters_to_default(void)
   params.n_iterations       = DEFAULT_ITERATIONS;
   params.n_inner_iterations = DEFAULT_INNER_EVALUATIONS;
   params.n_init_samples     = DEFAULT_INIT_SAMPLES;
+  params.n_eval_threads     = 1;
   params.n_iter_relearn     = DEFAULT_ITERATIONS_RELEARN;
+  params.pipelined_relearn  = 0;
+  params.n_max_samples      = 0;
+  params.evict_method       = 1;
 
   params.init_method      =  1;
   params.random_seed      = -1;
+  params.num_threads      =  1;
 
   params.verbose_level = DEFAULT_VERBOSE;
   params.log_filename  = new char[128];
@@ -172,9 +214,15 @@ bopt_params initialize_parameters_to_default(void)
 
   params.load_save_flag = 0;
   params.load_filename = new char[128];
-  strcpy(params.log_filename,"bayesopt.dat");
+  strcpy(params.load_filename,"bayesopt.dat");
   params.save_filename = new char[128];
-  strcpy(params.log_filename,"bayesopt.dat");
+  strcpy(params.save_filename,"bayesopt.dat");
+
+  params.journal_mode = 0;
+  params.journal_filename = new char[128];
+  strcpy(params.journal_filename,"bayesopt.jrn");
+  params.trace_filename = new char[128];
+  strcpy(params.trace_filename,"");
 
   params.surr_name = new char[128];
   //  strcpy(params.surr_name,"sStudentTProcessNIG");
@@ -184,13 +232,20 @@ bopt_params initialize_parameters_to_default(void)
   params.noise   = DEFAULT_NOISE;
   params.alpha   = PRIOR_ALPHA;
   params.beta    = PRIOR_BETA;
+  params.n_inducing = DEFAULT_INDUCING;
+  params.n_features = DEFAULT_FEATURES;
+  params.n_neighbours = DEFAULT_NEIGHBOURS;
 
   params.l_all   = 0;
+  params.l_groups = 0;
   params.l_type  = L_EMPIRICAL;
   params.sc_type = SC_MAP;
+  params.ls_type = LS_CHOLESKY;
 
   params.epsilon = 0.0;
   params.force_jump = 20;
+  params.jump_repeated = 0;
+  params.tr_length = 0.0;
   
   params.crit_name = new char[128];
   strcpy(params.crit_name,"cEI");
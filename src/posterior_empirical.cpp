@@ -21,20 +21,23 @@
 */
 
 #include "log.hpp"
+#include "randgen.hpp"
 #include "inneroptimization.hpp"
 #include "posterior_empirical.hpp"
 
 namespace bayesopt
 {
 
+  // Number of random assignments of dimensions to additive groups
+  const size_t GROUP_TRIALS = 20;
 
   EmpiricalBayes::EmpiricalBayes(size_t dim, bopt_params parameters, 
 				 randEngine& eng):
-    PosteriorModel(dim,parameters,eng)
+    PosteriorModel(dim,parameters,eng), mEngine(eng.split(STREAM_LEARNING))
   {
     // Configure Surrogate and Criteria Functions
-    setSurrogateModel(eng);
-    setCriteria(eng);
+    setSurrogateModel(mModelEngine);
+    setCriteria(mCriteriaEngine);
 
     // Seting kernel optimization
     size_t nhp = mGP->nHyperParameters();
@@ -63,6 +66,8 @@ namespace bayesopt
   void EmpiricalBayes::updateHyperParameters()
   {
     FILE_LOG(logDEBUG) << "------ Optimizing hyperparameters ------";
+    if (mParameters.l_groups)  learnInputGroups();
+
     vectord optimalTheta = mGP->getHyperParameters();
 
     FILE_LOG(logDEBUG) << "Initial hyper parameters: " << optimalTheta;
@@ -72,6 +77,48 @@ namespace bayesopt
   };
 
 
+  void EmpiricalBayes::learnInputGroups()
+  {
+    vecOfGroups groups;
+    if (!mGP->getInputGroups(groups) || (groups.size() < 2))  return;
+
+    const vectord theta = mGP->getHyperParameters();
+    vecOfGroups bestGroups = groups;
+    double bestScore = mGP->evaluate(theta);
+
+    std::vector<size_t> dims(mDims);
+    for (size_t i = 0; i < mDims; ++i)  dims[i] = i;
+
+    for (size_t trial = 0; trial < GROUP_TRIALS; ++trial)
+      {
+	// Random permutation of the dimensions, keeping the group sizes
+	for (size_t i = mDims-1; i > 0; --i)
+	  {
+	    randInt sample(mEngine, intUniformDist(0,static_cast<int>(i)));
+	    std::swap(dims[i],dims[sample()]);
+	  }
+
+	size_t d = 0;
+	for (size_t g = 0; g < groups.size(); ++g)
+	  {
+	    for (size_t i = 0; i < groups[g].size(); ++i)  
+	      groups[g][i] = dims[d++];
+	  }
+
+	mGP->setInputGroups(groups);
+	const double score = mGP->evaluate(theta);
+	if (score < bestScore)
+	  {
+	    bestScore = score;
+	    bestGroups = groups;
+	  }
+      }
+    mGP->setInputGroups(bestGroups);
+    mGP->setHyperParameters(theta);
+    FILE_LOG(logDEBUG) << "Learned input groups. Score: " << bestScore;
+  };
+
+
   void EmpiricalBayes::setSurrogateModel(randEngine& eng)
   {
     mGP.reset(NonParametricProcess::create(mDims,mParameters,
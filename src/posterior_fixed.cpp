@@ -32,8 +32,8 @@ namespace bayesopt
     PosteriorModel(dim,parameters,eng)
   {
     // Configure Surrogate and Criteria Functions
-    setSurrogateModel(eng);
-    setCriteria(eng);
+    setSurrogateModel(mModelEngine);
+    setCriteria(mCriteriaEngine);
   }
 
   PosteriorFixed::~PosteriorFixed()
@@ -20,26 +20,53 @@
 ------------------------------------------------------------------------
 */
 #include "log.hpp"
+#include "threadpool.hpp"
 #include "posterior_mcmc.hpp"
 
 namespace bayesopt
 {
+  namespace
+  {
+    /** Fits or updates the particles [begin,end). Each particle has
+	its own matrices, so they can be computed in parallel. */
+    class ParticlesTask: public utils::RangeTask
+    {
+    public:
+      ParticlesTask(MCMCModel::GPVect& gp, bool update): 
+	mGP(gp), mUpdate(update) {};
+
+      void operator()(size_t begin, size_t end)
+      {
+	for (size_t i = begin; i < end; ++i)
+	  {
+	    if (mUpdate) mGP[i].updateSurrogateModel();
+	    else         mGP[i].fitSurrogateModel();
+	  }
+      };
+
+    private:
+      MCMCModel::GPVect& mGP;
+      bool mUpdate;
+    };
+  }
+
   MCMCModel::MCMCModel(size_t dim, bopt_params parameters, 
 		       randEngine& eng):
-    PosteriorModel(dim,parameters,eng), nParticles(10)
+    PosteriorModel(dim,parameters,eng), nParticles(10),
+    mSamplerEngine(eng.split(STREAM_MCMC))
   {
     //TODO: Take nParticles from parameters
     
     // Configure Surrogate and Criteria Functions
-    setSurrogateModel(eng);
-    setCriteria(eng);
+    setSurrogateModel(mModelEngine);
+    setCriteria(mCriteriaEngine);
 
     // Seting MCMC for kernel hyperparameters...
     // We use the first GP as the "walker" to get the particles. Then,
     // we will use a whole vector of GPs to avoid recomputing the
     // kernel matrices after every data point.
     size_t nhp = mGP[0].nHyperParameters();
-    kSampler.reset(new MCMCSampler(&mGP[0],nhp,eng));
+    kSampler.reset(new MCMCSampler(&mGP[0],nhp,mSamplerEngine));
 
     kSampler->setNParticles(nParticles);
     kSampler->setNBurnOut(100);
@@ -65,12 +92,32 @@ namespace bayesopt
   };
 
 
+  void MCMCModel::fitSurrogateModel()
+  { 
+    ParticlesTask fit(mGP,false);
+    utils::parallelFor(0,mGP.size(),1,fit);
+  }
+
+  void MCMCModel::updateSurrogateModel()
+  {     
+    ParticlesTask update(mGP,true);
+    utils::parallelFor(0,mGP.size(),1,update);
+  }
+
+
   void MCMCModel::setSurrogateModel(randEngine& eng)
   {
+    // The particles are fitted in parallel, so each one has its own
+    // stream. The engines are not moved after this point.
+    mGPEngines.clear();
+    for(size_t i = 0; i<nParticles; ++i)
+      {
+	mGPEngines.push_back(eng.split(taskStream(STREAM_MODEL,i)));
+      }
     for(size_t i = 0; i<nParticles; ++i)
       {
 	mGP.push_back(NonParametricProcess::create(mDims,mParameters,
-						   mData,mMean,eng));
+						   mData,mMean,mGPEngines[i]));
       } 
   } // setSurrogateModel
 
@@ -78,10 +125,15 @@ namespace bayesopt
   {
     CriteriaFactory mCFactory;
 
+    mCritEngines.clear();
+    for(size_t i = 0; i<nParticles; ++i)
+      {
+	mCritEngines.push_back(eng.split(taskStream(STREAM_CRITERIA,i)));
+      }
     for(size_t i = 0; i<nParticles; ++i)
       {
 	mCrit.push_back(mCFactory.create(mParameters.crit_name,&mGP[i]));
-	mCrit[i].setRandomEngine(eng);
+	mCrit[i].setRandomEngine(mCritEngines[i]);
 
 	if (mCrit[i].nParameters() == mParameters.n_crit_params)
 	  {
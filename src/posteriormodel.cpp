@@ -45,8 +45,17 @@ namespace bayesopt
 
   PosteriorModel::PosteriorModel(size_t dim, bopt_params parameters, 
 				 randEngine& eng):
-    mParameters(parameters), mDims(dim), mMean(dim, parameters)
-  {} 
+    mParameters(parameters), mDims(dim), mMean(dim, parameters),
+    mModelEngine(eng.split(STREAM_MODEL)), 
+    mCriteriaEngine(eng.split(STREAM_CRITERIA))
+  {
+    if ((mParameters.n_max_samples > 0) && 
+	(mParameters.n_max_samples <= mParameters.n_init_samples))
+      {
+	throw std::invalid_argument("The maximum number of samples must "
+				    "be larger than the initial samples.");
+      }
+  } 
 
   PosteriorModel::~PosteriorModel()
   { } // Default destructor
@@ -55,9 +64,17 @@ namespace bayesopt
   void PosteriorModel::setSamples(const matrixd &x, const vectord &y)
   { 
     mData.setSamples(x,y);  
+    trimSamples();
     mMean.setPoints(mData.mX);  //Because it expects a vecOfvec instead of a matrixd 
   }
 
+  void PosteriorModel::setSamples(const vecOfvec &x, const vectord &y)
+  { 
+    mData.setSamples(x,y);  
+    trimSamples();
+    mMean.setPoints(mData.mX);
+  }
+
   void PosteriorModel::setSample(const vectord &x, double y)
   { 
     matrixd xx(1,x.size());  vectord yy(1);
@@ -67,7 +84,73 @@ namespace bayesopt
   }
 
   void PosteriorModel::addSample(const vectord &x, double y)
-  {  mData.addSample(x,y); mMean.addNewPoint(x);  };
+  {  
+    mData.addSample(x,y); mMean.addNewPoint(x);  
+
+    if ((mParameters.n_max_samples > 0) && 
+	(mData.getNSamples() > mParameters.n_max_samples))
+      {
+	const size_t index = selectEvictedSample();
+	FILE_LOG(logDEBUG) << "Dataset full. Removing sample: " 
+			   << mData.getSampleX(index);
+	removeSurrogateSample(index);
+	mData.removeSample(index); 
+	mMean.removePoint(index);
+      }
+  };
+
+  void PosteriorModel::trimSamples()
+  {
+    const size_t nMax = mParameters.n_max_samples;
+    const size_t n = mData.getNSamples();
+    if ((nMax == 0) || (n <= nMax))  return;
+
+    FILE_LOG(logINFO) << "Dataset full. Keeping " << nMax << " of " 
+		      << n << " samples.";
+
+    // The newest samples are kept, and the incumbent replaces the
+    // oldest of them if it is not among them.
+    const size_t best = mData.getIndexAtMinimum();
+    size_t first = n - nMax;
+    vecOfvec x;
+    vectord y(nMax);
+    if (best < first)
+      {
+	x.push_back(mData.mX[best]);
+	y(0) = mData.mY(best);
+	++first;
+      }
+    for (size_t i = first; i < n; ++i)
+      {
+	y(x.size()) = mData.mY(i);
+	x.push_back(mData.mX[i]);
+      }
+    mData.setSamples(x,y);
+  }
+
+  size_t PosteriorModel::selectEvictedSample()
+  {
+    // The last sample is new, so the surrogate only knows the others.
+    const size_t nOld = mData.getNSamples() - 1;
+    const size_t best = mData.getIndexAtMinimum();
+
+    vectord loo;
+    if (mParameters.evict_method == 2)  loo = getLeaveOneOutVariance();
+
+    if (loo.size() == nOld)
+      {
+	size_t index = (best == 0) ? 1 : 0;
+	for (size_t ii = index+1; ii < nOld; ++ii)
+	  {
+	    if ((ii != best) && (loo(ii) < loo(index)))  index = ii;
+	  }
+	return index;
+      }
+    else  // Oldest
+      {
+	return (best == 0) ? 1 : 0;
+      }
+  };
 
 
 } //namespace bayesopt
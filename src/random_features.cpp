@@ -0,0 +1,88 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <stdexcept>
+#include <boost/math/constants/constants.hpp>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include "random_features.hpp"
+
+namespace bayesopt
+{
+
+  namespace ublas = boost::numeric::ublas;
+
+  RandomFeatures::RandomFeatures(size_t dim, size_t nFeatures):
+    mDim(dim), mNFeatures(nFeatures), mZ(nFeatures,dim), mU(nFeatures),
+    mPhase(nFeatures), mW(nFeatures,dim)
+  {
+    if (mNFeatures == 0)
+      {
+	throw std::invalid_argument("Number of random features must be "
+				    "greater than zero");
+      }
+  }
+
+
+  void RandomFeatures::resample(randEngine& eng)
+  {
+    const double twopi = boost::math::constants::two_pi<double>();
+    randNFloat normal(eng, normalDist(0,1));
+    randFloat uniform(eng, realUniformDist(0,1));
+
+    for (size_t ii = 0; ii < mNFeatures; ++ii)
+      {
+	for (size_t jj = 0; jj < mDim; ++jj)
+	  {
+	    mZ(ii,jj) = normal();
+	  }
+	// Avoid exactly 0, where the inverse gamma diverges
+	mU(ii) = (std::max)(uniform(),1e-12);
+	mPhase(ii) = twopi * uniform();
+      }
+  }
+
+
+  bool RandomFeatures::setKernel(KernelModel& kernel)
+  {
+    vectord omega(mDim);
+    for (size_t ii = 0; ii < mNFeatures; ++ii)
+      {
+	const vectord z = ublas::row(mZ,ii);
+	if (!kernel.spectralSample(z,mU(ii),omega))  return false;
+	ublas::row(mW,ii) = omega;
+      }
+    return true;
+  }
+
+
+  vectord RandomFeatures::getFeatures(const vectord& x) const
+  {
+    const double scale = std::sqrt(2.0/mNFeatures);
+    vectord phi = ublas::prod(mW,x) + mPhase;
+    for (vectord::iterator it = phi.begin(); it != phi.end(); ++it)
+      {
+	*it = scale * std::cos(*it);
+      }
+    return phi;
+  }
+
+} //namespace bayesopt
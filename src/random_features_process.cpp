@@ -0,0 +1,159 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <stdexcept>
+#include <boost/lexical_cast.hpp>
+#include "ublas_trace.hpp"
+#include "random_features_process.hpp"
+
+namespace bayesopt
+{
+
+  namespace ublas = boost::numeric::ublas;
+
+  RandomFeaturesProcess::RandomFeaturesProcess(size_t dim, bopt_params params, 
+					       const Dataset& data, MeanModel& mean,
+					       randEngine& eng):
+    ConditionalBayesProcess(dim, params, data, mean, eng)
+  {
+    mSigma = params.sigma_s;
+    mFeatures.resample(eng);
+  }  // Constructor
+
+
+  RandomFeaturesProcess::~RandomFeaturesProcess()
+  {
+  } // Default destructor
+
+
+  void RandomFeaturesProcess::fitSurrogateModel()
+  {
+    updateFeatureMap();
+    computeFeatureCorrelation(mA,mB);
+    precomputePrediction();
+  }
+
+
+  void RandomFeaturesProcess::updateSurrogateModel()
+  {
+    const vectord lastX = mData.getLastSampleX();
+    const vectord phi = mFeatures.getFeatures(lastX);
+    mA += ublas::outer_prod(phi,phi);
+    mB += (mData.getLastSampleY() - mMean.muTimesFeat(lastX)) * phi;
+    precomputePrediction();
+  } // updateSurrogateModel
+
+
+  void RandomFeaturesProcess::removeSample(size_t index)
+  {
+    const vectord x = mData.getSampleX(index);
+    const vectord phi = mFeatures.getFeatures(x);
+    mA -= ublas::outer_prod(phi,phi);
+    mB -= (mData.getSampleY(index) - mMean.muTimesFeat(x)) * phi;
+  }
+
+  bool RandomFeaturesProcess::sampleFunction(randEngine& eng)
+  {
+    sampleFeatureWeights(mLA,mWMean,eng);
+    return true;
+  }
+
+
+  double RandomFeaturesProcess::negativeTotalLogLikelihood()
+  {
+    // In this case it is equivalent.
+    return negativeLogLikelihood();
+  }
+
+
+  double RandomFeaturesProcess::negativeLogLikelihood()
+  {
+    updateFeatureMap();
+
+    const size_t n = mData.getNSamples();
+    const size_t nf = mFeatures.nFeatures();
+    matrixd A(nf,nf);
+    vectord b(nf);
+    computeFeatureCorrelation(A,b);
+
+    matrixd L(nf,nf);
+    utils::cholesky_decompose(A,L);
+    inplace_solve(L,b,ublas::lower_tag());
+
+    // Woodbury: |Phi Phi' + sn I| = sn^(n-D) |A|
+    const vectord res = mData.mY - mMean.muTimesFeat();
+    double loglik = (ublas::inner_prod(res,res) - ublas::inner_prod(b,b))
+      / (2*mSigma*mRegularizer);
+    loglik += utils::log_trace(L);
+    loglik += 0.5 * (static_cast<double>(n) - static_cast<double>(nf)) 
+      * std::log(mRegularizer);
+    return loglik;
+  }
+
+
+  void RandomFeaturesProcess::predict(const vectord &query,
+				      ProbabilityDistribution& d) const
+  {
+    const vectord phi = mFeatures.getFeatures(query);
+
+    double basisPred = mMean.muTimesFeat(query);
+    double yPred = basisPred + ublas::inner_prod(phi,mWMean);
+
+    vectord v(phi);
+    inplace_solve(mLA,v,ublas::lower_tag());
+    double sPred = sqrt(mSigma*mRegularizer*ublas::inner_prod(v,v));
+    
+    d.setMeanAndStd(yPred,sPred);
+  }
+
+  ProbabilityDistribution* RandomFeaturesProcess::createPrediction() const
+  {
+    return new GaussianDistribution();
+  }
+
+
+  void RandomFeaturesProcess::precomputePrediction()
+  {
+    const size_t nf = mFeatures.nFeatures();
+    mLA.resize(nf,nf,false);
+    size_t line_error = utils::cholesky_decompose(mA,mLA);
+    if (line_error) 
+      {
+	throw std::runtime_error("Cholesky decomposition error at line " + 
+				 boost::lexical_cast<std::string>(line_error));
+      }
+
+    mWMean = mB;
+    utils::cholesky_solve(mLA,mWMean,ublas::lower());
+  }
+
+
+  void RandomFeaturesProcess::updateFeatureMap()
+  {
+    if (!mFeatures.setKernel(mKernel))
+      {
+	throw std::invalid_argument("Kernel not supported by random features. "
+				    "Use a SE or Matern kernel.");
+      }
+  }
+	
+} //namespace bayesopt
@@ -4,8 +4,7 @@
 namespace bayesopt
 {
 
-  StudentTDistribution::StudentTDistribution(randEngine& eng): 
-    ProbabilityDistribution(eng), d_(2)
+  StudentTDistribution::StudentTDistribution(): d_(2)
   {
     mean_ = 0.0;  std_ = 1.0; dof_ = 2;
   }
@@ -37,11 +36,11 @@ namespace bayesopt
   }  // negativeProbabilityOfImprovement
 
 
-  double StudentTDistribution::sample_query()
+  double StudentTDistribution::sample_query(randEngine& eng)
   { 
     double n = static_cast<double>(dof_);
-    randNFloat normal(mtRandom,normalDist(mean_,std_));
-    randGFloat gamma(mtRandom,gammaDist(n/2.0));
+    randNFloat normal(eng,normalDist(mean_,std_));
+    randGFloat gamma(eng,gammaDist(n/2.0));
     return normal() / sqrt(2*gamma()/n);
   }  // sample_query
 
@@ -30,16 +30,14 @@ namespace bayesopt
 						   const Dataset& data, 
 						   MeanModel& mean,
 						   randEngine& eng):
-    HierarchicalGaussianProcess(dim, params, data, mean, eng)
+    HierarchicalGaussianProcess(dim, params, data, mean, eng), mDof(2)
   {
-    d_ = new StudentTDistribution(eng);
   }  // Constructor
 
 
 
   StudentTProcessJeffreys::~StudentTProcessJeffreys()
   {
-    delete d_;
   } // Default destructor
 
 
@@ -52,29 +50,29 @@ namespace bayesopt
   }
 
 
-  ProbabilityDistribution* 
-  StudentTProcessJeffreys::prediction(const vectord &query )
+  void StudentTProcessJeffreys::predict(const vectord &query,
+					ProbabilityDistribution& d) const
   {
-    clock_t start = clock();
     double kq = computeSelfCorrelation(query);
-    //    vectord kn = computeCrossCorrelation(query);
-    mKernel.computeCrossCorrelation(mData.mX,query,mKn);
+    vectord kn = computeCrossCorrelation(query);
     vectord phi = mMean.getFeatures(query);
   
-    //    vectord v(mKn);
-    inplace_solve(mL,mKn,ublas::lower_tag());
+    inplace_solve(mL,kn,ublas::lower_tag());
 
-    vectord rho = phi - prod(mKn,mKF);
-
-    //    vectord rho(rq);
+    vectord rho = phi - prod(kn,mKF);
     inplace_solve(mL2,rho,ublas::lower_tag());
     
-    double yPred = inner_prod(phi,mWML) + inner_prod(mKn,mAlphaF);
-    double sPred = sqrt( mSigma * (kq - inner_prod(mKn,mKn) 
+    double yPred = inner_prod(phi,mWML) + inner_prod(kn,mAlphaF);
+    double sPred = sqrt( mSigma * (kq - inner_prod(kn,kn) 
 				   + inner_prod(rho,rho)));
 
-    d_->setMeanAndStd(yPred,sPred);
-    return d_;
+    d.setMeanAndStd(yPred,sPred);
+    static_cast<StudentTDistribution&>(d).setDof(mDof);
+  }
+
+  ProbabilityDistribution* StudentTProcessJeffreys::createPrediction() const
+  {
+    return new StudentTDistribution();
   }
 
   void StudentTProcessJeffreys::precomputePrediction()
@@ -82,8 +80,6 @@ namespace bayesopt
     size_t n = mData.getNSamples();
     size_t p = mMean.nFeatures();
 
-    mKn.resize(n);
-
     mKF = trans(mMean.mFeatM);
     inplace_solve(mL,mKF,ublas::lower_tag());
 
@@ -101,7 +97,7 @@ namespace bayesopt
     inplace_solve(mL,mAlphaF,ublas::lower_tag());
     mSigma = inner_prod(mAlphaF,mAlphaF)/(n-p);
     
-    d_->setDof(n-p);  
+    mDof = n-p;  
   }
 
 } //namespace bayesopt
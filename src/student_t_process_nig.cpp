@@ -40,7 +40,7 @@ namespace bayesopt
     HierarchicalGaussianProcess(dim,params,data, mean, eng),
     mAlpha(params.alpha), mBeta (params.beta), 
     mW0(params.mean.n_coef), mInvVarW(params.mean.n_coef), 
-    mD(params.mean.n_coef,params.mean.n_coef)
+    mD(params.mean.n_coef,params.mean.n_coef), mDof(2)
   {  
     mW0 = utils::array2vector(params.mean.coef_mean,params.mean.n_coef);
     for (size_t ii = 0; ii < params.mean.n_coef; ++ii)
@@ -48,18 +48,17 @@ namespace bayesopt
 	double varii = params.mean.coef_std[ii] * params.mean.coef_std[ii];
 	mInvVarW(ii) = 1/varii;
       }
-     d_ = new StudentTDistribution(eng);
   }  // Constructor
 
 
 
   StudentTProcessNIG::~StudentTProcessNIG()
   {
-    delete d_;
   } // Default destructor
 
 
-  ProbabilityDistribution* StudentTProcessNIG::prediction(const vectord &query)
+  void StudentTProcessNIG::predict(const vectord &query,
+				   ProbabilityDistribution& d) const
   {
     double kq = computeSelfCorrelation(query);
     vectord kn = computeCrossCorrelation(query);
@@ -83,31 +82,34 @@ namespace bayesopt
       }
 					
 
-    d_->setMeanAndStd(yPred,sPred);
-    return d_;
+    d.setMeanAndStd(yPred,sPred);
+    static_cast<StudentTDistribution&>(d).setDof(mDof);
+  }
+
+  ProbabilityDistribution* StudentTProcessNIG::createPrediction() const
+  {
+    return new StudentTDistribution();
   }
 
 
   double StudentTProcessNIG::negativeLogLikelihood()
   {
-    matrixd KK = computeCorrMatrix();
-    const size_t n = KK.size1();
-    const size_t p = mMean.nFeatures();
+    const matrixd K = computeCorrMatrix();
+    const size_t n = K.size1();
     const size_t nalpha = (n+2*mAlpha);
 
     vectord v0 = mData.mY - prod(trans(mMean.mFeatM),mW0);
-    matrixd WW = zmatrixd(p,p);  //TODO: diagonal matrix
-    utils::add_to_diagonal(WW,mInvVarW);
-    matrixd FW = prod(trans(mMean.mFeatM),WW);
-    KK += prod(FW,mMean.mFeatM);
-    matrixd BB(n,n);
-    utils::cholesky_decompose(KK,BB);
-    inplace_solve(BB,v0,ublas::lower_tag());
-    double zz = inner_prod(v0,v0);
+    matrixd L(n,n);
+    utils::cholesky_decompose(K,L);
+    matrixd KF(trans(mMean.mFeatM));
+    inplace_solve(L,KF,ublas::lower_tag());
+
+    double zz;
+    const double logtraceBB = computeWeightedMarginal(L,KF,mInvVarW,v0,zz);
     double sigmaMap = (mBeta/mAlpha + zz)/nalpha;
 
     double lik = nalpha/2 * std::log(1+zz/(2*mBeta*sigmaMap));
-    lik += utils::log_trace(BB);
+    lik += logtraceBB;
     lik += n/2 * std::log(sigmaMap);
     return lik;
   }
@@ -135,18 +137,11 @@ namespace bayesopt
     mVf = mData.mY - prod(trans(mMean.mFeatM),mWMap);
     inplace_solve(mL,mVf,ublas::lower_tag());
 
+    // Reuse mL and mKF instead of factorizing K + F'WF from scratch
     vectord v0 = mData.mY - prod(trans(mMean.mFeatM),mW0);
-    //TODO: check for "cheaper" version
-    //matrixd KK = prod(mL,trans(mL));
-    matrixd KK = computeCorrMatrix();
-    matrixd WW = zmatrixd(p,p);  //TODO: diagonal matrix
-    utils::add_to_diagonal(WW,mInvVarW);
-    const matrixd FW = prod(trans(mMean.mFeatM),WW);
-    KK += prod(FW,mMean.mFeatM);
-    matrixd BB(n,n);
-    utils::cholesky_decompose(KK,BB);
-    inplace_solve(BB,v0,ublas::lower_tag());
-    mSigma = (mBeta/mAlpha + inner_prod(v0,v0))/(n+2*mAlpha);
+    double zz;
+    computeWeightedMarginal(mL,mKF,mInvVarW,v0,zz);
+    mSigma = (mBeta/mAlpha + zz)/(n+2*mAlpha);
     
     int dof = static_cast<int>(n+2*mAlpha);
     
@@ -163,7 +158,7 @@ namespace bayesopt
 			   << "Forcing Dof <= num of points.";
       }
 
-    d_->setDof(dof);  
+    mDof = dof;  
   }
 
 } //namespace bayesopt
@@ -250,6 +250,40 @@ int main_(int argc, char * argv[] )
               << std::endl;
   }
 
+  {
+    // remove a row from a dense decomposition (downdate)
+    ublas::matrix<DBL, ORI> A (size, size);
+    ublas::matrix<DBL, ORI> T (size, size);
+    ublas::matrix<DBL, ORI> L (size, size);
+
+    T = ublas::zero_matrix<DBL>(size, size);
+    fill_symm(T);
+    A = ublas::prod(T, trans(T));
+    cholesky_decompose(A, L);
+
+    const size_t index = size / 2;
+    ublas::matrix<DBL, ORI> B (size-1, size-1);
+    for (size_t i = 0; i < size-1; ++i)
+      for (size_t j = 0; j < size-1; ++j)
+	B(i,j) = A(i + (i >= index), j + (j >= index));
+    ublas::matrix<DBL, ORI> LB (size-1, size-1);
+
+    t1.restart();
+    size_t res = cholesky_decompose(B, LB);
+    de = t1.elapsed();
+
+    t1.restart();
+    cholesky_remove_row(L, index);
+    sv = t1.elapsed();
+
+    std::cout << res << ": " 
+              << ublas::norm_inf(L-LB) << " "
+              << " (deco: " << de << " sec)"
+              << " (remove row: " << sv << " sec)"
+              << " " << size
+              << std::endl;
+  }
+
   return EXIT_SUCCESS;
 }
 
@@ -0,0 +1,113 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2013 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <boost/cstdint.hpp>
+#include "datafile.hpp"
+
+int main()
+{
+  const std::string filename = "testdatafile.dat";
+  const size_t n = 1000, dim = 3;
+
+  vecOfvec x(n, vectord(dim));
+  vectord y(n);
+  for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = 0; j < dim; ++j)  x[i](j) = i + 0.1*j;
+      y(i) = -static_cast<double>(i);
+    }
+
+  bayesopt::utils::ObservationFile::save(filename,x,y);
+  bayesopt::utils::ObservationFile data(filename);
+
+  int errors = 0;
+  if ((data.getNSamples() != n) || (data.getNDims() != dim)) ++errors;
+  const double* px = data.getInputs();
+  const double* py = data.getOutputs();
+  for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = 0; j < dim; ++j)  if (px[i*dim+j] != x[i](j)) ++errors;
+      if (py[i] != y(i))  ++errors;
+    }
+
+  // Header whose size overflows to the size of an empty file
+  bayesopt::utils::ObservationFile::save(filename,vecOfvec(),vectord());
+  {
+    std::fstream fs(filename.c_str(), 
+		    std::ios::in | std::ios::out | std::ios::binary);
+    const boost::uint64_t sizes[2] = {boost::uint64_t(1) << 61, 7};
+    fs.seekp(16);
+    fs.write(reinterpret_cast<const char*>(sizes), sizeof(sizes));
+  }
+  try
+    {
+      bayesopt::utils::ObservationFile corrupted(filename);
+      ++errors;
+    }
+  catch (std::runtime_error& e)
+    {
+    }
+  std::remove(filename.c_str());
+
+  // Journal replayed only by the same domain
+  const std::string journalname = "testdatafile.jrn";
+  bayesopt::utils::JournalDomain domain;
+  domain.nInputDims = domain.nDims = dim;
+  domain.lower = zvectord(dim);
+  domain.upper = svectord(dim,2.0);
+  {
+    bayesopt::utils::ObservationJournal journal;
+    journal.open(journalname,domain,false);
+    for (size_t i = 0; i < 10; ++i)
+      {
+	journal.append(i,bayesopt::utils::JOURNAL_CRITERIA,2.0*x[i],x[i],y(i));
+      }
+  }
+  vecOfvec xj;  vectord yj;  size_t nIter;
+  if (!bayesopt::utils::ObservationJournal::read(journalname,domain,
+						 xj,yj,nIter) ||
+      (xj.size() != 10) || (nIter != 10) || (xj[9](2) != x[9](2)) ||
+      (yj(9) != y(9)))
+    {
+      ++errors;
+    }
+  domain.upper(0) = 3.0;
+  try
+    {
+      bayesopt::utils::ObservationJournal::read(journalname,domain,
+						xj,yj,nIter);
+      ++errors;
+    }
+  catch (std::runtime_error& e)
+    {
+    }
+  std::remove(journalname.c_str());
+
+  std::cout << "Samples: " << data.getNSamples() 
+	    << " | Dims: " << data.getNDims() 
+	    << " | Errors: " << errors << std::endl;
+  return errors;
+}
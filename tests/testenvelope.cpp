@@ -0,0 +1,109 @@
+/** \file testenvelope.cpp \brief test sparse (envelope) Cholesky decomposition */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <ctime>
+#include <iostream>
+#include "randgen.hpp"
+#include "ublas_cholesky.hpp"
+#include "ublas_trace.hpp"
+#include "envelope_cholesky.hpp"
+#include "cellgrid.hpp"
+#include "kernels/kernel_wendland.hpp"
+
+using namespace bayesopt;
+namespace ublas = boost::numeric::ublas;
+
+int main(int argc, char * argv[])
+{
+  size_t n = 500;
+  if (argc > 1) n = ::atoi(argv[1]);
+  const size_t dim = 2;
+  const double radius = 0.1;
+  const double nugget = 1e-6;
+  const double ell = dim/2 + 2;  // Wendland phi_{d,1}
+
+  randEngine eng;
+  randFloat sample(eng, realUniformDist(0,1));
+  vecOfvec X(n, vectord(dim));
+  vectord y(n);
+  for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = 0; j < dim; ++j) X[i](j) = sample();
+      y(i) = sample();
+    }
+
+  // Dense and sparse correlation matrices
+  clock_t start = clock();
+  matrixd K(n,n);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+      K(i,j) = wendlandFunction(norm_2(X[i]-X[j])/radius,ell,1) 
+	+ ((i==j) ? nugget : 0.0);
+  matrixd L(n,n);
+  utils::cholesky_decompose(K,L);
+  vectord yd(y);
+  inplace_solve(L,yd,ublas::lower_tag());
+  double dense_time = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+  start = clock();
+  utils::CellGrid grid(svectord(dim,radius));
+  std::vector<size_t> cand;
+  std::vector<utils::sparse_row> rows(n);
+  for (size_t i = 0; i < n-1; ++i)
+    {
+      grid.query(X[i],cand);
+      for (size_t k = 0; k < cand.size(); ++k)
+	{
+	  double v = wendlandFunction(norm_2(X[i]-X[cand[k]])/radius,ell,1);
+	  if (v != 0.0) rows[i].push_back(std::make_pair(cand[k],v));
+	}
+      rows[i].push_back(std::make_pair(i,1.0+nugget));
+      grid.insert(i,X[i]);
+    }
+  utils::EnvelopeCholesky S;
+  size_t res = S.decompose(std::vector<utils::sparse_row>(rows.begin(),rows.end()-1));
+
+  // Last point added incrementally
+  grid.query(X[n-1],cand);
+  utils::sparse_row last;
+  for (size_t k = 0; k < cand.size(); ++k)
+    {
+      double v = wendlandFunction(norm_2(X[n-1]-X[cand[k]])/radius,ell,1);
+      if (v != 0.0) last.push_back(std::make_pair(cand[k],v));
+    }
+  last.push_back(std::make_pair(n-1,1.0+nugget));
+  res += S.addRow(last);
+
+  vectord ys(y);
+  S.solveLower(ys);
+  double sparse_time = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+  std::cout << res << ": " 
+	    << "logdet error: " << utils::log_trace(L) - S.logTrace() 
+	    << " quadratic form error: " 
+	    << inner_prod(yd,yd) - inner_prod(ys,ys) << std::endl
+	    << "Envelope size: " << S.nonZeros() << " of " << n*(n+1)/2
+	    << " (dense: " << dense_time << " sec)"
+	    << " (sparse: " << sparse_time << " sec)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,91 @@
+/** \file testenvelope.cpp \brief test sparse (envelope) Cholesky decomposition */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <ctime>
+#include <iostream>
+#include "randgen.hpp"
+#include "ublas_cholesky.hpp"
+#include "ublas_trace.hpp"
+#include "ublas_iterative.hpp"
+
+using namespace bayesopt;
+namespace ublas = boost::numeric::ublas;
+
+struct DenseOp
+{
+  DenseOp(const matrixd& A): mA(A) {};
+  void operator()(const matrixd& V, matrixd& AV) { AV = prod(mA,V); };
+  const matrixd& mA;
+};
+
+int main(int argc, char * argv[])
+{
+  size_t n = 500;
+  if (argc > 1) n = ::atoi(argv[1]);
+  const size_t dim = 2;
+  const double nugget = 1e-4;
+
+  randEngine eng;
+  randFloat sample(eng, realUniformDist(0,1));
+  vecOfvec X(n, vectord(dim));
+  matrixd Y(n,2);
+  for (size_t i = 0; i < n; ++i)
+    {
+      for (size_t j = 0; j < dim; ++j) X[i](j) = sample();
+      Y(i,0) = sample();  Y(i,1) = sample();
+    }
+
+  // Squared exponential kernel, length scale 0.3
+  matrixd K(n,n);
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < n; ++j)
+      K(i,j) = std::exp(-0.5*inner_prod(X[i]-X[j],X[i]-X[j])/0.09)
+	+ ((i==j) ? nugget : 0.0);
+
+  clock_t start = clock();
+  matrixd L(n,n);
+  utils::cholesky_decompose(K,L);
+  vectord yd(column(Y,0));
+  inplace_solve(L,yd,ublas::lower_tag());
+  double dense_time = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+  start = clock();
+  DenseOp op(K);
+  vectord diag(n);
+  for (size_t i = 0; i < n; ++i) diag(i) = K(i,i);
+  matrixd Z;
+  size_t iters = utils::pcg_solve(op,diag,Y,Z,1e-8,10*n);
+  randEngine probes(1);
+  double logdet = utils::lanczos_logdet(op,n,10,50,probes);
+  double iter_time = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+  std::cout << "CG iterations: " << iters 
+	    << " quadratic form error: " 
+	    << inner_prod(yd,yd) - inner_prod(column(Y,0),column(Z,0))
+	    << " residual (2nd rhs): " 
+	    << norm_2(prod(K,column(Z,1)) - column(Y,1)) << std::endl
+	    << "logdet: " << 2*utils::log_trace(L) << " estimate: " << logdet
+	    << " (dense: " << dense_time << " sec)"
+	    << " (iterative: " << iter_time << " sec)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,86 @@
+/** \file testenvelope.cpp \brief test sparse (envelope) Cholesky decomposition */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <ctime>
+#include <iostream>
+#include <algorithm>
+#include "randgen.hpp"
+#include "kdtree.hpp"
+
+using namespace bayesopt;
+
+int main(int argc, char * argv[])
+{
+  size_t n = 5000;
+  if (argc > 1) n = ::atoi(argv[1]);
+  const size_t dim = 4;
+  const size_t k = 5;
+  const double radius = 0.1;
+  const size_t nQueries = 200;
+
+  randEngine eng;
+  randFloat sample(eng, realUniformDist(0,1));
+  vecOfvec X(n, vectord(dim));
+  for (size_t i = 0; i < n; ++i)
+    for (size_t j = 0; j < dim; ++j) X[i](j) = sample();
+
+  // Half built at once, half inserted incrementally
+  utils::KDTree tree;
+  tree.build(vecOfvec(X.begin(),X.begin()+n/2));
+  for (size_t i = n/2; i < n; ++i) tree.insert(X[i]);
+
+  size_t errors = 0;
+  double tree_time = 0.0, brute_time = 0.0;
+  for (size_t q = 0; q < nQueries; ++q)
+    {
+      vectord query(dim);
+      for (size_t j = 0; j < dim; ++j) query(j) = sample();
+
+      clock_t start = clock();
+      std::vector<size_t> knn, ball;
+      tree.knn(query,k,knn);
+      tree.radius(query,radius,ball);
+      tree_time += static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+      start = clock();
+      std::vector<std::pair<double,size_t> > dist(n);
+      std::vector<size_t> ballBrute;
+      for (size_t i = 0; i < n; ++i)
+	{
+	  dist[i] = std::make_pair(norm_2(query-X[i]),i);
+	  if (dist[i].first <= radius) ballBrute.push_back(i);
+	}
+      std::sort(dist.begin(),dist.end());
+      brute_time += static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+      for (size_t i = 0; i < k; ++i)
+	if (knn[i] != dist[i].second) ++errors;
+      std::sort(ball.begin(),ball.end());
+      if (ball != ballBrute) ++errors;
+    }
+
+  std::cout << "Errors: " << errors 
+	    << " (kd-tree: " << tree_time << " sec)"
+	    << " (brute force: " << brute_time << " sec)" << std::endl;
+  return 0;
+}
@@ -0,0 +1,78 @@
+/** \file testphilox.cpp \brief test counter-based random engine and its streams */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <iostream>
+#include "randgen.hpp"
+
+using bayesopt::utils::Philox4x32;
+
+int main()
+{
+  size_t errors = 0;
+
+  // Known answers from the reference implementation (Random123)
+  boost::uint32_t ctr[3][4] = {{0,0,0,0},
+			       {0xffffffff,0xffffffff,0xffffffff,0xffffffff},
+			       {0x243f6a88,0x85a308d3,0x13198a2e,0x03707344}};
+  boost::uint32_t key[3][2] = {{0,0},{0xffffffff,0xffffffff},
+			       {0xa4093822,0x299f31d0}};
+  boost::uint32_t res[3][4] = {{0x6627e8d5,0xe169c58d,0xbc57ac4c,0x9b00dbd8},
+			       {0x408f276d,0x41c83b0e,0xa20bc7c6,0x6d5451fd},
+			       {0xd16cfe09,0x94fdcceb,0x5001e420,0x24126ea1}};
+  for (size_t i = 0; i < 3; ++i)
+    {
+      Philox4x32::block(ctr[i],key[i]);
+      for (size_t j = 0; j < 4; ++j)
+	if (ctr[i][j] != res[i][j]) ++errors;
+    }
+  std::cout << "Known answers errors: " << errors << std::endl;
+
+  // Streams are reproducible from the seed and do not overlap
+  randEngine eng(1234);
+  randEngine a = eng.split(STREAM_MODEL), b(1234,STREAM_MODEL);
+  size_t equal = 0;
+  for (size_t i = 0; i < 1000; ++i)
+    {
+      boost::uint32_t x = eng(), y = a(); 
+      if (y != b()) ++errors;
+      if (x == y) ++equal;
+    }
+  std::cout << "Equal numbers in different streams: " << equal << std::endl;
+
+  // Skipping numbers is the same as drawing them
+  randEngine c(1234), d(1234);
+  for (size_t i = 0; i < 7; ++i) c();
+  d.discard(7);
+  if ((c != d) || (c() != d())) ++errors;
+  if (c != d) ++errors;
+
+  // Boost distributions on top of the engine
+  randFloat sample(eng, realUniformDist(0,1));
+  double mean = 0.0;
+  for (size_t i = 0; i < 100000; ++i)  mean += sample();
+  mean /= 100000;
+  std::cout << "Uniform mean: " << mean << std::endl;
+
+  std::cout << "Errors: " << errors << std::endl;
+  return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,201 @@
+/** \file testthreadpool.cpp \brief test work-stealing pool and parallel loops */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "threadpool.hpp"
+#include "log.hpp"
+#include "profiler.hpp"
+
+using namespace bayesopt;
+
+class SquareTask: public utils::RangeTask
+{
+public:
+  SquareTask(std::vector<double>& v): mV(v) {};
+  void operator()(size_t begin, size_t end)
+  {
+    // Uneven cost per index, so threads must steal work.
+    for (size_t i = begin; i < end; ++i)
+      {
+	double x = 0.0;
+	for (size_t k = 0; k < i; ++k)  x += std::sin(static_cast<double>(k));
+	mV[i] = x;
+      }
+  };
+private:
+  std::vector<double>& mV;
+};
+
+class SumTask: public utils::ReduceTask<double>
+{
+public:
+  SumTask(const std::vector<double>& v): mV(v) {};
+  double operator()(size_t begin, size_t end)
+  {
+    double sum = 0.0;
+    for (size_t i = begin; i < end; ++i)  sum += mV[i];
+    return sum;
+  };
+private:
+  const std::vector<double>& mV;
+};
+
+class FailTask: public utils::RangeTask
+{
+public:
+  void operator()(size_t begin, size_t end)
+  {
+    if ((begin <= 77) && (77 < end))  throw std::runtime_error("Task 77");
+  };
+};
+
+class CountTask: public utils::RangeTask
+{
+public:
+  void operator()(size_t begin, size_t end)
+  { utils::Profiler::count(utils::COUNT_KERNEL,end-begin); };
+};
+
+class LogTask: public utils::RangeTask
+{
+public:
+  void operator()(size_t begin, size_t end)
+  { 
+    for (size_t i = begin; i < end; ++i)  FILE_LOG(logINFO) << "index " << i;
+  };
+};
+
+/** Runs a RangeTask over [0,n) as one asynchronous task. */
+class WholeRangeTask: public utils::ParallelTask
+{
+public:
+  WholeRangeTask(utils::RangeTask& body, size_t n): mBody(body), mN(n) {};
+  void operator()(size_t /*index*/)
+  { mBody(0,mN); };
+private:
+  utils::RangeTask& mBody;
+  size_t mN;
+};
+
+int main()
+{
+  const size_t n = 5000;
+  size_t errors = 0;
+
+  std::vector<double> serial(n), parallel(n);
+  SquareTask serialTask(serial), parallelTask(parallel);
+  utils::parallelFor(0,n,1,serialTask);    // No executor: serial
+  SumTask serialSum(serial);
+  const double expected = utils::parallelReduce(0,n,64,0.0,serialSum);
+
+  size_t threads[] = {2, 4, 0};
+  for (size_t t = 0; t < 3; ++t)
+    {
+      utils::ThreadPool pool(threads[t]);
+      utils::ExecutorScope scope(&pool);
+
+      std::fill(parallel.begin(),parallel.end(),0.0);
+      utils::parallelFor(0,n,7,parallelTask);
+      if (parallel != serial)  ++errors;
+
+      // Same chunks and order of joins for any number of threads
+      SumTask parallelSum(parallel);
+      if (utils::parallelReduce(0,n,64,0.0,parallelSum) != expected)  ++errors;
+
+      // Workers count in the profiler of the caller
+      utils::Profiler profiler;
+      {
+	utils::ProfilerActivation profiling(profiler);
+	CountTask count;
+	utils::parallelFor(0,n,1,count);
+      }
+      if (profiler.getTotal().n_kernel != n)  ++errors;
+
+      // Workers log with the settings of the caller
+      LogSettings settings;
+      settings.level = logINFO;
+      settings.stream = std::tmpfile();
+      {
+	LogScope logging(settings);
+	LogTask log;
+	utils::parallelFor(0,100,1,log);
+	Output2FILE::Flush();
+      }
+      std::rewind(settings.stream);
+      size_t lines = 0;
+      for (int c = std::fgetc(settings.stream); c != EOF; 
+	   c = std::fgetc(settings.stream))
+	{
+	  if (c == '\n')  ++lines;
+	}
+      std::fclose(settings.stream);
+      if (lines != 100)  ++errors;
+
+      FailTask fail;
+      try 
+	{ 
+	  utils::parallelFor(0,1000,1,fail);
+	  ++errors;
+	}
+      catch (std::runtime_error& e)
+	{
+	  if (std::string(e.what()) != "Task 77")  ++errors;
+	}
+
+      std::cout << "Threads: " << pool.getNumThreads() 
+		<< " Errors: " << errors << std::endl;
+    }
+
+  // Background task while the caller works
+  utils::AsyncTask async;
+  std::fill(parallel.begin(),parallel.end(),0.0);
+  WholeRangeTask whole(parallelTask,n);
+  async.start(whole);
+  if (!async.isStarted())  ++errors;
+  SumTask callerSum(serial);
+  if (utils::parallelReduce(0,n,64,0.0,callerSum) != expected)  ++errors;
+  async.wait();
+  if ((parallel != serial) || async.isStarted())  ++errors;
+
+  FailTask fail;
+  WholeRangeTask failing(fail,1000);
+  async.start(failing);
+  try 
+    { 
+      async.wait();
+      ++errors;
+    }
+  catch (std::runtime_error& e)
+    {
+      if (std::string(e.what()) != "Task 77")  ++errors;
+    }
+  async.wait();                        // The error is reported once
+
+  std::cout << "Async task. Errors: " << errors << std::endl;
+
+  return (errors == 0) ? 0 : 1;
+}
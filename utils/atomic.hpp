@@ -0,0 +1,162 @@
+/** \file atomic.hpp 
+    \brief Minimal atomic integers and flags */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef _ATOMIC_HPP_
+#define _ATOMIC_HPP_
+
+#include <cstddef>
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#  include <intrin.h>
+#endif
+
+namespace bayesopt 
+{  
+  namespace utils 
+  {
+    /** Full memory barrier. */
+    inline void memoryBarrier()
+    {
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+      MemoryBarrier();
+#else
+      __sync_synchronize();
+#endif
+    }
+
+#if defined(_MSC_VER)
+    namespace detail
+    {
+      template <size_t N> struct Interlocked;
+
+      template <> struct Interlocked<4>
+      {
+	typedef long type;
+	static type add(volatile type* ptr, type n)
+	{ return _InterlockedExchangeAdd(ptr,n); }
+	static type cas(volatile type* ptr, type oldval, type newval)
+	{ return _InterlockedCompareExchange(ptr,newval,oldval); }
+      };
+
+      template <> struct Interlocked<8>
+      {
+	typedef __int64 type;
+	static type add(volatile type* ptr, type n)
+	{ return InterlockedExchangeAdd64(ptr,n); }
+	static type cas(volatile type* ptr, type oldval, type newval)
+	{ return InterlockedCompareExchange64(ptr,newval,oldval); }
+      };
+    }
+#endif
+
+    /** 
+     * \brief Integer shared between threads, with the interface of
+     * std::atomic (which requires C++11). Every operation is
+     * sequentially consistent. T must be an integer of 4 or 8 bytes.
+     *
+     * Copies read the value, so they can be stored in containers, but
+     * the copy itself is not atomic.
+     */
+    template <typename T>
+    class Atomic
+    {
+    public:
+      explicit Atomic(T value = T()): mValue(value) {};
+      Atomic(const Atomic& copy): mValue(copy.load()) {};
+      Atomic& operator=(const Atomic& copy)
+      { store(copy.load());  return *this; };
+
+      T load() const
+      { 
+	const T value = mValue;
+	memoryBarrier();
+	return value;
+      };
+
+      void store(T value)
+      {
+	memoryBarrier();
+	mValue = value;
+	memoryBarrier();
+      };
+
+      /** Adds n and returns the previous value. */
+      T fetchAdd(T n)
+      {
+#if defined(_MSC_VER)
+	typedef detail::Interlocked<sizeof(T)> Op;
+	return static_cast<T>(Op::add(reinterpret_cast<volatile typename 
+				      Op::type*>(&mValue),
+				      static_cast<typename Op::type>(n)));
+#else
+	return __sync_fetch_and_add(&mValue,n);
+#endif
+      };
+
+      /** Sets desired if the value is expected. Returns true if it
+	  was set. */
+      bool compareExchange(T expected, T desired)
+      {
+#if defined(_MSC_VER)
+	typedef detail::Interlocked<sizeof(T)> Op;
+	typedef typename Op::type type;
+	return Op::cas(reinterpret_cast<volatile type*>(&mValue),
+		       static_cast<type>(expected),
+		       static_cast<type>(desired)) 
+	  == static_cast<type>(expected);
+#else
+	return __sync_bool_compare_and_swap(&mValue,expected,desired);
+#endif
+      };
+
+    private:
+      volatile T mValue;
+    };
+
+    /** \brief Boolean shared between threads (see Atomic). */
+    template <>
+    class Atomic<bool>
+    {
+    public:
+      explicit Atomic(bool value = false): mValue(value ? 1 : 0) {};
+
+      bool load() const
+      { return mValue.load() != 0; };
+
+      void store(bool value)
+      { mValue.store(value ? 1 : 0); };
+
+    private:
+      Atomic<long> mValue;
+    };
+
+  } //namespace utils
+
+} //namespace bayesopt
+
+#endif
@@ -20,6 +20,7 @@
 #ifndef  _BOUNDING_BOX_HPP_
 #define  _BOUNDING_BOX_HPP_
 
+#include <algorithm>
 // BOOST Libraries
 #include <boost/numeric/ublas/vector.hpp>
 #include "ublas_elementwise.hpp"
@@ -45,8 +46,20 @@ namespace bayesopt {
 
       inline V normalizeVector( const V &vin )
       {
-	return ublas_elementwise_div(vin - mLowerBound, mRangeBound);
+	const V vshift = vin - mLowerBound;
+	return ublas_elementwise_div(vshift, mRangeBound);
       }  // normalizeVector
+
+      inline V clipVector( const V &vin )
+      {
+	V vout = vin;
+	for (size_t i = 0; i < vout.size(); ++i)
+	  {
+	    vout(i) = std::max(vout(i), mLowerBound(i));
+	    vout(i) = std::min(vout(i), mLowerBound(i) + mRangeBound(i));
+	  }
+	return vout;
+      }  // clipVector
   
     protected:
       V mLowerBound; ///< Lower bound of the input space
@@ -0,0 +1,104 @@
+/**  \file cellgrid.hpp \brief Spatial hashing in a regular grid of cells */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef _CELLGRID_HPP_
+#define _CELLGRID_HPP_
+
+#include <map>
+#include <vector>
+#include <cmath>
+#include "specialtypes.hpp"
+
+namespace bayesopt
+{
+  namespace utils
+  {
+    /** 
+     * \brief Spatial index that hashes points in a regular grid of
+     * cells. If the cell size is the search radius (per dimension),
+     * all the neighbours of a point are in the same or adjacent cells.
+     * Intended for low dimensional problems, as each query visits
+     * 3^d cells.
+     */
+    class CellGrid
+    {
+    public:
+      CellGrid(const vectord& cellSize): mCellSize(cellSize) {};
+      virtual ~CellGrid() {};
+
+      /** Adds the point x with a certain index */
+      void insert(size_t index, const vectord& x)
+      { mCells[getCell(x)].push_back(index); };
+
+      /** 
+       * \brief Indexes of the points in the same cell of x and the
+       * adjacent cells. 
+       */
+      void query(const vectord& x, std::vector<size_t>& result) const
+      {
+	result.clear();
+	const cell_key center = getCell(x);
+	cell_key key(center);
+	const size_t dim = center.size();
+
+	// Iterate over the 3^d offsets in {-1,0,1}^d
+	std::vector<int> offset(dim,-1);
+	while (true)
+	  {
+	    for (size_t i = 0; i < dim; ++i)  key[i] = center[i] + offset[i];
+
+	    cell_map::const_iterator it = mCells.find(key);
+	    if (it != mCells.end())
+	      {
+		result.insert(result.end(),it->second.begin(),it->second.end());
+	      }
+
+	    size_t i = 0;
+	    while ((i < dim) && (offset[i] == 1))  offset[i++] = -1;
+	    if (i == dim) break;
+	    ++offset[i];
+	  }
+      };
+
+    private:
+      typedef std::vector<int> cell_key;
+      typedef std::map<cell_key, std::vector<size_t> > cell_map;
+
+      cell_key getCell(const vectord& x) const
+      {
+	cell_key key(x.size());
+	for (size_t i = 0; i < x.size(); ++i)
+	  {
+	    key[i] = static_cast<int>(std::floor(x(i)/mCellSize(i)));
+	  }
+	return key;
+      };
+
+      vectord mCellSize;
+      cell_map mCells;
+    };
+
+  } //namespace utils
+} //namespace bayesopt
+
+#endif
@@ -0,0 +1,430 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <boost/cstdint.hpp>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "datafile.hpp"
+#include "tracer.hpp"
+
+namespace bayesopt 
+{  
+  namespace utils 
+  {
+    namespace
+    {
+      const char DATA_MAGIC[8] = {'B','O','P','T','D','A','T','A'};
+      const char JOURNAL_MAGIC[8] = {'B','O','P','T','J','R','N','L'};
+      const boost::uint64_t VERSION = 1;
+      const boost::uint64_t JOURNAL_VERSION = 2;
+
+      struct FileHeader
+      {
+	char magic[8];
+	boost::uint64_t version;
+	boost::uint64_t nSamples;
+	boost::uint64_t nDims;
+      };
+
+      struct JournalHeader
+      {
+	char magic[8];
+	boost::uint64_t version;
+	boost::uint64_t nInputDims;
+	boost::uint64_t nDims;
+	boost::uint64_t nBounds;
+	boost::uint64_t seed;
+      };
+
+      struct EntryHeader
+      {
+	boost::uint64_t iteration;
+	boost::uint64_t source;
+	double time;
+	double y;
+      };
+
+      size_t entrySize(const JournalDomain& domain)
+      { 
+	return sizeof(EntryHeader) + 
+	  (domain.nInputDims + domain.nDims) * sizeof(double); 
+      }
+
+      size_t headerSize(const JournalDomain& domain)
+      { return sizeof(JournalHeader) + 2*domain.lower.size()*sizeof(double); }
+
+      bool sameValues(const char* data, const vectord& v)
+      {
+	return v.empty() || 
+	  (std::memcmp(data, &v(0), v.size()*sizeof(double)) == 0);
+      }
+
+      bool checkHeader(const FileHeader& header, const char* magic)
+      {
+	return (std::memcmp(header.magic, magic, sizeof(header.magic)) == 0)
+	  && (header.version == VERSION);
+      }
+    }
+
+    ////////////////////////////////////////////////////////////////////
+
+    MappedFile::MappedFile(const std::string& filename):
+      mData(NULL), mSize(0), mMapped(false)
+    {
+#if !defined(_WIN32)
+      int fd = open(filename.c_str(), O_RDONLY);
+      if (fd < 0)
+	{
+	  throw std::runtime_error("Unable to open data file: " + filename);
+	}
+      struct stat st;
+      if (fstat(fd,&st) == 0 && st.st_size > 0)
+	{
+	  mSize = static_cast<size_t>(st.st_size);
+	  void* addr = mmap(NULL, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+	  if (addr != MAP_FAILED)
+	    {
+	      mData = static_cast<const char*>(addr);
+	      mMapped = true;
+	    }
+	}
+      close(fd);
+#endif
+      if (!mMapped)  // Read the whole file at once
+	{
+	  std::ifstream ifs(filename.c_str(), std::ios::binary | std::ios::ate);
+	  if (!ifs)
+	    {
+	      throw std::runtime_error("Unable to open data file: " + filename);
+	    }
+	  mSize = static_cast<size_t>(ifs.tellg());
+	  mBuffer.resize(mSize);
+	  ifs.seekg(0);
+	  if (mSize > 0)  ifs.read(&mBuffer[0], mSize);
+	  mData = mBuffer.empty() ? NULL : &mBuffer[0];
+	}
+    }
+
+    MappedFile::~MappedFile()
+    {
+#if !defined(_WIN32)
+      if (mMapped)  munmap(const_cast<char*>(mData), mSize);
+#endif
+    }
+
+    ////////////////////////////////////////////////////////////////////
+
+    ObservationFile::ObservationFile(const std::string& filename):
+      mFile(filename), mNSamples(0), mNDims(0)
+    {
+      FileHeader header;
+      if (mFile.getSize() < sizeof(header))
+	{
+	  throw std::runtime_error("Invalid data file: " + filename);
+	}
+      std::memcpy(&header, mFile.getData(), sizeof(header));
+
+      // The sizes of the header are bounded by the file size before
+      // they are multiplied, so a corrupted header cannot overflow.
+      const boost::uint64_t nValues = 
+	(mFile.getSize() - sizeof(header)) / sizeof(double);
+      if (!checkHeader(header,DATA_MAGIC) || (header.nDims + 1 == 0) ||
+	  (header.nSamples > nValues / (header.nDims + 1)))
+	{
+	  throw std::runtime_error("Invalid data file: " + filename);
+	}
+      const size_t expected = sizeof(header) + sizeof(double) *
+	static_cast<size_t>(header.nSamples * (header.nDims + 1));
+      if (mFile.getSize() != expected)
+	{
+	  throw std::runtime_error("Invalid data file: " + filename);
+	}
+      mNSamples = static_cast<size_t>(header.nSamples);
+      mNDims = static_cast<size_t>(header.nDims);
+    }
+
+    const double* ObservationFile::getInputs() const
+    { 
+      return reinterpret_cast<const double*>(mFile.getData() + 
+					     sizeof(FileHeader)); 
+    }
+
+    const double* ObservationFile::getOutputs() const
+    { 
+      return getInputs() + mNSamples * mNDims; 
+    }
+
+    void ObservationFile::save(const std::string& filename, 
+			       const vecOfvec& x, const vectord& y)
+    {
+      if (x.size() != y.size())
+	{
+	  throw std::invalid_argument("Different number of inputs "
+				      "and outputs.");
+	}
+
+      FileHeader header;
+      std::memcpy(header.magic, DATA_MAGIC, sizeof(DATA_MAGIC));
+      header.version = VERSION;
+      header.nSamples = x.size();
+      header.nDims = x.empty() ? 0 : x[0].size();
+
+      std::ofstream ofs(filename.c_str(), std::ios::binary | std::ios::trunc);
+      if (!ofs)
+	{
+	  throw std::runtime_error("Unable to write data file: " + filename);
+	}
+      ofs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      for (size_t i = 0; i < x.size(); ++i)
+	{
+	  ofs.write(reinterpret_cast<const char*>(&x[i](0)), 
+		    sizeof(double) * x[i].size());
+	}
+      if (!y.empty())
+	{
+	  ofs.write(reinterpret_cast<const char*>(&y(0)), 
+		    sizeof(double) * y.size());
+	}
+      if (!ofs)
+	{
+	  throw std::runtime_error("Unable to write data file: " + filename);
+	}
+    }
+
+    ////////////////////////////////////////////////////////////////////
+
+    ObservationJournal::ObservationJournal():
+      mFile(NULL)
+    {}
+
+    ObservationJournal::~ObservationJournal()
+    {
+      try { close(); } 
+      catch (...) {}
+    }
+
+    void ObservationJournal::open(const std::string& filename, 
+				  const JournalDomain& domain, bool resume)
+    {
+      assert(domain.lower.size() == domain.upper.size());
+      close();
+      mDomain = domain;
+
+      if (resume)
+	{
+	  vecOfvec x;  vectord y;  size_t nIter;
+	  if (read(filename,domain,x,y,nIter))
+	    {
+	      const size_t valid = headerSize(domain) + 
+		x.size() * entrySize(domain);
+	      bool complete;
+	      {
+		MappedFile file(filename);
+		complete = (file.getSize() == valid);
+		if (!complete)  // Remove the partial entry
+		  {
+		    const std::string tmpname = filename + ".tmp";
+		    std::FILE* tmp = std::fopen(tmpname.c_str(),"wb");
+		    if ((tmp == NULL) || 
+			(std::fwrite(file.getData(),1,valid,tmp) != valid))
+		      {
+			if (tmp != NULL)  std::fclose(tmp);
+			throw std::runtime_error("Unable to write journal: " 
+						 + tmpname);
+		      }
+		    std::fclose(tmp);
+		  }
+	      }
+	      if (!complete)
+		{
+		  std::remove(filename.c_str());
+		  std::rename((filename + ".tmp").c_str(), filename.c_str());
+		}
+	      mFile = std::fopen(filename.c_str(),"ab");
+	      if (mFile == NULL)
+		{
+		  throw std::runtime_error("Unable to write journal: " + filename);
+		}
+	      return;
+	    }
+	}
+
+      mFile = std::fopen(filename.c_str(),"wb");
+      if (mFile == NULL)
+	{
+	  throw std::runtime_error("Unable to write journal: " + filename);
+	}
+      JournalHeader header;
+      std::memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+      header.version = JOURNAL_VERSION;
+      header.nInputDims = domain.nInputDims;
+      header.nDims = domain.nDims;
+      header.nBounds = domain.lower.size();
+      header.seed = domain.seed;
+
+      mBuffer.resize(headerSize(domain));
+      std::memcpy(&mBuffer[0], &header, sizeof(header));
+      if (!domain.lower.empty())
+	{
+	  const size_t nBytes = domain.lower.size() * sizeof(double);
+	  std::memcpy(&mBuffer[sizeof(header)], &domain.lower(0), nBytes);
+	  std::memcpy(&mBuffer[sizeof(header) + nBytes], &domain.upper(0), 
+		      nBytes);
+	}
+      flush();
+    }
+
+    void ObservationJournal::close()
+    {
+      if (mFile != NULL)
+	{
+	  flush();
+	  std::fclose(mFile);
+	  mFile = NULL;
+	}
+      mBuffer.clear();
+    }
+
+    void ObservationJournal::append(size_t iteration, JournalSource source,
+				    const vectord& input, const vectord& x, 
+				    double y)
+    {
+      assert(input.size() == mDomain.nInputDims);
+      assert(x.size() == mDomain.nDims);
+      EntryHeader entry;
+      entry.iteration = iteration;
+      entry.source = source;
+      entry.time = wallTime();
+      entry.y = y;
+
+      size_t pos = mBuffer.size();
+      mBuffer.resize(pos + entrySize(mDomain));
+      std::memcpy(&mBuffer[pos], &entry, sizeof(entry));
+      pos += sizeof(entry);
+      if (mDomain.nInputDims > 0)
+	{
+	  std::memcpy(&mBuffer[pos], &input(0), 
+		      mDomain.nInputDims * sizeof(double));
+	  pos += mDomain.nInputDims * sizeof(double);
+	}
+      if (mDomain.nDims > 0)
+	{
+	  std::memcpy(&mBuffer[pos], &x(0), mDomain.nDims * sizeof(double));
+	}
+    }
+
+    void ObservationJournal::flush()
+    {
+      if ((mFile == NULL) || mBuffer.empty())  return;
+
+      const size_t written = std::fwrite(&mBuffer[0],1,mBuffer.size(),mFile);
+      std::fflush(mFile);
+      if (written != mBuffer.size())
+	{
+	  // Later entries would follow a partial one, thus the journal
+	  // is not usable anymore.
+	  std::fclose(mFile);
+	  mFile = NULL;
+	  mBuffer.clear();
+	  throw std::runtime_error("Unable to write journal.");
+	}
+      mBuffer.clear();
+    }
+
+    bool ObservationJournal::read(const std::string& filename, 
+				  const JournalDomain& domain,
+				  vecOfvec& x, vectord& y, size_t& nIterations)
+    {
+      assert(domain.lower.size() == domain.upper.size());
+      x.clear();  y.resize(0);  nIterations = 0;
+      {
+	std::ifstream test(filename.c_str());
+	if (!test)  return false;
+      }
+      MappedFile file(filename);
+
+      JournalHeader header;
+      if (file.getSize() < sizeof(header))
+	{
+	  throw std::runtime_error("Invalid journal: " + filename);
+	}
+      std::memcpy(&header, file.getData(), sizeof(header));
+      if ((std::memcmp(header.magic, JOURNAL_MAGIC, sizeof(header.magic)) != 0)
+	  || (header.version != JOURNAL_VERSION))
+	{
+	  throw std::runtime_error("Invalid journal: " + filename);
+	}
+
+      const size_t nBounds = domain.lower.size();
+      const char* bounds = file.getData() + sizeof(header);
+      if ((header.nInputDims != domain.nInputDims) || 
+	  (header.nDims != domain.nDims) || (header.nBounds != nBounds) ||
+	  (header.seed != domain.seed) || 
+	  (file.getSize() < headerSize(domain)) ||
+	  !sameValues(bounds, domain.lower) ||
+	  !sameValues(bounds + nBounds*sizeof(double), domain.upper))
+	{
+	  throw std::runtime_error("The journal belongs to a different problem "
+				   "(dimensions, bounds or embedding): " 
+				   + filename);
+	}
+
+      const size_t dim = domain.nDims;
+      const size_t offset = sizeof(EntryHeader) + 
+	domain.nInputDims * sizeof(double);
+      const size_t step = entrySize(domain);
+      const size_t n = (file.getSize() - headerSize(domain)) / step;
+      x.resize(n, vectord(dim));  y.resize(n);
+
+      const char* data = file.getData() + headerSize(domain);
+      EntryHeader entry;
+      for (size_t i = 0; i < n; ++i, data += step)
+	{
+	  std::memcpy(&entry, data, sizeof(entry));
+	  y(i) = entry.y;
+	  if (dim > 0)
+	    {
+	      std::memcpy(&x[i](0), data + offset, dim*sizeof(double));
+	    }
+	  if (entry.source != JOURNAL_INIT)
+	    {
+	      nIterations = std::max(nIterations,
+				     static_cast<size_t>(entry.iteration) + 1);
+	    }
+	}
+      return true;
+    }
+
+  } //namespace utils
+
+} //namespace bayesopt
@@ -0,0 +1,217 @@
+/**  \file datafile.hpp \brief Binary files and journals of observations */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef  _DATAFILE_HPP_
+#define  _DATAFILE_HPP_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+#include "specialtypes.hpp"
+
+namespace bayesopt 
+{  
+  namespace utils 
+  {
+    /** 
+     * \brief Read-only memory map of a whole file. If the platform
+     * does not support mapping, the file is read at once.
+     */
+    class MappedFile
+    {
+    public:
+      /** Throws std::runtime_error if the file cannot be opened. */
+      explicit MappedFile(const std::string& filename);
+      ~MappedFile();
+
+      const char* getData() const;
+      size_t getSize() const;
+
+    private:
+      const char* mData;           ///< Mapped (or read) file
+      size_t mSize;                ///< File size in bytes
+      bool mMapped;
+      std::vector<char> mBuffer;   ///< Contents if mapping is not available
+
+    private: //Forbidden
+      MappedFile(const MappedFile& copy);
+      MappedFile& operator=(const MappedFile& copy);
+    };
+
+    inline const char* MappedFile::getData() const
+    { return mData; }
+
+    inline size_t MappedFile::getSize() const
+    { return mSize; }
+
+
+    /** 
+     * \brief Read-only view of a binary file of observations. 
+     *
+     * The file is memory mapped (if the platform supports it), thus
+     * the data is only read when it is used and it can be loaded
+     * without any parsing. Format (native byte order):
+     *  - Header: "BOPTDATA", followed by the version, the number of
+     *    samples and the number of dimensions as 64 bit integers.
+     *  - Inputs: nSamples x nDims doubles, sample after sample.
+     *  - Outputs: nSamples doubles.
+     */
+    class ObservationFile
+    {
+    public:
+      /** Opens the file. Throws std::runtime_error if the file does
+	  not exist or it is not a valid observation file. */
+      explicit ObservationFile(const std::string& filename);
+
+      size_t getNSamples() const;
+      size_t getNDims() const;
+
+      /** Inputs in row major order (nSamples x nDims). */
+      const double* getInputs() const;
+      const double* getOutputs() const;
+
+      /** Writes a set of observations in the same format. */
+      static void save(const std::string& filename, 
+		       const vecOfvec& x, const vectord& y);
+
+    private:
+      MappedFile mFile;
+      size_t mNSamples, mNDims;
+    };
+
+    inline size_t ObservationFile::getNSamples() const
+    { return mNSamples; }
+
+    inline size_t ObservationFile::getNDims() const
+    { return mNDims; }
+
+
+    /** Origin of the samples stored in a journal. */
+    enum JournalSource
+      {
+	JOURNAL_INIT = 0,        ///< Initial design or external data
+	JOURNAL_CRITERIA = 1,    ///< Optimum of the criteria
+	JOURNAL_RANDOM = 2       ///< Random jump (epsilon-greedy, stuck, etc.)
+      };
+
+    /** 
+     * \brief Map between the input space and the space of the
+     * surrogate model. A journal is only replayed by a problem with
+     * the same domain.
+     */
+    struct JournalDomain
+    {
+      JournalDomain(): nInputDims(0), nDims(0), seed(0) {};
+
+      size_t nInputDims;           ///< Dimensions of the input space
+      size_t nDims;                ///< Dimensions of the surrogate model
+      vectord lower;               ///< Input bounds (empty if not bounded)
+      vectord upper;               ///< Input bounds (empty if not bounded)
+      boost::uint64_t seed;        ///< Seed of the embedding (if any)
+    };
+
+    /** 
+     * \brief Append-only journal of observations.
+     *
+     * Every entry stores the iteration, the origin of the query, the
+     * wall time, the outcome and the query, both in the input space
+     * and in the space of the surrogate model. Entries are buffered
+     * and written to disk with a single write on every flush. Format
+     * (native byte order):
+     *  - Header: "BOPTJRNL", followed by the version, nInputDims,
+     *    nDims, the number of bounds (0 or nInputDims) and the seed
+     *    of the embedding as 64 bit integers. Then, the lower and
+     *    upper bounds (doubles).
+     *  - Entries: iteration and source (64 bit integers), wall time
+     *    (seconds since epoch), outcome, the nInputDims inputs and
+     *    the nDims inputs of the model (doubles).
+     *
+     * A partial entry at the end of the file (eg: if the process was
+     * killed while writing) is ignored.
+     */
+    class ObservationJournal
+    {
+    public:
+      ObservationJournal();
+      ~ObservationJournal();           ///< Flushes and closes the journal
+
+      /** 
+       * Opens a journal for writing. Throws std::runtime_error if the
+       * file cannot be written or, when resuming, if it is not a
+       * valid journal of the same domain.
+       * @param filename journal path
+       * @param domain input space and space of the model
+       * @param resume if true, append the entries to the existing
+       *        journal, otherwise start a new one.
+       */
+      void open(const std::string& filename, const JournalDomain& domain,
+		bool resume);
+      void close();
+      bool isOpen() const;
+
+      /** 
+       * Adds an entry to the write buffer.
+       * @param input query in the input space
+       * @param x query in the space of the surrogate model
+       */
+      void append(size_t iteration, JournalSource source,
+		  const vectord& input, const vectord& x, double y);
+
+      /** Writes the buffered entries to disk. If the write fails, the
+	  journal is closed and std::runtime_error is thrown. */
+      void flush();
+
+      /** 
+       * Reads all the complete entries of a journal.
+       * @param domain domain of the problem. The journal is refused
+       *        if it was written for a different one.
+       * @param x [out] queries in the space of the surrogate model
+       * @param nIterations [out] number of iterations after the
+       *        initial design that were completed.
+       * @return false if the journal does not exist. Throws
+       *         std::runtime_error if it is not a valid journal or
+       *         if the domain does not match.
+       */
+      static bool read(const std::string& filename, 
+		       const JournalDomain& domain,
+		       vecOfvec& x, vectord& y, size_t& nIterations);
+
+    private:
+      std::FILE* mFile;
+      JournalDomain mDomain;
+      std::vector<char> mBuffer;       ///< Entries not written yet
+
+    private: //Forbidden
+      ObservationJournal(const ObservationJournal& copy);
+      ObservationJournal& operator=(const ObservationJournal& copy);
+    };
+
+    inline bool ObservationJournal::isOpen() const
+    { return mFile != NULL; }
+
+  } //namespace utils
+
+} //namespace bayesopt
+
+#endif
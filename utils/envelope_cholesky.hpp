@@ -0,0 +1,297 @@
+/**  \file envelope_cholesky.hpp \brief Sparse (envelope) Cholesky decomposition */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef _ENVELOPE_CHOLESKY_HPP_
+#define _ENVELOPE_CHOLESKY_HPP_
+
+#include <cmath>
+#include <vector>
+#include <deque>
+#include <utility>
+#include <algorithm>
+#include "specialtypes.hpp"
+
+namespace bayesopt
+{
+  namespace utils
+  {
+    /** Sparse row of a symmetric matrix: pairs (column, value). */
+    typedef std::vector< std::pair<size_t,double> > sparse_row;
+
+    /** 
+     * \brief Reverse Cuthill-McKee ordering of a symmetric sparsity
+     * pattern. It reduces the bandwidth (and the envelope) of the
+     * matrix.
+     *
+     * @param adj adjacency lists of the graph of the matrix
+     * @param perm [out] perm[k] is the original index at position k
+     */
+    inline void reverse_cuthill_mckee(const std::vector< std::vector<size_t> >& adj,
+				      std::vector<size_t>& perm)
+    {
+      const size_t n = adj.size();
+      perm.clear();
+      perm.reserve(n);
+
+      // Each connected component starts from a node of minimum degree.
+      std::vector< std::pair<size_t,size_t> > byDegree(n);
+      for (size_t i = 0; i < n; ++i)
+	{
+	  byDegree[i] = std::make_pair(adj[i].size(),i);
+	}
+      std::sort(byDegree.begin(),byDegree.end());
+
+      std::vector<bool> visited(n,false);
+      std::vector< std::pair<size_t,size_t> > next;
+      for (size_t s = 0; s < n; ++s)
+	{
+	  const size_t start = byDegree[s].second;
+	  if (visited[start]) continue;
+
+	  std::deque<size_t> queue(1,start);
+	  visited[start] = true;
+	  while (!queue.empty())
+	    {
+	      const size_t u = queue.front();
+	      queue.pop_front();
+	      perm.push_back(u);
+
+	      next.clear();
+	      for (size_t k = 0; k < adj[u].size(); ++k)
+		{
+		  const size_t v = adj[u][k];
+		  if (!visited[v])
+		    {
+		      visited[v] = true;
+		      next.push_back(std::make_pair(adj[v].size(),v));
+		    }
+		}
+	      std::sort(next.begin(),next.end());
+	      for (size_t k = 0; k < next.size(); ++k)
+		{
+		  queue.push_back(next[k].second);
+		}
+	    }
+	}
+      std::reverse(perm.begin(),perm.end());
+    }
+
+
+    /** 
+     * \brief Cholesky decomposition of a sparse symmetric positive
+     * definite matrix stored by its envelope (profile).
+     *
+     * The matrix is reordered with reverse Cuthill-McKee to reduce the
+     * envelope. There is no fill-in outside the envelope, thus, for
+     * banded matrices (eg: compact kernels in low dimension), the cost
+     * of the decomposition and the triangular solves is almost linear.
+     * The decomposition is \f$ P A P^T = L L^T \f$.
+     */
+    class EnvelopeCholesky
+    {
+    public:
+      EnvelopeCholesky() {};
+      virtual ~EnvelopeCholesky() {};
+
+      /** 
+       * \brief Decomposes a sparse matrix given by its lower triangle. 
+       * @param rows rows[i] contains the pairs (j,A(i,j)) with j <= i
+       * @return nonzero if decompositon fails (the value is 1 + the
+       * number of the failing row, in the new order)
+       */
+      size_t decompose(const std::vector<sparse_row>& rows)
+      {
+	const size_t n = rows.size();
+
+	std::vector< std::vector<size_t> > adj(n);
+	for (size_t i = 0; i < n; ++i)
+	  {
+	    for (size_t k = 0; k < rows[i].size(); ++k)
+	      {
+		const size_t j = rows[i][k].first;
+		if (j != i)
+		  {
+		    adj[i].push_back(j);
+		    adj[j].push_back(i);
+		  }
+	      }
+	  }
+	reverse_cuthill_mckee(adj,mPerm);
+	mInvPerm.resize(n);
+	for (size_t p = 0; p < n; ++p)  mInvPerm[mPerm[p]] = p;
+
+	// Envelope of the permuted matrix
+	mFirst.resize(n);
+	for (size_t p = 0; p < n; ++p)  mFirst[p] = p;
+	for (size_t i = 0; i < n; ++i)
+	  {
+	    for (size_t k = 0; k < rows[i].size(); ++k)
+	      {
+		const size_t pi = mInvPerm[i];
+		const size_t pj = mInvPerm[rows[i][k].first];
+		const size_t hi = (std::max)(pi,pj);
+		mFirst[hi] = (std::min)(mFirst[hi],(std::min)(pi,pj));
+	      }
+	  }
+
+	mStart.resize(n+1);
+	mStart[0] = 0;
+	for (size_t p = 0; p < n; ++p)
+	  {
+	    mStart[p+1] = mStart[p] + p - mFirst[p] + 1;
+	  }
+	mValues.assign(mStart[n],0.0);
+
+	for (size_t i = 0; i < n; ++i)
+	  {
+	    for (size_t k = 0; k < rows[i].size(); ++k)
+	      {
+		const size_t pi = mInvPerm[i];
+		const size_t pj = mInvPerm[rows[i][k].first];
+		at((std::max)(pi,pj),(std::min)(pi,pj)) = rows[i][k].second;
+	      }
+	  }
+
+	for (size_t p = 0; p < n; ++p)
+	  {
+	    if (!factorizeRow(p))  return p + 1;
+	  }
+	return 0;
+      }
+
+      /** 
+       * \brief Adds a new row (and column) at the end of the matrix
+       * and updates the decomposition. The ordering of the previous
+       * rows is kept, so the envelope might grow over time.
+       *
+       * @param row pairs (j,A(n,j)) with j <= n, where n is the
+       * current size of the matrix.
+       * @return nonzero if decompositon fails
+       */
+      size_t addRow(const sparse_row& row)
+      {
+	const size_t n = mPerm.size();
+	mPerm.push_back(n);
+	mInvPerm.push_back(n);
+
+	size_t first = n;
+	for (size_t k = 0; k < row.size(); ++k)
+	  {
+	    first = (std::min)(first,mInvPerm[row[k].first]);
+	  }
+	mFirst.push_back(first);
+	mStart.push_back(mStart[n] + n - first + 1);
+	mValues.resize(mStart[n+1],0.0);
+
+	for (size_t k = 0; k < row.size(); ++k)
+	  {
+	    at(n,mInvPerm[row[k].first]) = row[k].second;
+	  }
+	return factorizeRow(n) ? 0 : n + 1;
+      }
+
+      /** 
+       * \brief Solves \f$ L y = P x \f$ in place. 
+       * Note that the result is in the permuted order, which is
+       * irrelevant for inner products between solutions.
+       */
+      void solveLower(vectord& x) const
+      {
+	const size_t n = mPerm.size();
+	assert(x.size() == n);
+	vectord y(n);
+	for (size_t p = 0; p < n; ++p)  y(p) = x(mPerm[p]);
+
+	for (size_t p = 0; p < n; ++p)
+	  {
+	    const double* lp = &mValues[mStart[p]];
+	    double sum = y(p);
+	    for (size_t k = mFirst[p]; k < p; ++k)
+	      {
+		sum -= lp[k - mFirst[p]] * y(k);
+	      }
+	    y(p) = sum / lp[p - mFirst[p]];
+	  }
+	x.swap(y);
+      }
+
+      /** \brief Sum of the logarithm of the diagonal of L */
+      double logTrace() const
+      {
+	double sum = 0.0;
+	for (size_t p = 0; p < mPerm.size(); ++p)
+	  {
+	    sum += std::log(mValues[mStart[p+1]-1]);
+	  }
+	return sum;
+      }
+
+      /** \brief Number of stored elements (size of the envelope) */
+      size_t nonZeros() const { return mValues.size(); };
+
+      size_t size() const { return mPerm.size(); };
+
+    private:
+      double& at(size_t i, size_t j)
+      { return mValues[mStart[i] + j - mFirst[i]]; };
+
+      /** Computes row p of L. Previous rows must be already computed. */
+      bool factorizeRow(size_t p)
+      {
+	double* lp = &mValues[mStart[p]];
+	const size_t fp = mFirst[p];
+	for (size_t j = fp; j <= p; ++j)
+	  {
+	    const double* lj = &mValues[mStart[j]];
+	    const size_t fj = mFirst[j];
+	    const size_t k0 = (std::max)(fp,fj);
+	    double sum = lp[j - fp];
+	    for (size_t k = k0; k < j; ++k)
+	      {
+		sum -= lp[k - fp] * lj[k - fj];
+	      }
+
+	    if (j < p)
+	      {
+		lp[j - fp] = sum / lj[j - fj];
+	      }
+	    else
+	      {
+		if (sum <= 0.0)  return false;
+		lp[j - fp] = std::sqrt(sum);
+	      }
+	  }
+	return true;
+      }
+
+      std::vector<size_t> mPerm;      ///< Original index at each position
+      std::vector<size_t> mInvPerm;   ///< Position of each original index
+      std::vector<size_t> mFirst;     ///< First column of each row envelope
+      std::vector<size_t> mStart;     ///< Offset of each row in mValues
+      std::vector<double> mValues;    ///< Rows of L inside the envelope
+    };
+
+  } //namespace utils
+} //namespace bayesopt
+
+#endif
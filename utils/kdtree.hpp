@@ -0,0 +1,260 @@
+/**  \file kdtree.hpp \brief K-d tree for nearest neighbour queries */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef _KDTREE_HPP_
+#define _KDTREE_HPP_
+
+#include <vector>
+#include <queue>
+#include <cmath>
+#include <algorithm>
+#include "specialtypes.hpp"
+
+namespace bayesopt
+{
+  namespace utils
+  {
+    /** 
+     * \brief K-d tree over a set of points. Points can be inserted
+     * incrementally (the tree is rebuilt if it gets too unbalanced)
+     * and are identified by their insertion order, like the samples
+     * in a Dataset. Queries are O(log n) on average for low and
+     * moderate dimensions.
+     */
+    class KDTree
+    {
+    public:
+      KDTree(): mRoot(NONE) {};
+      virtual ~KDTree() {};
+
+      /** Removes all the points */
+      void clear()
+      { mPoints.clear(); mNodes.clear(); mRoot = NONE; };
+
+      /** Builds a balanced tree from scratch */
+      void build(const vecOfvec& points)
+      {
+	clear();
+	mPoints = points;
+	rebuild();
+      };
+
+      /** 
+       * \brief Adds a point at the bottom of the tree.
+       * @return index of the point
+       */
+      size_t insert(const vectord& x)
+      {
+	const size_t index = mPoints.size();
+	mPoints.push_back(x);
+
+	size_t depth = 0;
+	if (mRoot == NONE)
+	  {
+	    mRoot = newNode(index,0);
+	  }
+	else
+	  {
+	    size_t node = mRoot;
+	    while (true)
+	      {
+		++depth;
+		Node& nd = mNodes[node];
+		size_t& child = (x(nd.axis) < mPoints[nd.point](nd.axis)) ? 
+		  nd.left : nd.right;
+		if (child == NONE)
+		  {
+		    const size_t axis = (nd.axis + 1) % x.size();
+		    const size_t created = newNode(index,axis);
+		    // newNode might reallocate mNodes
+		    if (x(mNodes[node].axis) < 
+			mPoints[mNodes[node].point](mNodes[node].axis))
+		      mNodes[node].left = created;
+		    else
+		      mNodes[node].right = created;
+		    break;
+		  }
+		node = child;
+	      }
+	  }
+
+	// Too deep compared to a balanced tree
+	if (depth > 2*std::log(static_cast<double>(mPoints.size()))/std::log(2.0) + 8)
+	  {
+	    rebuild();
+	  }
+	return index;
+      };
+
+      /** Number of points */
+      size_t size() const { return mPoints.size(); };
+
+      /** 
+       * \brief Nearest point to the query.
+       * @param dist [out] Euclidean distance to the nearest point
+       * @return index of the nearest point (size() if empty)
+       */
+      size_t nearest(const vectord& query, double& dist) const
+      {
+	std::vector<size_t> result;
+	knn(query,1,result);
+	if (result.empty())
+	  {
+	    dist = HUGE_VAL;
+	    return mPoints.size();
+	  }
+	dist = norm_2(query - mPoints[result[0]]);
+	return result[0];
+      };
+
+      /** 
+       * \brief Indexes of the k nearest points to the query, sorted
+       * by increasing distance. 
+       */
+      void knn(const vectord& query, size_t k, 
+	       std::vector<size_t>& result) const
+      {
+	result.clear();
+	if ((k == 0) || (mRoot == NONE))  return;
+
+	Heap heap;
+	searchKnn(mRoot,query,k,heap);
+	result.resize(heap.size());
+	for (size_t ii = heap.size(); ii > 0; --ii)
+	  {
+	    result[ii-1] = heap.top().second;
+	    heap.pop();
+	  }
+      };
+
+      /** Indexes of the points within a distance r of the query */
+      void radius(const vectord& query, double r,
+		  std::vector<size_t>& result) const
+      {
+	result.clear();
+	if (mRoot != NONE)  searchRadius(mRoot,query,r*r,result);
+      };
+
+    private:
+      static const size_t NONE = static_cast<size_t>(-1);
+
+      struct Node
+      {
+	size_t point, axis, left, right;
+      };
+
+      typedef std::pair<double,size_t> Candidate;
+      typedef std::priority_queue<Candidate> Heap;    ///< max-heap
+
+      size_t newNode(size_t point, size_t axis)
+      {
+	Node nd = {point, axis, NONE, NONE};
+	mNodes.push_back(nd);
+	return mNodes.size()-1;
+      };
+
+      void rebuild()
+      {
+	mNodes.clear();
+	mNodes.reserve(mPoints.size());
+	std::vector<size_t> idx(mPoints.size());
+	for (size_t ii = 0; ii < idx.size(); ++ii)  idx[ii] = ii;
+	mRoot = buildRange(idx,0,idx.size(),0);
+      };
+
+      /** Median split of idx[begin,end) */
+      size_t buildRange(std::vector<size_t>& idx, size_t begin, size_t end,
+			size_t axis)
+      {
+	if (begin >= end)  return NONE;
+	const size_t mid = begin + (end - begin) / 2;
+	std::nth_element(idx.begin()+begin, idx.begin()+mid, idx.begin()+end,
+			 AxisLess(mPoints,axis));
+	const size_t node = newNode(idx[mid],axis);
+	const size_t next = (axis + 1) % mPoints[idx[mid]].size();
+	const size_t left = buildRange(idx,begin,mid,next);
+	const size_t right = buildRange(idx,mid+1,end,next);
+	mNodes[node].left = left;
+	mNodes[node].right = right;
+	return node;
+      };
+
+      void searchKnn(size_t node, const vectord& query, size_t k, 
+		     Heap& heap) const
+      {
+	if (node == NONE)  return;
+	const Node& nd = mNodes[node];
+	const vectord& p = mPoints[nd.point];
+
+	const double d2 = inner_prod(query-p,query-p);
+	if (heap.size() < k)  heap.push(Candidate(d2,nd.point));
+	else if (d2 < heap.top().first)
+	  {
+	    heap.pop();
+	    heap.push(Candidate(d2,nd.point));
+	  }
+
+	const double diff = query(nd.axis) - p(nd.axis);
+	const size_t nearSide = (diff < 0) ? nd.left : nd.right;
+	const size_t farSide = (diff < 0) ? nd.right : nd.left;
+	searchKnn(nearSide,query,k,heap);
+	if ((heap.size() < k) || (diff*diff < heap.top().first))
+	  {
+	    searchKnn(farSide,query,k,heap);
+	  }
+      };
+
+      void searchRadius(size_t node, const vectord& query, double r2,
+			std::vector<size_t>& result) const
+      {
+	if (node == NONE)  return;
+	const Node& nd = mNodes[node];
+	const vectord& p = mPoints[nd.point];
+
+	if (inner_prod(query-p,query-p) <= r2)  result.push_back(nd.point);
+
+	const double diff = query(nd.axis) - p(nd.axis);
+	if ((diff < 0) || (diff*diff <= r2))  searchRadius(nd.left,query,r2,result);
+	if ((diff >= 0) || (diff*diff <= r2)) searchRadius(nd.right,query,r2,result);
+      };
+
+      /** Comparison of points by one coordinate */
+      struct AxisLess
+      {
+	AxisLess(const vecOfvec& points, size_t axis): 
+	  mP(points), mAxis(axis) {};
+	bool operator()(size_t a, size_t b) const
+	{ return mP[a](mAxis) < mP[b](mAxis); };
+	const vecOfvec& mP;
+	size_t mAxis;
+      };
+
+      vecOfvec mPoints;
+      std::vector<Node> mNodes;
+      size_t mRoot;
+    };
+
+  } //namespace utils
+} //namespace bayesopt
+
+#endif
@@ -27,6 +27,7 @@
 #include "randgen.hpp"
 #include "log.hpp"
 #include "indexvector.hpp"
+#include "spinlock.hpp"
 #if defined (USE_SOBOL)
 #  include "sobol.hpp"
 #endif
@@ -110,15 +111,28 @@ namespace bayesopt
     }
 
 #if defined (USE_SOBOL)
+    /** The Sobol library keeps its state in static variables, thus
+	concurrent optimizers must not call it at the same time. */
+    inline SpinLock& sobolMutex()
+    {
+      static SpinLock lock;
+      return lock;
+    }
+
     template<class M>
     void sobol(M& result, long long int seed)
     {
       size_t nSamples = result.size1();
       size_t nDims = result.size2();
 
-      double *sobol_seq = i8_sobol_generate(nDims,nSamples,seed);
+      double *sobol_seq;
+      {
+	SpinLockGuard guard(sobolMutex());
+	sobol_seq = i8_sobol_generate(nDims,nSamples,seed);
+      }
 
       std::copy(sobol_seq,sobol_seq+nSamples*nDims,result.begin2());
+      delete [] sobol_seq;
     }
 #endif
 
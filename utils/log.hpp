@@ -35,6 +35,18 @@
 
   Usage:
      FILE_LOG(logWARNING) << "Ops, variable x should be " << expectedX << "; is " << realX;
+
+  Modified for BayesOpt:
+     - Levels above FILELOG_MAX_LEVEL are removed at compile time.
+     - If FILELOG_ASYNC is defined, records are pushed to a bounded
+       lock-free queue and written by a background thread. The
+       caller only pays for formatting the message. Errors and
+       Output2FILE::Flush() wait until the queue has been written.
+     - Log statements must be free of side effects, because they
+       are not evaluated if the level is disabled.
+     - ReportingLevel() and Stream() are the process defaults. While
+       a LogScope is alive, the messages of that thread use its own
+       level and stream instead (e.g.: one per optimizer).
 */
 
 #ifndef __LOG_HPP__
@@ -42,14 +54,74 @@
 
 #include <sstream>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include <cstdio>
+#include "atomic.hpp"
 
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+typedef SYSTEMTIME LogStamp;
+#else
+#  include <sys/time.h>
+#  include <unistd.h>
+#  ifdef FILELOG_ASYNC
+#    include <pthread.h>
+#  endif
+typedef struct timeval LogStamp;
+#endif
 
-inline std::string NowTime();
+#ifndef BAYESOPT_THREAD_LOCAL
+#  if defined(_MSC_VER)
+#    define BAYESOPT_THREAD_LOCAL __declspec(thread)
+#  else
+#    define BAYESOPT_THREAD_LOCAL __thread
+#  endif
+#endif
+
+inline LogStamp NowStamp();
+inline std::string NowTime(const LogStamp& stamp);
+inline std::string NowTime() { return NowTime(NowStamp()); }
 
 enum TLogLevel {logERROR, logWARNING, logINFO, logDEBUG, 
 		logDEBUG1, logDEBUG2, logDEBUG3, logDEBUG4};
 
+/** Level and output of a logger owned by an object. */
+struct LogSettings
+{
+    TLogLevel level;
+    FILE* stream;         ///< NULL disables the output
+};
+
+/** 
+ * While it is alive, the messages of the current thread use the
+ * settings given. Scopes can be nested. The settings must outlive
+ * the scope.
+ */
+class LogScope
+{
+public:
+    explicit LogScope(const LogSettings& settings): mPrevious(Active())
+    { Active() = &settings; }
+    ~LogScope() 
+    { Active() = mPrevious; }
+
+    /** Settings of the current thread or NULL (process defaults). */
+    static const LogSettings*& Active()
+    {
+	static BAYESOPT_THREAD_LOCAL const LogSettings* active = NULL;
+	return active;
+    }
+private:
+    const LogSettings* mPrevious;
+
+    LogScope(const LogScope&);
+    LogScope& operator =(const LogScope&);
+};
+
 template <typename T>
 class Log
 {
@@ -59,24 +131,29 @@ public:
     std::ostringstream& Get(TLogLevel level = logINFO);
 public:
     static TLogLevel& ReportingLevel();
+    /** Level of the current thread (LogScope or default). */
+    static TLogLevel Level();
     static std::string ToString(TLogLevel level);
     static TLogLevel FromString(const std::string& level);
 protected:
     std::ostringstream os;
+    TLogLevel mLevel;
+    LogStamp mStamp;      ///< Time is formatted by the writer
 private:
     Log(const Log&);
     Log& operator =(const Log&);
 };
 
 template <typename T>
-Log<T>::Log()
+Log<T>::Log(): mLevel(logINFO)
 {
 }
 
 template <typename T>
 std::ostringstream& Log<T>::Get(TLogLevel level)
 {
-    os << "- " << NowTime();
+    mLevel = level;
+    mStamp = NowStamp();
     os << " " << ToString(level) << ": ";
     os << std::string(level > logDEBUG ? level - logDEBUG : 0, '\t');
     return os;
@@ -86,16 +163,24 @@ template <typename T>
 Log<T>::~Log()
 {
     os << std::endl;
-    T::Output(os.str());
+    std::string msg = os.str();
+    T::Output(mLevel, mStamp, msg);
 }
 
 template <typename T>
 TLogLevel& Log<T>::ReportingLevel()
 {
-    static TLogLevel reportingLevel = logDEBUG4;
+    static TLogLevel reportingLevel = logINFO;   // Default verbose_level
     return reportingLevel;
 }
 
+template <typename T>
+TLogLevel Log<T>::Level()
+{
+    const LogSettings* settings = LogScope::Active();
+    return settings ? settings->level : ReportingLevel();
+}
+
 template <typename T>
 std::string Log<T>::ToString(TLogLevel level)
 {
@@ -130,24 +215,283 @@ class Output2FILE
 {
 public:
     static FILE*& Stream();
-    static void Output(const std::string& msg);
+    /** Stream of the current thread (LogScope or default). */
+    static FILE* Current();
+    /** Sends a record. The content of msg might be consumed. */
+    static void Output(TLogLevel level, const LogStamp& stamp, 
+		       std::string& msg);
+    /** Waits until every record has been written. Call it before
+     *  changing or closing the stream. */
+    static void Flush();
+    /** Writes a record synchronously (without flushing). */
+    static void Write(FILE* pStream, const LogStamp& stamp, 
+		      const std::string& msg);
 };
 
+#ifdef FILELOG_ASYNC
+
+/** 
+ * Background writer. Records are stored in a bounded lock-free queue
+ * (Vyukov's MPMC ring, used here with a single consumer). Producers
+ * only wait if the queue is full. The records are written in batches
+ * of at most CAPACITY and the streams are flushed after every batch,
+ * so Flush returns even if other threads keep logging.
+ */
+class LogWriter
+{
+public:
+    static const unsigned long CAPACITY = 1024;  // Power of 2
+
+    /** Writer, started the first time it is needed. NULL after it
+     *  has been destroyed (exit). */
+    static LogWriter* Instance();
+    /** Running writer or NULL. Does not start it. */
+    static LogWriter*& Current();
+
+    ~LogWriter();
+    bool Push(FILE* pStream, const LogStamp& stamp, std::string& msg);
+    void Flush();
+
+private:
+    struct Record 
+    {
+	bayesopt::utils::Atomic<unsigned long> seq;
+	FILE* stream;
+	LogStamp stamp;
+	std::string msg;
+    };
+
+    LogWriter();
+    bool Pop(FILE*& pStream, LogStamp& stamp, std::string& msg);
+    void Loop();
+
+    static bool& Down();
+    static void SleepMicro(unsigned int usec);
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+    static DWORD WINAPI Run(LPVOID self);
+    HANDLE mThread;
+#else
+    static void* Run(void* self);
+    pthread_t mThread;
+#endif
+
+    std::vector<Record> mRecords;
+    bayesopt::utils::Atomic<unsigned long> mPushPos;
+    bayesopt::utils::Atomic<unsigned long> mPopPos;
+    bayesopt::utils::Atomic<unsigned long> mFlushedPos;  ///< Written and flushed
+    bayesopt::utils::Atomic<bool> mStop;
+    bool mRunning;
+
+    LogWriter(const LogWriter&);
+    LogWriter& operator =(const LogWriter&);
+};
+
+inline LogWriter::LogWriter():
+    mRecords(CAPACITY), mPushPos(0), mPopPos(0), mFlushedPos(0),
+    mStop(false)
+{
+    for (unsigned long i = 0; i < CAPACITY; ++i)  mRecords[i].seq.store(i);
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+    mThread = CreateThread(NULL, 0, &LogWriter::Run, this, 0, NULL);
+    mRunning = (mThread != NULL);
+#else
+    mRunning = (pthread_create(&mThread, NULL, &LogWriter::Run, this) == 0);
+#endif
+    if (mRunning)  Current() = this;
+}
+
+inline LogWriter::~LogWriter()
+{
+    Current() = NULL;
+    Down() = true;
+    if (!mRunning)  return;
+    mStop.store(true);     // The writer drains the queue before leaving
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+    WaitForSingleObject(mThread, INFINITE);
+    CloseHandle(mThread);
+#else
+    pthread_join(mThread, NULL);
+#endif
+}
+
+inline LogWriter* LogWriter::Instance()
+{
+    if (Down())  return NULL;
+    static LogWriter writer;
+    return &writer;
+}
+
+inline LogWriter*& LogWriter::Current()
+{
+    static LogWriter* current = NULL;
+    return current;
+}
+
+inline bool& LogWriter::Down()
+{
+    static bool down = false;   // POD, still valid after exit
+    return down;
+}
+
+inline void LogWriter::SleepMicro(unsigned int usec)
+{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+    Sleep(usec < 1000 ? 1 : usec / 1000);
+#else
+    usleep(usec);
+#endif
+}
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+inline DWORD WINAPI LogWriter::Run(LPVOID self)
+{
+    static_cast<LogWriter*>(self)->Loop();
+    return 0;
+}
+#else
+inline void* LogWriter::Run(void* self)
+{
+    static_cast<LogWriter*>(self)->Loop();
+    return NULL;
+}
+#endif
+
+inline bool LogWriter::Push(FILE* pStream, const LogStamp& stamp, 
+			    std::string& msg)
+{
+    if (!mRunning)  return false;
+
+    unsigned long pos = mPushPos.load();
+    Record* rec;
+    for (;;)
+    {
+	rec = &mRecords[pos & (CAPACITY - 1)];
+	const unsigned long seq = rec->seq.load();
+	const long dif = static_cast<long>(seq - pos);
+	if (dif == 0)
+	{
+	    if (mPushPos.compareExchange(pos, pos + 1))  break;
+	}
+	else if (dif < 0)   // Full. Wait for the writer.
+	{
+	    SleepMicro(100);
+	}
+	pos = mPushPos.load();
+    }
+    rec->stream = pStream;
+    rec->stamp = stamp;
+    rec->msg.swap(msg);
+    rec->seq.store(pos + 1);
+    return true;
+}
+
+inline bool LogWriter::Pop(FILE*& pStream, LogStamp& stamp, 
+			   std::string& msg)
+{
+    const unsigned long pos = mPopPos.load();
+    Record& rec = mRecords[pos & (CAPACITY - 1)];
+    const unsigned long seq = rec.seq.load();
+    if (static_cast<long>(seq - (pos + 1)) < 0)  return false;
+
+    pStream = rec.stream;
+    stamp = rec.stamp;
+    msg.swap(rec.msg);
+    mPopPos.store(pos + 1);
+    rec.seq.store(pos + CAPACITY);
+    return true;
+}
+
+inline void LogWriter::Flush()
+{
+    const unsigned long target = mPushPos.load();
+    while (static_cast<long>(mFlushedPos.load() - target) < 0)  
+	SleepMicro(100);
+}
+
+inline void LogWriter::Loop()
+{
+    FILE* pStream;
+    LogStamp stamp;
+    std::string msg;
+    std::vector<FILE*> written;   // Streams pending of fflush
+    unsigned int idle = 0;
+    for (;;)
+    {
+	unsigned long n = 0;
+	while ((n < CAPACITY) && Pop(pStream, stamp, msg))
+	{
+	    Output2FILE::Write(pStream, stamp, msg);
+	    if (std::find(written.begin(), written.end(), pStream) 
+		== written.end())
+		written.push_back(pStream);
+	    ++n;
+	}
+	if (n > 0)   // Publish the batch before taking more records
+	{
+	    for (size_t i = 0; i < written.size(); ++i)  fflush(written[i]);
+	    written.clear();
+	    mFlushedPos.store(mPopPos.load());
+	    idle = 0;
+	    continue;
+	}
+	if (mStop.load())  return;
+	// Back off while there is nothing to do
+	SleepMicro(idle < 10 ? 100 : 10000);
+	++idle;
+    }
+}
+
+#endif // FILELOG_ASYNC
+
 inline FILE*& Output2FILE::Stream()
 {
     static FILE* pStream = stdout;
     return pStream;
 }
 
-inline void Output2FILE::Output(const std::string& msg)
+inline FILE* Output2FILE::Current()
+{
+    const LogSettings* settings = LogScope::Active();
+    return settings ? settings->stream : Stream();
+}
+
+inline void Output2FILE::Write(FILE* pStream, const LogStamp& stamp, 
+			       const std::string& msg)
+{
+    if (!pStream)
+        return;
+    fprintf(pStream, "- %s%s", NowTime(stamp).c_str(), msg.c_str());
+}
+
+inline void Output2FILE::Output(TLogLevel level, const LogStamp& stamp,
+				std::string& msg)
 {   
-    FILE* pStream = Stream();
+    FILE* pStream = Current();
     if (!pStream)
         return;
-    fprintf(pStream, "%s", msg.c_str());
+#ifdef FILELOG_ASYNC
+    LogWriter* writer = LogWriter::Instance();
+    if (writer && writer->Push(pStream, stamp, msg))
+    {
+	if (level == logERROR)  writer->Flush();
+	return;
+    }
+#endif
+    Write(pStream, stamp, msg);
     fflush(pStream);
 }
 
+inline void Output2FILE::Flush()
+{
+#ifdef FILELOG_ASYNC
+    LogWriter* writer = LogWriter::Current();
+    if (writer)  writer->Flush();
+#endif
+    FILE* pStream = Current();
+    if (pStream)  fflush(pStream);
+}
+
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
 #   if defined (BUILDING_FILELOG_DLL)
 #       define FILELOG_DECLSPEC   __declspec (dllexport)
@@ -169,55 +513,48 @@ class FILELOG_DECLSPEC FILELog : public Log<Output2FILE> {};
 
 #define FILE_LOG(level) \
     if (level > FILELOG_MAX_LEVEL) ;\
-    else if (level > FILELog::ReportingLevel() || !Output2FILE::Stream()) ; \
+    else if (level > FILELog::Level() || !Output2FILE::Current()) ; \
     else FILELog().Get(level)
 
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
 
-#ifndef NOMINMAX
-#  define NOMINMAX
-#endif
-#include <windows.h>
+inline LogStamp NowStamp()
+{
+    SYSTEMTIME stamp;
+    GetLocalTime(&stamp);
+    return stamp;
+}
 
-inline std::string NowTime()
+inline std::string NowTime(const LogStamp& stamp)
 {
     const int MAX_LEN = 200;
     char buffer[MAX_LEN];
-    if (GetTimeFormatA(LOCALE_USER_DEFAULT, 0, 0, 
+    if (GetTimeFormatA(LOCALE_USER_DEFAULT, 0, &stamp, 
             "HH':'mm':'ss", buffer, MAX_LEN) == 0)
         return "Error in NowTime()";
 
     char result[100] = {0};
-    static DWORD first = GetTickCount();
-    std::sprintf(result, "%s.%03ld", buffer, (long)(GetTickCount() - first) % 1000); 
+    std::sprintf(result, "%s.%03d", buffer, (int)stamp.wMilliseconds); 
     return result;
 }
 
 #else
 
-#include <sys/time.h>
-
-inline std::string NowTime()
+inline LogStamp NowStamp()
 {
   struct timeval tv;
   gettimeofday(&tv, 0);
+  return tv;
+}
+
+inline std::string NowTime(const LogStamp& tv)
+{
   char buffer[11];
   tm r = {0};
   strftime(buffer, sizeof(buffer), "%X", localtime_r(&tv.tv_sec, &r));
   char result[100] = {0};
   std::sprintf(result, "%s.%06ld", buffer, (long)tv.tv_usec);
   return result;
-
-    // char buffer[11];
-    // time_t t;
-    // time(&t);
-    // tm r = {0};
-    // strftime(buffer, sizeof(buffer), "%X", localtime_r(&t, &r));
-    // struct timeval tv;
-    // gettimeofday(&tv, 0);
-    // char result[100] = {0};
-    // std::sprintf(result, "%s.%03ld", buffer, (long)tv.tv_usec / 1000); 
-    // return result;
 }
 
 #endif //WIN32
@@ -0,0 +1,175 @@
+/** \file philox.hpp 
+    \brief Counter-based random engine with independent streams */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef  _PHILOX_HPP_
+#define  _PHILOX_HPP_
+
+#include <boost/cstdint.hpp>
+#include <boost/config.hpp>
+
+namespace bayesopt {
+  namespace utils {
+
+    /**
+     * \brief Philox4x32-10 counter-based random engine.
+     *
+     * Each block of four numbers is a keyed bijection of a counter
+     * (Salmon et al. "Parallel random numbers: as easy as 1, 2, 3",
+     * SC 2011). The key is the seed and the counter holds the stream
+     * id and the position in that stream. Therefore, streams with
+     * different ids are independent and any stream can be created
+     * from the seed alone (see split), without sharing state. This
+     * way, each component (or parallel task) draws its own numbers
+     * and the results do not depend on the order of execution.
+     *
+     * It follows the uniform random number generator concept, so it
+     * can be used with the Boost distributions (see randgen.hpp).
+     */
+    class Philox4x32
+    {
+    public:
+      typedef boost::uint32_t result_type;
+      BOOST_STATIC_CONSTANT(bool, has_fixed_range = false);
+      BOOST_STATIC_CONSTANT(boost::uint32_t, default_seed = 5489u);
+
+      Philox4x32();
+      explicit Philox4x32(boost::uint64_t value, boost::uint64_t stream = 0);
+
+      /** Sets the key and rewinds the current stream. */
+      void seed(boost::uint64_t value = default_seed);
+
+      /** Engine with the same seed over a different stream. */
+      Philox4x32 split(boost::uint64_t stream) const;
+
+      boost::uint64_t getStream() const { return mStream; };
+
+      /** Advances the engine n numbers. */
+      void discard(boost::uint64_t n);
+
+      result_type operator()();
+
+      static result_type (min)() { return 0; };
+      static result_type (max)() { return 0xFFFFFFFFu; };
+
+      friend bool operator==(const Philox4x32& a, const Philox4x32& b);
+      friend bool operator!=(const Philox4x32& a, const Philox4x32& b)
+      { return !(a == b); };
+
+      /** Philox4x32-10 bijection. The result overwrites the counter. */
+      static void block(boost::uint32_t ctr[4], const boost::uint32_t key[2]);
+
+    private:
+      void generateBlock();
+
+      boost::uint32_t mKey[2];
+      boost::uint64_t mStream;         ///< Stream id (high half of the counter)
+      boost::uint64_t mPosition;       ///< Next block (low half of the counter)
+      boost::uint32_t mBuffer[4];      ///< Last block
+      unsigned int mIndex;             ///< Next number in mBuffer
+    };
+
+
+    inline Philox4x32::Philox4x32(): mStream(0)
+    { seed(default_seed); }
+
+    inline Philox4x32::Philox4x32(boost::uint64_t value, 
+				  boost::uint64_t stream): mStream(stream)
+    { seed(value); }
+
+    inline void Philox4x32::seed(boost::uint64_t value)
+    {
+      mKey[0] = static_cast<boost::uint32_t>(value);
+      mKey[1] = static_cast<boost::uint32_t>(value >> 32);
+      mPosition = 0;
+      mIndex = 4;
+    }
+
+    inline Philox4x32 Philox4x32::split(boost::uint64_t stream) const
+    {
+      Philox4x32 other(*this);
+      other.mStream = stream;
+      other.mPosition = 0;
+      other.mIndex = 4;
+      return other;
+    }
+
+    inline void Philox4x32::discard(boost::uint64_t n)
+    {
+      while ((n > 0) && (mIndex < 4)) { ++mIndex; --n; }
+      mPosition += n / 4;
+      if (n % 4 != 0)
+	{
+	  generateBlock();
+	  mIndex = static_cast<unsigned int>(n % 4);
+	}
+    }
+
+    inline Philox4x32::result_type Philox4x32::operator()()
+    {
+      if (mIndex == 4) generateBlock();
+      return mBuffer[mIndex++];
+    }
+
+    inline bool operator==(const Philox4x32& a, const Philox4x32& b)
+    {
+      // Same key and same number of outputs in the same stream.
+      return (a.mKey[0] == b.mKey[0]) && (a.mKey[1] == b.mKey[1]) &&
+	(a.mStream == b.mStream) && 
+	(4*a.mPosition + a.mIndex == 4*b.mPosition + b.mIndex);
+    }
+
+    inline void Philox4x32::block(boost::uint32_t ctr[4], 
+				  const boost::uint32_t key[2])
+    {
+      const boost::uint64_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+      boost::uint32_t k0 = key[0], k1 = key[1];
+      for (int round = 0; round < 10; ++round)
+	{
+	  const boost::uint64_t p0 = M0 * ctr[0];
+	  const boost::uint64_t p1 = M1 * ctr[2];
+	  const boost::uint32_t hi0 = static_cast<boost::uint32_t>(p0 >> 32);
+	  const boost::uint32_t hi1 = static_cast<boost::uint32_t>(p1 >> 32);
+	  ctr[0] = hi1 ^ ctr[1] ^ k0;
+	  ctr[1] = static_cast<boost::uint32_t>(p1);
+	  ctr[2] = hi0 ^ ctr[3] ^ k1;
+	  ctr[3] = static_cast<boost::uint32_t>(p0);
+	  k0 += 0x9E3779B9u;  k1 += 0xBB67AE85u;      // Weyl sequence
+	}
+    }
+
+    inline void Philox4x32::generateBlock()
+    {
+      mBuffer[0] = static_cast<boost::uint32_t>(mPosition);
+      mBuffer[1] = static_cast<boost::uint32_t>(mPosition >> 32);
+      mBuffer[2] = static_cast<boost::uint32_t>(mStream);
+      mBuffer[3] = static_cast<boost::uint32_t>(mStream >> 32);
+      block(mBuffer,mKey);
+      ++mPosition;
+      mIndex = 0;
+    }
+
+  } //namespace utils
+} //namespace bayesopt
+
+#endif
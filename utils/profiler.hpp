@@ -0,0 +1,248 @@
+/**  \file profiler.hpp \brief Lightweight instrumentation of the optimization */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef  _PROFILER_HPP_
+#define  _PROFILER_HPP_
+
+#include <algorithm>
+#include <vector>
+#include "parameters.h"
+#include "atomic.hpp"
+#include "tracer.hpp"
+
+namespace bayesopt 
+{  
+  namespace utils 
+  {
+    /** Phases of the optimization with their own timer. */
+    enum ProfilePhase
+      {
+	PHASE_LEARNING = 0,      ///< Hyperparameter learning
+	PHASE_FIT,               ///< Full fit of the surrogate model
+	PHASE_UPDATE,            ///< Incremental update of the surrogate model
+	PHASE_CRITERIA,          ///< Optimization of the criteria
+	PHASE_EVALUATION,        ///< Evaluation of the target function
+	N_PHASES
+      };
+
+    /** Events counted during the optimization. */
+    enum ProfileCounter
+      {
+	COUNT_KERNEL = 0,        ///< Kernel function evaluations
+	COUNT_CHOLESKY,          ///< Cholesky factorizations
+	COUNT_CRITERIA,          ///< Criteria evaluations
+	COUNT_LIKELIHOOD,        ///< Score (likelihood) evaluations
+	N_COUNTERS
+      };
+
+    /** Name of the phase (also used for trace spans). */
+    inline const char* phaseName(ProfilePhase phase)
+    {
+      static const char* names[N_PHASES] = 
+	{"learning", "fit", "update", "criteria", "evaluation"};
+      return names[phase];
+    }
+
+    /** 
+     * \brief Time and counters of every iteration of the optimization.
+     * 
+     * Timers are added by the optimizer (see ProfileTimer). Counters
+     * are incremented from anywhere in the library through
+     * Profiler::count, which only has an effect if there is a profiler
+     * active in the calling thread (see ProfilerActivation). The
+     * workers of a ThreadPool use the profiler of the caller of run,
+     * thus the counters are atomic.
+     */
+    class Profiler
+    {
+    public:
+      Profiler();
+
+      /** Removes all the data and starts the record of the
+	  initialization (iteration 0). */
+      void reset();
+
+      /** Starts the record of a new iteration. */
+      void startIteration();
+
+      void addTime(ProfilePhase phase, double seconds);
+      void addCount(ProfileCounter counter, size_t n);
+
+      /** Adds all the records of other (e.g.: work done in another
+	  thread) to the current record. */
+      void merge(const Profiler& other);
+
+      /** Number of records (initialization and iterations). */
+      size_t getNRecords() const;
+
+      /** Record of the initialization (0) or an iteration (>0). */
+      bopt_profile getRecord(size_t index) const;
+
+      /** Sum of all the records. */
+      bopt_profile getTotal() const;
+
+      /** Profiler active in the calling thread (NULL if none). */
+      static Profiler*& active();
+
+      /** Increments a counter of the active profiler (if any). */
+      static void count(ProfileCounter counter, size_t n = 1);
+
+    private:
+      struct Record
+      {
+	double time[N_PHASES];
+	Atomic<size_t> count[N_COUNTERS];
+      };
+
+      static bopt_profile toProfile(const Record& record, size_t iteration);
+
+      std::vector<Record> mRecords;
+    };
+
+    /** Makes a profiler active in the calling thread during its scope. */
+    class ProfilerActivation
+    {
+    public:
+      explicit ProfilerActivation(Profiler& profiler):
+	mPrevious(Profiler::active())
+      { Profiler::active() = &profiler; };
+
+      ~ProfilerActivation()
+      { Profiler::active() = mPrevious; };
+
+    private:
+      Profiler* mPrevious;
+    };
+
+    /** Adds the wall time of its scope to a phase. It is also
+	recorded as a trace span (if the tracer is enabled). */
+    class ProfileTimer
+    {
+    public:
+      ProfileTimer(Profiler& profiler, ProfilePhase phase):
+	mProfiler(profiler), mPhase(phase), mStart(wallTime())
+      {};
+
+      ~ProfileTimer()
+      { 
+	const double end = wallTime();
+	mProfiler.addTime(mPhase, end - mStart); 
+	if (Tracer::isEnabled())  Tracer::record(phaseName(mPhase),mStart,end);
+      };
+
+    private:
+      Profiler& mProfiler;
+      ProfilePhase mPhase;
+      double mStart;
+    };
+
+
+    //// Inline methods
+
+    inline Profiler::Profiler()
+    { reset(); }
+
+    inline void Profiler::reset()
+    {
+      mRecords.clear();
+      startIteration();
+    }
+
+    inline void Profiler::startIteration()
+    {
+      Record record;
+      std::fill(record.time, record.time + N_PHASES, 0.0);
+      mRecords.push_back(record);
+    }
+
+    inline void Profiler::addTime(ProfilePhase phase, double seconds)
+    { mRecords.back().time[phase] += seconds; }
+
+    inline void Profiler::addCount(ProfileCounter counter, size_t n)
+    { mRecords.back().count[counter].fetchAdd(n); }
+
+    inline void Profiler::merge(const Profiler& other)
+    {
+      for (size_t i = 0; i < other.mRecords.size(); ++i)
+	{
+	  for (size_t j = 0; j < N_PHASES; ++j)
+	    mRecords.back().time[j] += other.mRecords[i].time[j];
+	  for (size_t j = 0; j < N_COUNTERS; ++j)
+	    mRecords.back().count[j].fetchAdd(
+	      other.mRecords[i].count[j].load());
+	}
+    }
+
+    inline size_t Profiler::getNRecords() const
+    { return mRecords.size(); }
+
+    inline bopt_profile Profiler::getRecord(size_t index) const
+    { return toProfile(mRecords.at(index), index); }
+
+    inline bopt_profile Profiler::getTotal() const
+    {
+      Record total = mRecords[0];
+      for (size_t i = 1; i < mRecords.size(); ++i)
+	{
+	  for (size_t j = 0; j < N_PHASES; ++j)
+	    total.time[j] += mRecords[i].time[j];
+	  for (size_t j = 0; j < N_COUNTERS; ++j)
+	    total.count[j].fetchAdd(mRecords[i].count[j].load());
+	}
+      return toProfile(total, mRecords.size()-1);
+    }
+
+    inline Profiler*& Profiler::active()
+    {
+      static BAYESOPT_THREAD_LOCAL Profiler* profiler = NULL;
+      return profiler;
+    }
+
+    inline void Profiler::count(ProfileCounter counter, size_t n)
+    {
+      Profiler* profiler = active();
+      if (profiler != NULL)  profiler->addCount(counter,n);
+    }
+
+    inline bopt_profile Profiler::toProfile(const Record& record, 
+					    size_t iteration)
+    {
+      bopt_profile profile;
+      profile.iteration        = iteration;
+      profile.t_learning       = record.time[PHASE_LEARNING];
+      profile.t_fit            = record.time[PHASE_FIT];
+      profile.t_update         = record.time[PHASE_UPDATE];
+      profile.t_criteria       = record.time[PHASE_CRITERIA];
+      profile.t_evaluation     = record.time[PHASE_EVALUATION];
+      profile.n_kernel         = record.count[COUNT_KERNEL].load();
+      profile.n_cholesky       = record.count[COUNT_CHOLESKY].load();
+      profile.n_criteria       = record.count[COUNT_CRITERIA].load();
+      profile.n_likelihood     = record.count[COUNT_LIKELIHOOD].load();
+      return profile;
+    }
+
+  } //namespace utils
+
+} //namespace bayesopt
+
+#endif
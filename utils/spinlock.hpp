@@ -0,0 +1,89 @@
+/** \file spinlock.hpp 
+    \brief Minimal lock for short critical sections */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef _SPINLOCK_HPP_
+#define _SPINLOCK_HPP_
+
+#if defined(_MSC_VER)
+#  include <intrin.h>
+#endif
+
+namespace bayesopt 
+{  
+  namespace utils 
+  {
+    /** 
+     * \brief Busy-wait lock for very short critical sections, or for
+     * those that are rarely contended. It avoids linking a threading
+     * library.
+     */
+    class SpinLock
+    {
+    public:
+      SpinLock(): mFlag(0) {};
+
+      void lock()
+      {
+#if defined(_MSC_VER)
+	while (_InterlockedExchange(&mFlag,1)) {}
+#else
+	while (__sync_lock_test_and_set(&mFlag,1)) {}
+#endif
+      };
+
+      void unlock()
+      {
+#if defined(_MSC_VER)
+	_InterlockedExchange(&mFlag,0);
+#else
+	__sync_lock_release(&mFlag);
+#endif
+      };
+
+    private:
+      volatile long mFlag;
+
+      SpinLock(const SpinLock&);
+      SpinLock& operator=(const SpinLock&);
+    };
+
+    /** Holds a SpinLock during its scope. */
+    class SpinLockGuard
+    {
+    public:
+      explicit SpinLockGuard(SpinLock& lock): mLock(lock)
+      { mLock.lock(); };
+
+      ~SpinLockGuard()
+      { mLock.unlock(); };
+
+    private:
+      SpinLock& mLock;
+    };
+
+  } //namespace utils
+
+} //namespace bayesopt
+
+#endif
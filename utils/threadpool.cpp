@@ -0,0 +1,507 @@
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+#include <stdexcept>
+#include "threadpool.hpp"
+#include "log.hpp"
+#include "profiler.hpp"
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(__WIN32__)
+#  include <unistd.h>
+#endif
+
+#ifndef BAYESOPT_THREAD_LOCAL
+#  if defined(_MSC_VER)
+#    define BAYESOPT_THREAD_LOCAL __declspec(thread)
+#  else
+#    define BAYESOPT_THREAD_LOCAL __thread
+#  endif
+#endif
+
+namespace bayesopt {
+  namespace utils {
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+#  define POOL_LOCK(m)       EnterCriticalSection(&m)
+#  define POOL_TRYLOCK(m)    (TryEnterCriticalSection(&m) != 0)
+#  define POOL_UNLOCK(m)     LeaveCriticalSection(&m)
+#  define POOL_WAIT(c,m)     SleepConditionVariableCS(&c,&m,INFINITE)
+#  define POOL_SIGNAL(c)     WakeConditionVariable(&c)
+#  define POOL_BROADCAST(c)  WakeAllConditionVariable(&c)
+#else
+#  define POOL_LOCK(m)       pthread_mutex_lock(&m)
+#  define POOL_TRYLOCK(m)    (pthread_mutex_trylock(&m) == 0)
+#  define POOL_UNLOCK(m)     pthread_mutex_unlock(&m)
+#  define POOL_WAIT(c,m)     pthread_cond_wait(&c,&m)
+#  define POOL_SIGNAL(c)     pthread_cond_signal(&c)
+#  define POOL_BROADCAST(c)  pthread_cond_broadcast(&c)
+#endif
+
+    ThreadPool::ThreadPool(size_t nThreads):
+      mGeneration(0), mActive(0), mStop(false), 
+      mNumThreads(nThreads ? nThreads : hardwareConcurrency()),
+      mTask(NULL), mLogSettings(NULL), mProfiler(NULL), mCancel(false)
+    {
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+      InitializeCriticalSection(&mRunMutex);
+      InitializeCriticalSection(&mMutex);
+      InitializeConditionVariable(&mWake);
+      InitializeConditionVariable(&mDone);
+#else
+      pthread_mutex_init(&mRunMutex,NULL);
+      pthread_mutex_init(&mMutex,NULL);
+      pthread_cond_init(&mWake,NULL);
+      pthread_cond_init(&mDone,NULL);
+#endif
+      mRanges = new Range[mNumThreads];
+
+      // Thread 0 is the caller of run.
+      mWorkers.resize(mNumThreads);
+      for (size_t i = 1; i < mNumThreads; ++i)
+	{
+	  Worker& w = mWorkers[i];
+	  w.pool = this;
+	  w.id = i;
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+	  w.thread = CreateThread(NULL, 0, &ThreadPool::Run, &w, 0, NULL);
+	  const bool started = (w.thread != NULL);
+#else
+	  const bool started = (pthread_create(&w.thread,NULL,
+					       &ThreadPool::Run,&w) == 0);
+#endif
+	  if (!started)     // Work with the threads we have
+	    {
+	      mNumThreads = i;
+	      mWorkers.resize(i);
+	    }
+	}
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+      POOL_LOCK(mMutex);
+      mStop = true;
+      POOL_BROADCAST(mWake);
+      POOL_UNLOCK(mMutex);
+
+      for (size_t i = 1; i < mWorkers.size(); ++i)
+	{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+	  WaitForSingleObject(mWorkers[i].thread, INFINITE);
+	  CloseHandle(mWorkers[i].thread);
+#else
+	  pthread_join(mWorkers[i].thread, NULL);
+#endif
+	}
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+      DeleteCriticalSection(&mRunMutex);
+      DeleteCriticalSection(&mMutex);
+#else
+      pthread_cond_destroy(&mDone);
+      pthread_cond_destroy(&mWake);
+      pthread_mutex_destroy(&mMutex);
+      pthread_mutex_destroy(&mRunMutex);
+#endif
+      delete [] mRanges;
+    }
+
+    size_t ThreadPool::getNumThreads() const
+    { return mNumThreads; }
+
+    size_t ThreadPool::hardwareConcurrency()
+    {
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+      SYSTEM_INFO info;
+      GetSystemInfo(&info);
+      const long n = static_cast<long>(info.dwNumberOfProcessors);
+#else
+      const long n = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+      return (n > 0) ? static_cast<size_t>(n) : 1;
+    }
+
+    ThreadPool*& ThreadPool::current()
+    {
+      static BAYESOPT_THREAD_LOCAL ThreadPool* pool = NULL;
+      return pool;
+    }
+
+    void ThreadPool::run(size_t nTasks, ParallelTask& task)
+    {
+      if ((nTasks < 2) || (mNumThreads < 2) || (current() != NULL))
+	{
+	  runSerial(nTasks,task);
+	  return;
+	}
+      if (!POOL_TRYLOCK(mRunMutex))   // Used by another thread
+	{
+	  runSerial(nTasks,task);
+	  return;
+	}
+
+      mTask = &task;
+      mLogSettings = LogScope::Active();
+      mProfiler = Profiler::active();
+      mCancel = false;
+      mError.clear();
+      for (size_t i = 0; i < mNumThreads; ++i)
+	{
+	  mRanges[i].begin = i * nTasks / mNumThreads;
+	  mRanges[i].end = (i+1) * nTasks / mNumThreads;
+	}
+
+      POOL_LOCK(mMutex);
+      mActive = mNumThreads - 1;
+      ++mGeneration;
+      POOL_BROADCAST(mWake);
+      POOL_UNLOCK(mMutex);
+
+      current() = this;
+      work(0);
+      current() = NULL;
+
+      // The task must outlive every worker in this run.
+      POOL_LOCK(mMutex);
+      while (mActive > 0)  POOL_WAIT(mDone,mMutex);
+      POOL_UNLOCK(mMutex);
+
+      mTask = NULL;
+      const bool failed = mCancel;
+      const std::string error = mError;
+      POOL_UNLOCK(mRunMutex);
+
+      if (failed)  throw std::runtime_error(error);
+    }
+
+    void ThreadPool::runSerial(size_t nTasks, ParallelTask& task)
+    {
+      for (size_t i = 0; i < nTasks; ++i)  task(i);
+    }
+
+    void ThreadPool::work(size_t id)
+    {
+      size_t index;
+      for (;;)
+	{
+	  if (!take(id,index))
+	    {
+	      if (!steal(id))  return;
+	      continue;
+	    }
+	  try
+	    {
+	      (*mTask)(index);
+	    }
+	  catch (std::exception& e)
+	    {
+	      fail(e.what());
+	    }
+	  catch (...)
+	    {
+	      fail("Unknown error in a parallel task.");
+	    }
+	}
+    }
+
+    bool ThreadPool::take(size_t id, size_t& index)
+    {
+      if (mCancel)  return false;
+      SpinLockGuard guard(mRanges[id].lock);
+      if (mRanges[id].begin >= mRanges[id].end)  return false;
+      index = mRanges[id].begin++;
+      return true;
+    }
+
+    bool ThreadPool::steal(size_t id)
+    {
+      for (size_t k = 1; (k < mNumThreads) && !mCancel; ++k)
+	{
+	  Range& victim = mRanges[(id + k) % mNumThreads];
+	  size_t begin, end;
+	  {
+	    SpinLockGuard guard(victim.lock);
+	    if (victim.begin >= victim.end)  continue;
+	    end = victim.end;
+	    begin = end - (victim.end - victim.begin + 1) / 2;
+	    victim.end = begin;
+	  }
+	  SpinLockGuard guard(mRanges[id].lock);
+	  mRanges[id].begin = begin;
+	  mRanges[id].end = end;
+	  return true;
+	}
+      return false;
+    }
+
+    void ThreadPool::fail(const std::string& msg)
+    {
+      SpinLockGuard guard(mErrorLock);
+      if (!mCancel)  mError = msg;
+      mCancel = true;
+    }
+
+    void ThreadPool::workerLoop(size_t id)
+    {
+      current() = this;
+      size_t generation = 0;
+      for (;;)
+	{
+	  POOL_LOCK(mMutex);
+	  while (!mStop && (mGeneration == generation))  
+	    POOL_WAIT(mWake,mMutex);
+	  if (mStop)
+	    {
+	      POOL_UNLOCK(mMutex);
+	      return;
+	    }
+	  generation = mGeneration;
+	  POOL_UNLOCK(mMutex);
+
+	  LogScope::Active() = mLogSettings;
+	  Profiler::active() = mProfiler;
+	  work(id);
+	  LogScope::Active() = NULL;
+	  Profiler::active() = NULL;
+
+	  POOL_LOCK(mMutex);
+	  if (--mActive == 0)  POOL_SIGNAL(mDone);
+	  POOL_UNLOCK(mMutex);
+	}
+    }
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+    DWORD WINAPI ThreadPool::Run(LPVOID worker)
+    {
+      Worker* w = static_cast<Worker*>(worker);
+      w->pool->workerLoop(w->id);
+      return 0;
+    }
+#else
+    void* ThreadPool::Run(void* worker)
+    {
+      Worker* w = static_cast<Worker*>(worker);
+      w->pool->workerLoop(w->id);
+      return NULL;
+    }
+#endif
+
+
+    AsyncTask::AsyncTask(): 
+      mRunning(false), mBusy(false), mStop(false), mTask(NULL), 
+      mFailed(false)
+    {
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+      InitializeCriticalSection(&mMutex);
+      InitializeConditionVariable(&mWake);
+      InitializeConditionVariable(&mDone);
+#else
+      pthread_mutex_init(&mMutex,NULL);
+      pthread_cond_init(&mWake,NULL);
+      pthread_cond_init(&mDone,NULL);
+#endif
+    }
+
+    AsyncTask::~AsyncTask()
+    {
+      try
+	{
+	  wait();
+	}
+      catch (...)
+	{
+	}
+
+      if (mRunning)
+	{
+	  POOL_LOCK(mMutex);
+	  mStop = true;
+	  POOL_SIGNAL(mWake);
+	  POOL_UNLOCK(mMutex);
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+	  WaitForSingleObject(mThread, INFINITE);
+	  CloseHandle(mThread);
+#else
+	  pthread_join(mThread, NULL);
+#endif
+	}
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+      DeleteCriticalSection(&mMutex);
+#else
+      pthread_cond_destroy(&mDone);
+      pthread_cond_destroy(&mWake);
+      pthread_mutex_destroy(&mMutex);
+#endif
+    }
+
+    void AsyncTask::start(ParallelTask& task)
+    {
+      wait();
+      mTask = &task;
+      mFailed = false;
+      mError.clear();
+      if (!mRunning)
+	{
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+	  mThread = CreateThread(NULL, 0, &AsyncTask::Run, this, 0, NULL);
+	  mRunning = (mThread != NULL);
+#else
+	  mRunning = (pthread_create(&mThread,NULL,&AsyncTask::Run,this) == 0);
+#endif
+	}
+      if (!mRunning)  
+	{
+	  execute();   // The error is reported by wait
+	  return;
+	}
+
+      POOL_LOCK(mMutex);
+      mBusy = true;
+      POOL_SIGNAL(mWake);
+      POOL_UNLOCK(mMutex);
+    }
+
+    void AsyncTask::wait()
+    {
+      POOL_LOCK(mMutex);
+      while (mBusy)  POOL_WAIT(mDone,mMutex);
+      POOL_UNLOCK(mMutex);
+
+      mTask = NULL;
+      if (mFailed)
+	{
+	  mFailed = false;
+	  throw std::runtime_error(mError);
+	}
+    }
+
+    bool AsyncTask::isStarted() const
+    { return mTask != NULL; }
+
+    void AsyncTask::execute()
+    {
+      try
+	{
+	  (*mTask)(0);
+	}
+      catch (std::exception& e)
+	{
+	  mError = e.what();
+	  mFailed = true;
+	}
+      catch (...)
+	{
+	  mError = "Unknown error in an asynchronous task.";
+	  mFailed = true;
+	}
+    }
+
+    void AsyncTask::workerLoop()
+    {
+      POOL_LOCK(mMutex);
+      for (;;)
+	{
+	  while (!mStop && !mBusy)  POOL_WAIT(mWake,mMutex);
+	  if (mStop)  break;
+	  POOL_UNLOCK(mMutex);
+
+	  execute();
+
+	  POOL_LOCK(mMutex);
+	  mBusy = false;
+	  POOL_SIGNAL(mDone);
+	}
+      POOL_UNLOCK(mMutex);
+    }
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+    DWORD WINAPI AsyncTask::Run(LPVOID task)
+    {
+      static_cast<AsyncTask*>(task)->workerLoop();
+      return 0;
+    }
+#else
+    void* AsyncTask::Run(void* task)
+    {
+      static_cast<AsyncTask*>(task)->workerLoop();
+      return NULL;
+    }
+#endif
+
+
+    ExecutorScope::ExecutorScope(Executor* executor): mPrevious(Active())
+    { Active() = executor; }
+
+    ExecutorScope::~ExecutorScope()
+    { Active() = mPrevious; }
+
+    Executor*& ExecutorScope::Active()
+    {
+      static BAYESOPT_THREAD_LOCAL Executor* executor = NULL;
+      return executor;
+    }
+
+
+    namespace
+    {
+      class ChunkTask: public ParallelTask
+      {
+      public:
+	ChunkTask(size_t begin, size_t end, size_t grain, RangeTask& body):
+	  mBegin(begin), mEnd(end), mGrain(grain), mBody(body) {};
+
+	void operator()(size_t index)
+	{
+	  const size_t b = mBegin + index*mGrain;
+	  const size_t e = (mEnd - b > mGrain) ? b + mGrain : mEnd;
+	  mBody(b,e);
+	}
+
+      private:
+	size_t mBegin, mEnd, mGrain;
+	RangeTask& mBody;
+      };
+    }
+
+    void parallelFor(size_t begin, size_t end, size_t grain, RangeTask& body)
+    {
+      if (end <= begin)  return;
+      if (grain == 0)  grain = 1;
+
+      const size_t nChunks = (end - begin + grain - 1) / grain;
+      Executor* executor = ExecutorScope::Active();
+      if ((executor == NULL) || (nChunks < 2) || 
+	  (executor->getNumThreads() < 2))
+	{
+	  body(begin,end);
+	  return;
+	}
+
+      // Tasks run in other threads, where the executor is not
+      // active, so nested loops are serial.
+      ExecutorScope serial(NULL);
+      ChunkTask task(begin,end,grain,body);
+      executor->run(nChunks,task);
+    }
+
+  } //namespace utils
+} //namespace bayesopt
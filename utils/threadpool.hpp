@@ -0,0 +1,328 @@
+/** \file threadpool.hpp 
+    \brief Work-stealing thread pool and parallel loops */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef  _THREADPOOL_HPP_
+#define  _THREADPOOL_HPP_
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "spinlock.hpp"
+
+struct LogSettings;
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <pthread.h>
+#endif
+
+namespace bayesopt {
+  namespace utils {
+
+    class Profiler;
+
+    /** \brief Body of Executor::run. It is called once for each task
+     *  index, possibly from several threads at once. */
+    class ParallelTask
+    {
+    public:
+      virtual ~ParallelTask() {};
+      virtual void operator()(size_t index) = 0;
+    };
+
+    /** 
+     * \brief Runs groups of independent tasks. 
+     *
+     * ThreadPool is the default implementation. Applications that
+     * already own their threads can implement it and give it to the
+     * optimizer (see BayesOptBase::setExecutor). Tasks run by other
+     * executors are only counted by the profiler (see Profiler) if
+     * they run in the calling thread.
+     */
+    class Executor
+    {
+    public:
+      virtual ~Executor() {};
+
+      /** Number of threads that run tasks, including the caller. */
+      virtual size_t getNumThreads() const = 0;
+
+      /** 
+       * Calls task(i) for every i in [0,nTasks) and returns when all
+       * of them are done. If a task throws, the remaining tasks might
+       * be skipped and a std::runtime_error is thrown to the caller.
+       */
+      virtual void run(size_t nTasks, ParallelTask& task) = 0;
+    };
+
+
+    /**
+     * \brief Fixed set of threads with work stealing.
+     *
+     * The tasks of each run are split in contiguous ranges, one per
+     * thread. Every thread takes tasks from the front of its own range
+     * and, once it is empty, steals the back half of the range of
+     * another thread. The calling thread also works, so a pool of n
+     * threads starts n-1 workers. Runs from inside a task, or while
+     * the pool is busy with another caller, are done serially. The
+     * workers log with the LogScope and count in the profiler active
+     * in the caller of run.
+     */
+    class ThreadPool: public Executor
+    {
+    public:
+      /** @param nThreads number of threads (0: one per core) */
+      explicit ThreadPool(size_t nThreads = 0);
+      virtual ~ThreadPool();
+
+      size_t getNumThreads() const;
+      void run(size_t nTasks, ParallelTask& task);
+
+      /** Number of cores of the machine (at least 1). */
+      static size_t hardwareConcurrency();
+
+    private:
+      struct Range
+      {
+	SpinLock lock;
+	size_t begin, end;
+      };
+
+      struct Worker
+      {
+	ThreadPool* pool;
+	size_t id;
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+	HANDLE thread;
+#else
+	pthread_t thread;
+#endif
+      };
+
+      void work(size_t id);
+      bool take(size_t id, size_t& index);
+      bool steal(size_t id);
+      void fail(const std::string& msg);
+      void workerLoop(size_t id);
+      void runSerial(size_t nTasks, ParallelTask& task);
+
+      /** Pool running a task in the current thread, if any. */
+      static ThreadPool*& current();
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+      static DWORD WINAPI Run(LPVOID worker);
+      CRITICAL_SECTION mRunMutex;
+      CRITICAL_SECTION mMutex;
+      CONDITION_VARIABLE mWake;
+      CONDITION_VARIABLE mDone;
+#else
+      static void* Run(void* worker);
+      pthread_mutex_t mRunMutex;        ///< Serializes the callers
+      pthread_mutex_t mMutex;           ///< Guards the fields below
+      pthread_cond_t mWake;             ///< New run or stop
+      pthread_cond_t mDone;             ///< All workers finished
+#endif
+      size_t mGeneration;               ///< Number of runs started
+      size_t mActive;                   ///< Workers still in this run
+      bool mStop;
+
+      size_t mNumThreads;
+      std::vector<Worker> mWorkers;
+      Range* mRanges;                   ///< Pending tasks of each thread
+      ParallelTask* mTask;
+      const LogSettings* mLogSettings;  ///< Active in the caller of run
+      Profiler* mProfiler;              ///< Active in the caller of run
+      volatile bool mCancel;            ///< A task failed
+      SpinLock mErrorLock;
+      std::string mError;
+
+      ThreadPool(const ThreadPool&);
+      ThreadPool& operator=(const ThreadPool&);
+    };
+
+
+    /**
+     * \brief Runs one task (index 0) in a worker thread while the
+     * caller does other work, like learning the surrogate model
+     * during an evaluation of the target function. The worker is
+     * created by the first start and reused until destruction.
+     */
+    class AsyncTask
+    {
+    public:
+      AsyncTask();
+
+      /** Waits for the task (its errors are lost) and the worker. */
+      ~AsyncTask();
+
+      /** 
+       * Starts task(0) in the worker, after waiting for the previous
+       * one. If the worker cannot be created, the task runs in the
+       * caller. The task must outlive the call to wait.
+       */
+      void start(ParallelTask& task);
+
+      /** 
+       * Waits for the task, if it was started. If it threw, a
+       * std::runtime_error with its message is thrown to the caller.
+       */
+      void wait();
+
+      bool isStarted() const;
+
+    private:
+      void execute();
+      void workerLoop();
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+      static DWORD WINAPI Run(LPVOID task);
+      HANDLE mThread;
+      CRITICAL_SECTION mMutex;
+      CONDITION_VARIABLE mWake;
+      CONDITION_VARIABLE mDone;
+#else
+      static void* Run(void* task);
+      pthread_t mThread;
+      pthread_mutex_t mMutex;           ///< Guards the fields below
+      pthread_cond_t mWake;             ///< New task or stop
+      pthread_cond_t mDone;             ///< Task finished
+#endif
+      bool mRunning;                    ///< The worker exists
+      bool mBusy;                       ///< The worker has a task
+      bool mStop;
+      ParallelTask* mTask;
+      bool mFailed;
+      std::string mError;
+
+      AsyncTask(const AsyncTask&);
+      AsyncTask& operator=(const AsyncTask&);
+    };
+
+
+    /** 
+     * \brief Sets the executor of parallelFor and parallelReduce in
+     * the current thread during its scope (as LogScope). Without
+     * executor, or inside a parallel task, the loops are serial.
+     */
+    class ExecutorScope
+    {
+    public:
+      explicit ExecutorScope(Executor* executor);
+      ~ExecutorScope();
+
+      static Executor*& Active();
+
+    private:
+      Executor* mPrevious;
+    };
+
+
+    /** \brief Body of parallelFor over a range of indexes. */
+    class RangeTask
+    {
+    public:
+      virtual ~RangeTask() {};
+      virtual void operator()(size_t begin, size_t end) = 0;
+    };
+
+    /** 
+     * Runs body over [begin,end) in chunks of at most grain indexes
+     * with the active executor (see ExecutorScope).
+     */
+    void parallelFor(size_t begin, size_t end, size_t grain, RangeTask& body);
+
+
+    /** \brief Body of parallelReduce. */
+    template <typename T>
+    class ReduceTask
+    {
+    public:
+      virtual ~ReduceTask() {};
+
+      /** Partial result over [begin,end). */
+      virtual T operator()(size_t begin, size_t end) = 0;
+
+      /** Combines two partial results, left first. */
+      virtual T join(const T& left, const T& right) 
+      { return left + right; };
+    };
+
+    template <typename T>
+    class ReduceChunks: public RangeTask
+    {
+    public:
+      ReduceChunks(size_t begin, size_t end, size_t grain, 
+		   ReduceTask<T>& body, std::vector<T>& partial):
+	mBegin(begin), mEnd(end), mGrain(grain), mBody(body), 
+	mPartial(partial) {};
+
+      void operator()(size_t first, size_t last)
+      {
+	for (size_t c = first; c < last; ++c)
+	  {
+	    const size_t b = mBegin + c*mGrain;
+	    const size_t e = (mEnd - b > mGrain) ? b + mGrain : mEnd;
+	    mPartial[c] = mBody(b,e);
+	  }
+      };
+
+    private:
+      size_t mBegin, mEnd, mGrain;
+      ReduceTask<T>& mBody;
+      std::vector<T>& mPartial;
+    };
+
+    /** 
+     * Reduces body over [begin,end) in chunks of grain indexes. The
+     * chunks do not depend on the number of threads and the partial
+     * results are joined in order, so the result is reproducible.
+     */
+    template <typename T>
+    T parallelReduce(size_t begin, size_t end, size_t grain, 
+		     const T& init, ReduceTask<T>& body)
+    {
+      if (end <= begin) return init;
+      if (grain == 0) grain = 1;
+
+      const size_t nChunks = (end - begin + grain - 1) / grain;
+      std::vector<T> partial(nChunks);
+      ReduceChunks<T> chunks(begin,end,grain,body,partial);
+      parallelFor(0,nChunks,1,chunks);
+
+      T result = init;
+      for (size_t c = 0; c < nChunks; ++c)
+	{
+	  result = body.join(result,partial[c]);
+	}
+      return result;
+    }
+
+  } //namespace utils
+} //namespace bayesopt
+
+#endif
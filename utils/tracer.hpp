@@ -0,0 +1,310 @@
+/**  \file tracer.hpp \brief Span tracing in Chrome trace format */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef  _TRACER_HPP_
+#define  _TRACER_HPP_
+
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <boost/date_time/posix_time/posix_time.hpp>
+
+#include "atomic.hpp"
+#include "spinlock.hpp"
+
+#if !defined(WIN32) && !defined(_WIN32) && !defined(__WIN32__)
+#  include <pthread.h>
+#endif
+
+#ifndef BAYESOPT_THREAD_LOCAL
+#  if defined(_MSC_VER)
+#    define BAYESOPT_THREAD_LOCAL __declspec(thread)
+#  else
+#    define BAYESOPT_THREAD_LOCAL __thread
+#  endif
+#endif
+
+namespace bayesopt 
+{  
+  namespace utils 
+  {
+    /** Wall time in seconds since epoch. */
+    inline double wallTime()
+    {
+      using namespace boost::posix_time;
+      static const ptime epoch(boost::gregorian::date(1970,1,1));
+      const time_duration t = microsec_clock::universal_time() - epoch;
+      return t.total_microseconds() * 1e-6;
+    }
+
+    /** Completed span. Times in microseconds since epoch. */
+    struct TraceEvent
+    {
+      const char* name;        ///< Static string
+      double begin;
+      double end;
+    };
+
+    /** 
+     * \brief Ring buffer of the spans of one thread. Only the owner
+     * thread writes to it, thus it does not need locks. When it is
+     * full, the oldest spans are overwritten.
+     */
+    class TraceBuffer
+    {
+    public:
+      TraceBuffer(size_t tid, size_t capacity):
+	mTid(tid), mEvents(capacity), mNext(0), mSize(0) {};
+
+      void push(const char* name, double begin, double end)
+      {
+	TraceEvent& e = mEvents[mNext];
+	e.name = name;  e.begin = begin;  e.end = end;
+	mNext = (mNext + 1) % mEvents.size();
+	if (mSize < mEvents.size())  ++mSize;
+      };
+
+      void clear()
+      { mNext = 0;  mSize = 0; };
+
+      size_t getTid() const { return mTid; };
+      size_t getSize() const { return mSize; };
+
+      /** Spans from the oldest to the newest. */
+      const TraceEvent& get(size_t i) const
+      { return mEvents[(mNext + mEvents.size() - mSize + i) % mEvents.size()]; };
+
+    private:
+      size_t mTid;
+      std::vector<TraceEvent> mEvents;
+      size_t mNext, mSize;
+    };
+
+    /** 
+     * \brief Process wide tracer of nested spans (see TraceSpan).
+     *
+     * Every thread records its spans in its own ring buffer. The
+     * global lock is only taken the first time that a thread records
+     * a span. When the thread exits, its buffer (and its spans) is
+     * given to the next new thread, so short lived threads do not
+     * allocate a buffer each. Spans are only recorded between start()
+     * and stop(), and the buffers should only be written when the
+     * traced threads are idle. Only one optimization can be traced at
+     * a time.
+     */
+    class Tracer
+    {
+    public:
+      static const size_t BUFFER_CAPACITY = 1 << 16;
+
+      /** Clears all the buffers and starts recording. */
+      static void start();
+
+      /** Stops recording. */
+      static void stop();
+
+      static bool isEnabled();
+
+      /** Records a span in the buffer of the calling thread. */
+      static void record(const char* name, double begin, double end);
+
+      /** 
+       * Writes the spans in Chrome trace format (JSON) that can be
+       * opened with chrome://tracing or Perfetto. Throws
+       * std::runtime_error if the file cannot be written.
+       */
+      static void write(const std::string& filename);
+
+    private:
+      static Atomic<bool>& enabled();
+      static std::vector<TraceBuffer*>& buffers();
+      static std::vector<TraceBuffer*>& freeBuffers();
+      static TraceBuffer*& threadBuffer();
+      static TraceBuffer* registerThread();
+      static void watchThreadExit(TraceBuffer* buffer);
+      static SpinLock& mutex();
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+      static VOID WINAPI releaseThread(PVOID buffer);
+#else
+      static void releaseThread(void* buffer);
+#endif
+    };
+
+    /** Records the wall time of its scope as a span (if the tracer
+	is enabled). The name must be a static string. */
+    class TraceSpan
+    {
+    public:
+      explicit TraceSpan(const char* name):
+	mName(name), mBegin(Tracer::isEnabled() ? wallTime() : -1.0)
+      {};
+
+      ~TraceSpan()
+      { if (mBegin >= 0.0)  Tracer::record(mName, mBegin, wallTime()); };
+
+    private:
+      const char* mName;
+      double mBegin;
+    };
+
+
+    //// Inline methods
+
+    inline Atomic<bool>& Tracer::enabled()
+    {
+      static Atomic<bool> isOn(false);
+      return isOn;
+    }
+
+    inline std::vector<TraceBuffer*>& Tracer::buffers()
+    {
+      static std::vector<TraceBuffer*> all;
+      return all;
+    }
+
+    inline std::vector<TraceBuffer*>& Tracer::freeBuffers()
+    {
+      static std::vector<TraceBuffer*> released;  // Of finished threads
+      return released;
+    }
+
+    inline TraceBuffer*& Tracer::threadBuffer()
+    {
+      static BAYESOPT_THREAD_LOCAL TraceBuffer* buffer = NULL;
+      return buffer;
+    }
+
+    inline SpinLock& Tracer::mutex()
+    {
+      static SpinLock lock;
+      return lock;
+    }
+
+    inline bool Tracer::isEnabled()
+    { return enabled().load(); }
+
+    inline void Tracer::start()
+    {
+      {
+	SpinLockGuard guard(mutex());
+	std::vector<TraceBuffer*>& all = buffers();
+	for (size_t i = 0; i < all.size(); ++i)  all[i]->clear();
+      }
+      enabled().store(true);
+    }
+
+    inline void Tracer::stop()
+    { enabled().store(false); }
+
+    inline TraceBuffer* Tracer::registerThread()
+    {
+      SpinLockGuard guard(mutex());
+      std::vector<TraceBuffer*>& released = freeBuffers();
+      TraceBuffer* buffer;
+      if (!released.empty())
+	{
+	  buffer = released.back();
+	  released.pop_back();
+	}
+      else
+	{
+	  std::vector<TraceBuffer*>& all = buffers();
+	  buffer = new TraceBuffer(all.size()+1, BUFFER_CAPACITY);
+	  all.push_back(buffer);
+	}
+      watchThreadExit(buffer);
+      return buffer;
+    }
+
+    /** Calls releaseThread with the buffer when the calling thread
+	exits. Called with the lock taken. */
+    inline void Tracer::watchThreadExit(TraceBuffer* buffer)
+    {
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+      static const DWORD key = FlsAlloc(&Tracer::releaseThread);
+      if (key != FLS_OUT_OF_INDEXES)  FlsSetValue(key, buffer);
+#else
+      static pthread_key_t key;
+      static const bool created = 
+	(pthread_key_create(&key, &Tracer::releaseThread) == 0);
+      if (created)  pthread_setspecific(key, buffer);
+#endif
+    }
+
+#if defined(WIN32) || defined(_WIN32) || defined(__WIN32__)
+    inline VOID WINAPI Tracer::releaseThread(PVOID buffer)
+#else
+    inline void Tracer::releaseThread(void* buffer)
+#endif
+    {
+      if (buffer == NULL)  return;
+      SpinLockGuard guard(mutex());
+      freeBuffers().push_back(static_cast<TraceBuffer*>(buffer));
+    }
+
+    inline void Tracer::record(const char* name, double begin, double end)
+    {
+      TraceBuffer*& buffer = threadBuffer();
+      if (buffer == NULL)  buffer = registerThread();
+      buffer->push(name, begin*1e6, end*1e6);
+    }
+
+    inline void Tracer::write(const std::string& filename)
+    {
+      std::FILE* fd = std::fopen(filename.c_str(),"w");
+      if (fd == NULL)
+	{
+	  throw std::runtime_error("Unable to write trace file: " + filename);
+	}
+
+      std::fprintf(fd,"{\"traceEvents\":[");
+      bool first = true;
+      {
+	SpinLockGuard guard(mutex());
+	std::vector<TraceBuffer*>& all = buffers();
+	for (size_t b = 0; b < all.size(); ++b)
+	  {
+	    const TraceBuffer& buffer = *all[b];
+	    for (size_t i = 0; i < buffer.getSize(); ++i)
+	      {
+		const TraceEvent& e = buffer.get(i);
+		std::fprintf(fd,"%s\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,"
+			     "\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}",
+			     first ? "" : ",", e.name,
+			     static_cast<unsigned long>(buffer.getTid()),
+			     e.begin, e.end - e.begin);
+		first = false;
+	      }
+	  }
+      }
+      std::fprintf(fd,"\n],\"displayTimeUnit\":\"ms\"}\n");
+      std::fclose(fd);
+    }
+
+  } //namespace utils
+
+} //namespace bayesopt
+
+#endif
@@ -38,6 +38,8 @@
 
 #include <boost/numeric/ublas/triangular.hpp>
 
+#include "profiler.hpp"
+
 namespace bayesopt 
 {
   namespace utils
@@ -65,6 +67,8 @@ namespace bayesopt
       assert( A.size2() == L.size2() );
 
       const size_t n = A.size1();
+      Profiler::count(COUNT_CHOLESKY);
+      TraceSpan span("cholesky");
   
       for (size_t k=0 ; k < n; k++) {
         
@@ -104,6 +108,8 @@ namespace bayesopt
       const MATRIX& A_c(A);
 
       const size_t n = A.size1();
+      Profiler::count(COUNT_CHOLESKY);
+      TraceSpan span("cholesky");
   
       for (size_t k=0 ; k < n; k++) {
         
@@ -182,6 +188,8 @@ namespace bayesopt
       const MATRIX& A_c(A);
 
       const size_t n = A.size1();
+      Profiler::count(COUNT_CHOLESKY);
+      TraceSpan span("cholesky");
   
       for (size_t k=0 ; k < n; k++) {
     
@@ -286,6 +294,66 @@ namespace bayesopt
       return;      
     }
 
+    /** \brief Rank one update of a Cholesky decomposition. Given
+     * \f$ A = L L^T \f$, it computes inplace the decomposition of
+     * \f$ A + x x^T \f$ in O(n^2).
+     *
+     * \param L lower triangular matrix (input and output)
+     * \param x update vector (it is overwritten)
+     */
+    template < class TRIA, class VECTOR >
+    void cholesky_update(TRIA& L, VECTOR& x)
+    {
+      assert( L.size1() == L.size2() );
+      assert( L.size1() == x.size() );
+
+      const size_t n = x.size();
+      for (size_t k = 0; k < n; ++k)
+	{
+	  const double r = sqrt(L(k,k)*L(k,k) + x(k)*x(k));
+	  const double c = r / L(k,k);
+	  const double s = x(k) / L(k,k);
+	  L(k,k) = r;
+	  for (size_t i = k+1; i < n; ++i)
+	    {
+	      L(i,k) = (L(i,k) + s*x(i)) / c;
+	      x(i) = c*x(i) - s*L(i,k);
+	    }
+	}
+    }
+
+    /** \brief Removes a row (and column) from the matrix of a
+     * Cholesky decomposition. Given \f$ A = L L^T \f$, it computes
+     * inplace the decomposition of A without the index-th row and
+     * column in O(n^2) by a rank one update of the trailing block.
+     *
+     * \param L lower triangular matrix (input and output)
+     * \param index row to be removed
+     */
+    template < class TRIA >
+    void cholesky_remove_row(TRIA& L, size_t index)
+    {
+      using namespace ublas;
+
+      assert( L.size1() == L.size2() );
+      assert( index < L.size1() );
+
+      const size_t n = L.size1();
+      vector<typename TRIA::value_type> x = 
+	project(column(L,index), range(index+1,n));
+
+      for (size_t i = index; i < n-1; ++i)
+	{
+	  for (size_t j = 0; j < index; ++j)  L(i,j) = L(i+1,j);
+	  for (size_t j = index; j <= i; ++j) L(i,j) = L(i+1,j+1);
+	  L(i,i+1) = 0.0;
+	}
+      L.resize(n-1,n-1,true);
+
+      matrix_range<TRIA> L33(L, range(index,n-1), range(index,n-1));
+      cholesky_update(L33,x);
+    }
+
   } //namespace utils
 
 } // namespace bayesopt
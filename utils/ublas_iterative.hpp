@@ -0,0 +1,246 @@
+/**  \file ublas_iterative.hpp \brief Iterative (matrix-free) linear algebra for SPD matrices */
+/*
+-------------------------------------------------------------------------
+   This file is part of BayesOpt, an efficient C++ library for 
+   Bayesian optimization.
+
+   Copyright (C) 2011-2014 Ruben Martinez-Cantin <rmcantin@unizar.es>
+ 
+   BayesOpt is free software: you can redistribute it and/or modify it 
+   under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   BayesOpt is distributed in the hope that it will be useful, but 
+   WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with BayesOpt.  If not, see <http://www.gnu.org/licenses/>.
+------------------------------------------------------------------------
+*/
+
+#ifndef _UBLAS_ITERATIVE_HPP_
+#define _UBLAS_ITERATIVE_HPP_
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <boost/numeric/ublas/matrix_proxy.hpp>
+#include "specialtypes.hpp"
+#include "randgen.hpp"
+
+namespace bayesopt
+{
+  namespace utils
+  {
+    /** 
+     * \brief Preconditioned conjugate gradient for several right hand
+     * sides (columns of B). The columns are solved independently but in
+     * lockstep, so each iteration needs a single (batched) product.
+     *
+     * @param op functor of the SPD matrix, op(X,AX) computes AX = A*X
+     * @param diag diagonal of A (Jacobi preconditioner)
+     * @param B right hand sides (n x m)
+     * @param X [out] solutions (n x m)
+     * @param tol relative tolerance of the residual norm
+     * @param maxIter maximum number of iterations
+     * @return number of iterations
+     */
+    template <class Op>
+    size_t pcg_solve(Op& op, const vectord& diag, const matrixd& B, matrixd& X,
+		     double tol, size_t maxIter)
+    {
+      const size_t n = B.size1();
+      const size_t m = B.size2();
+
+      X = zmatrixd(n,m);
+      matrixd R(B);
+      matrixd Z(n,m), P(n,m), AP(n,m);
+      for (size_t i = 0; i < n; ++i)
+	for (size_t j = 0; j < m; ++j)
+	  Z(i,j) = R(i,j) / diag(i);
+      P = Z;
+
+      vectord rz(m), bnorm(m);
+      std::vector<bool> done(m,false);
+      for (size_t j = 0; j < m; ++j)
+	{
+	  rz(j) = inner_prod(column(R,j),column(Z,j));
+	  bnorm(j) = norm_2(column(B,j));
+	  done[j] = (bnorm(j) == 0.0);
+	}
+
+      size_t it = 0;
+      while ((it < maxIter) && (std::count(done.begin(),done.end(),false) > 0))
+	{
+	  op(P,AP);
+	  ++it;
+	  for (size_t j = 0; j < m; ++j)
+	    {
+	      if (done[j]) continue;
+
+	      const double a = rz(j) / inner_prod(column(P,j),column(AP,j));
+	      column(X,j) += a * column(P,j);
+	      column(R,j) -= a * column(AP,j);
+	      if (norm_2(column(R,j)) <= tol * bnorm(j))
+		{
+		  done[j] = true;
+		  continue;
+		}
+
+	      for (size_t i = 0; i < n; ++i)  Z(i,j) = R(i,j) / diag(i);
+	      const double rzNew = inner_prod(column(R,j),column(Z,j));
+	      column(P,j) = column(Z,j) + (rzNew / rz(j)) * column(P,j);
+	      rz(j) = rzNew;
+	    }
+	}
+      return it;
+    }
+
+
+    /** 
+     * \brief Eigenvalues and eigenvectors of a small symmetric matrix
+     * by the cyclic Jacobi method.
+     *
+     * @param A symmetric matrix
+     * @param eig [out] eigenvalues
+     * @param V [out] eigenvectors (columns)
+     */
+    inline void symmetric_eigen(const matrixd& A, vectord& eig, matrixd& V)
+    {
+      const size_t n = A.size1();
+      matrixd M(A);
+      V = boost::numeric::ublas::identity_matrix<double>(n);
+
+      for (size_t sweep = 0; sweep < 100; ++sweep)
+	{
+	  double off = 0.0, total = 0.0;
+	  for (size_t p = 0; p < n; ++p)
+	    for (size_t q = 0; q < n; ++q)
+	      {
+		total += M(p,q)*M(p,q);
+		if (p != q) off += M(p,q)*M(p,q);
+	      }
+	  if (off <= 1e-30 * total) break;
+
+	  for (size_t p = 0; p < n; ++p)
+	    for (size_t q = p+1; q < n; ++q)
+	      {
+		if (M(p,q) == 0.0) continue;
+		const double theta = (M(q,q) - M(p,p)) / (2*M(p,q));
+		const double t = ((theta >= 0) ? 1.0 : -1.0) 
+		  / (std::fabs(theta) + std::sqrt(theta*theta + 1));
+		const double c = 1 / std::sqrt(t*t + 1);
+		const double s = t * c;
+
+		for (size_t k = 0; k < n; ++k)
+		  {
+		    const double mkp = M(k,p), mkq = M(k,q);
+		    M(k,p) = c*mkp - s*mkq;
+		    M(k,q) = s*mkp + c*mkq;
+		  }
+		for (size_t k = 0; k < n; ++k)
+		  {
+		    const double mpk = M(p,k), mqk = M(q,k);
+		    M(p,k) = c*mpk - s*mqk;
+		    M(q,k) = s*mpk + c*mqk;
+		  }
+		for (size_t k = 0; k < n; ++k)
+		  {
+		    const double vkp = V(k,p), vkq = V(k,q);
+		    V(k,p) = c*vkp - s*vkq;
+		    V(k,q) = s*vkp + c*vkq;
+		  }
+	      }
+	}
+
+      eig.resize(n,false);
+      for (size_t i = 0; i < n; ++i)  eig(i) = M(i,i);
+    }
+
+
+    /** 
+     * \brief Estimates the log-determinant of a SPD matrix by
+     * stochastic Lanczos quadrature, \f$ \log|A| = tr(\log A) \approx
+     * \frac{n}{m} \sum_i e_1^T \log(T_i) e_1 \f$, where \f$ T_i \f$ is
+     * the Lanczos tridiagonal matrix started at the i-th Rademacher
+     * probe. All probes run in lockstep with batched products.
+     *
+     * @param op functor of the SPD matrix, op(X,AX) computes AX = A*X
+     * @param n size of the matrix
+     * @param nProbes number of random probes
+     * @param nSteps number of Lanczos steps
+     * @param eng random engine for the probes
+     * @return estimate of the log-determinant
+     */
+    template <class Op>
+    double lanczos_logdet(Op& op, size_t n, size_t nProbes, size_t nSteps,
+			  randEngine& eng)
+    {
+      namespace ublas = boost::numeric::ublas;
+      nSteps = (std::min)(nSteps,n);
+
+      randInt coin(eng, intUniformDist(0,1));
+      matrixd Q(n,nProbes), Qprev(n,nProbes), W(n,nProbes);
+      const double scale = 1/std::sqrt(static_cast<double>(n));
+      for (size_t i = 0; i < n; ++i)
+	for (size_t j = 0; j < nProbes; ++j)
+	  Q(i,j) = coin() ? scale : -scale;
+      Qprev = zmatrixd(n,nProbes);
+
+      matrixd alpha = zmatrixd(nSteps,nProbes);
+      matrixd beta = zmatrixd(nSteps,nProbes);
+      std::vector<size_t> length(nProbes,0);
+      std::vector<bool> done(nProbes,false);
+
+      for (size_t k = 0; k < nSteps; ++k)
+	{
+	  op(Q,W);
+	  for (size_t j = 0; j < nProbes; ++j)
+	    {
+	      if (done[j]) continue;
+	      ublas::matrix_column<matrixd> w(W,j);
+	      alpha(k,j) = inner_prod(column(Q,j),w);
+	      w -= alpha(k,j) * column(Q,j);
+	      if (k > 0) w -= beta(k-1,j) * column(Qprev,j);
+	      length[j] = k+1;
+
+	      beta(k,j) = norm_2(w);
+	      if (beta(k,j) < 1e-10 * std::fabs(alpha(k,j)))
+		{
+		  done[j] = true;   // Invariant subspace found
+		  continue;
+		}
+	      column(Qprev,j) = column(Q,j);
+	      column(Q,j) = w / beta(k,j);
+	    }
+	}
+
+      double sum = 0.0;
+      for (size_t j = 0; j < nProbes; ++j)
+	{
+	  const size_t s = length[j];
+	  matrixd T = zmatrixd(s,s);
+	  for (size_t k = 0; k < s; ++k)
+	    {
+	      T(k,k) = alpha(k,j);
+	      if (k+1 < s)  T(k,k+1) = T(k+1,k) = beta(k,j);
+	    }
+	  vectord theta;
+	  matrixd V;
+	  symmetric_eigen(T,theta,V);
+	  for (size_t k = 0; k < s; ++k)
+	    {
+	      // Ritz values should be positive. Guard against round off.
+	      sum += V(0,k)*V(0,k) * std::log((std::max)(theta(k),1e-300));
+	    }
+	}
+      return n * sum / nProbes;
+    }
+
+  } //namespace utils
+} //namespace bayesopt
+
+#endif
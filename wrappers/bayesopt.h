@@ -38,6 +38,21 @@ extern "C" {
 			      double *gradient, /* NULL if not needed */
 			      void *func_data);
 
+  /** 
+   * Batch version of eval_func. It evaluates n points at once, so
+   * the caller can vectorize or distribute them. Invalid values must
+   * be HUGE_VAL.
+   * 
+   * @param n number of points
+   * @param nDim number of input dimensions
+   * @param x points in row major order (n x nDim)
+   * @param y output: value of each point (n)
+   * @param func_data pointer to extra data given to the optimizer
+   */
+  typedef void (*eval_batch_func)(unsigned int n, unsigned int nDim,
+				  const double *x, double *y,
+				  void *func_data);
+
 
 /** 
  * @brief C wrapper for the Bayesian optimization algorithm. 
@@ -60,6 +75,36 @@ extern "C" {
 				      bopt_params parameters);
 
 
+/** 
+ * @brief C wrapper for the Bayesian optimization algorithm with
+ * previous observations (warm start). The observations replace the
+ * initial design, thus no function evaluation is required to build
+ * the initial surrogate model. This function assumes continuous
+ * optimization.
+ * 
+ * @param nDim number of input dimensions
+ * @param f pointer to the function to optimize
+ * @param f_data pointer to extra data to be used by f
+ * @param lb array of lower bounds
+ * @param ub array of upper bounds
+ * @param x_init inputs of the observations (n_init x nDim, row major)
+ * @param y_init function values of the observations (n_init)
+ * @param n_init number of observations
+ * @param x input: initial query, output: result (minimum)
+ * @param minf value of the function at the minimum
+ * @param parameters parameters for the Bayesian optimization.
+ * 
+ * @return error code
+ */
+  BAYESOPT_API int bayes_optimization_warm(int nDim, eval_func f, 
+					   void* f_data,
+					   const double *lb, const double *ub,
+					   const double *x_init, 
+					   const double *y_init, size_t n_init,
+					   double *x, double *minf,
+					   bopt_params parameters);
+
+
 /** 
  * @brief C wrapper for the Bayesian optimization algorithm. 
  * This function assumes discrete optimization.
@@ -103,7 +148,143 @@ extern "C" {
 						  bopt_params parameters);
 
 
+
+  /** 
+   * @brief Batch versions of the C wrappers above. The target function
+   * receives the whole initial design in a single call, and one point
+   * per call during the iterations. The other arguments are the same.
+   * 
+   * @return error code
+   */
+  BAYESOPT_API int bayes_optimization_batch(int nDim, eval_batch_func f, 
+					    void* f_data,
+					    const double *lb, const double *ub,
+					    double *x, double *minf,
+					    bopt_params parameters);
+
+  BAYESOPT_API int bayes_optimization_batch_warm(int nDim, eval_batch_func f, 
+						 void* f_data,
+						 const double *lb, 
+						 const double *ub,
+						 const double *x_init, 
+						 const double *y_init, 
+						 size_t n_init,
+						 double *x, double *minf,
+						 bopt_params parameters);
+
+  BAYESOPT_API int bayes_optimization_batch_disc(int nDim, eval_batch_func f, 
+						 void* f_data,
+						 double *valid_x, 
+						 size_t n_points,
+						 double *x, double *minf,
+						 bopt_params parameters);
+
+  BAYESOPT_API int bayes_optimization_batch_categorical(int nDim, 
+							eval_batch_func f, 
+							void* f_data, 
+							int *categories, 
+							double *x, 
+							double *minf, 
+							bopt_params parameters);
+
+
+  /** 
+   * @brief Continuous optimizer of the ask/tell interface (opaque).
+   * The application evaluates the queries, so they can be run in
+   * parallel or in other processes while the optimizer computes
+   * the next proposal.
+   *
+   * Usage: bayes_optimizer_create, bayes_optimizer_design (optional),
+   * bayes_optimizer_initialize with the observations, and then
+   * bayes_optimizer_ask and bayes_optimizer_tell for each iteration.
+   */
+  typedef struct bopt_optimizer bopt_optimizer;
+
+  /** 
+   * @param opt output: new optimizer (see bayes_optimizer_free)
+   * @param nDim number of input dimensions
+   * @param lb array of lower bounds
+   * @param ub array of upper bounds
+   * @param parameters parameters for the Bayesian optimization.
+   * @return error code
+   */
+  BAYESOPT_API int bayes_optimizer_create(bopt_optimizer** opt, int nDim,
+					  const double *lb, const double *ub,
+					  bopt_params parameters);
+
+  BAYESOPT_API void bayes_optimizer_free(bopt_optimizer* opt);
+
+  /** 
+   * @brief Initial design, without evaluating it.
+   * @param n number of points
+   * @param x output: points (n x nDim, row major)
+   * @return error code
+   */
+  BAYESOPT_API int bayes_optimizer_design(bopt_optimizer* opt, size_t n,
+					  double *x);
+
+  /** 
+   * @brief Builds the surrogate model with the first observations
+   * (e.g.: the initial design).
+   * @param x_init inputs of the observations (n_init x nDim, row major)
+   * @param y_init function values of the observations (n_init)
+   * @param n_init number of observations
+   * @return error code
+   */
+  BAYESOPT_API int bayes_optimizer_initialize(bopt_optimizer* opt, 
+					      const double *x_init, 
+					      const double *y_init, 
+					      size_t n_init);
+
+  /** 
+   * @brief Next query to evaluate.
+   * @param x output: query (nDim)
+   * @return error code
+   */
+  BAYESOPT_API int bayes_optimizer_ask(bopt_optimizer* opt, double *x);
+
+  /** 
+   * @brief Adds an observation (usually of the last query) and
+   * updates the surrogate model.
+   * @return error code (BAYESOPT_RUNTIME_ERROR before
+   * bayes_optimizer_initialize)
+   */
+  BAYESOPT_API int bayes_optimizer_tell(bopt_optimizer* opt, 
+					const double *x, double y);
+
+  /** 
+   * @brief Predictive mean and standard deviation of the surrogate.
+   * @param n number of points
+   * @param x points (n x nDim, row major)
+   * @param mean output: mean of each point (n)
+   * @param std output: standard deviation of each point (n)
+   * @return error code
+   */
+  BAYESOPT_API int bayes_optimizer_predict(bopt_optimizer* opt, size_t n,
+					   const double *x, double *mean, 
+					   double *std);
+
+  /** 
+   * @brief Best observation so far.
+   * @param x output: point (nDim)
+   * @param minf output: value
+   * @return error code (BAYESOPT_RUNTIME_ERROR before
+   * bayes_optimizer_initialize)
+   */
+  BAYESOPT_API int bayes_optimizer_best(bopt_optimizer* opt, double *x, 
+					double *minf);
+
   
+  /** 
+   * @brief Wall time and counters (accumulated) of the last
+   * successful optimization run in the calling thread.
+   * 
+   * @param profile output profile.
+   * 
+   * @return error code (if there was no optimization)
+   */
+  BAYESOPT_API int bayes_optimization_last_profile(bopt_profile* profile);
+
 #ifdef __cplusplus
 }
 #endif 
@@ -20,8 +20,14 @@
 -----------------------------------------------------------------------------
 */
 
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
 #include "log.hpp"
 #include "ublas_extra.hpp"
+#include "profiler.hpp"
+#include "dataset.hpp"
 #include "bayesopt.h"
 #include "bayesopt.hpp"      
 
@@ -30,6 +36,71 @@ static const int BAYESOPT_INVALID_ARGS = -2;
 static const int BAYESOPT_OUT_OF_MEMORY = -3;
 static const int BAYESOPT_RUNTIME_ERROR = -4;
 
+/* Profile of the last optimization of the calling thread. */
+static BAYESOPT_THREAD_LOCAL bopt_profile lastProfile;
+static BAYESOPT_THREAD_LOCAL int hasLastProfile = 0;
+
+static void save_profile(const bayesopt::BayesOptBase& optimizer)
+{
+  lastProfile = optimizer.getProfiler().getTotal();
+  hasLastProfile = 1;
+}
+
+/**
+ * \brief Target function of the C wrapper. It evaluates one point
+ * (eval_func) or a batch of points (eval_batch_func) per call.
+ */
+class CObjective
+{
+ public:
+  CObjective(): mF(NULL), mBatchF(NULL), mOtherData(NULL) {};
+
+  void set_eval_funct(eval_func f)
+  {  mF = f;  mBatchF = NULL; }
+
+  void set_eval_funct(eval_batch_func f)
+  {  mBatchF = f;  mF = NULL; }
+
+  void save_other_data(void* other_data)
+  {  mOtherData = other_data; }
+
+  bool isBatch() const
+  {  return mBatchF != NULL; }
+
+  double evaluate( const vectord &Xi )
+  {
+    unsigned int n = static_cast<unsigned int>(Xi.size());
+    if (mF != NULL)  return mF(n,&Xi[0],NULL,mOtherData);
+
+    double y = HUGE_VAL;
+    mBatchF(1,n,&Xi[0],&y,mOtherData);
+    return y;
+  };
+
+  /** The points are packed in one row major buffer (n x dim). */
+  void evaluate( const vecOfvec &queries, vectord &values )
+  {
+    const size_t n = queries.size();
+    values.resize(n,false);
+    if (n == 0)  return;
+
+    const size_t dim = queries[0].size();
+    std::vector<double> x(n*dim);
+    for (size_t i = 0; i < n; ++i)
+      {
+	std::copy(queries[i].begin(),queries[i].end(),x.begin()+i*dim);
+      }
+    std::fill(values.begin(),values.end(),HUGE_VAL);
+    mBatchF(static_cast<unsigned int>(n),static_cast<unsigned int>(dim),
+	    &x[0],&values[0],mOtherData);
+  };
+
+ private:
+  eval_func mF;
+  eval_batch_func mBatchF;
+  void* mOtherData;
+};
+
 /**
  * \brief Version of ContinuousModel for the C wrapper
  */
@@ -43,21 +114,23 @@ class CContinuousModel: public bayesopt::ContinuousModel
   virtual ~CContinuousModel(){};
 
   double evaluateSample( const vectord &Xi ) 
+  {  return mObjective.evaluate(Xi); };
+
+  bool evaluateSamples( const vecOfvec &queries, vectord &values )
   {
-    int n = static_cast<int>(Xi.size());
-    return  mF(n,&Xi[0],NULL,mOtherData);
+    if (!mObjective.isBatch())  return false;
+    mObjective.evaluate(queries,values);
+    return true;
   };
 
-  void set_eval_funct(eval_func f)
-  {  mF = f; }
-
+  template <typename Func> void set_eval_funct(Func f)
+  {  mObjective.set_eval_funct(f); }
 
   void save_other_data(void* other_data)
-  {  mOtherData = other_data; }
+  {  mObjective.save_other_data(other_data); }
  
 protected:
-  void* mOtherData;
-  eval_func mF;
+  CObjective mObjective;
 };
 
 /**
@@ -76,44 +149,57 @@ class CDiscreteModel: public bayesopt::DiscreteModel
   {}; 
 
   double evaluateSample( const vectord &Xi ) 
+  {  return mObjective.evaluate(Xi); };
+
+  bool evaluateSamples( const vecOfvec &queries, vectord &values )
   {
-    int n = static_cast<int>(Xi.size());
-    return  mF(n,&Xi[0],NULL,mOtherData);
+    if (!mObjective.isBatch())  return false;
+    mObjective.evaluate(queries,values);
+    return true;
   };
 
-  void set_eval_funct(eval_func f)
-  {  mF = f; }
-
+  template <typename Func> void set_eval_funct(Func f)
+  {  mObjective.set_eval_funct(f); }
 
   void save_other_data(void* other_data)
-  {  mOtherData = other_data; }
+  {  mObjective.save_other_data(other_data); }
  
 protected:
-  void* mOtherData;
-  eval_func mF;
+  CObjective mObjective;
 };
 
-int bayes_optimization(int nDim, eval_func f, void* f_data,
-		       const double *lb, const double *ub,
-		       double *x, double *minf, bopt_params parameters)
+/**
+ * \brief Version of ContinuousModel for the ask/tell interface. The
+ * application evaluates the queries.
+ */
+class CAskTellModel: public bayesopt::ContinuousModel 
 {
-  vectord result(nDim);
-
-  vectord lowerBound = bayesopt::utils::array2vector(lb,nDim); 
-  vectord upperBound = bayesopt::utils::array2vector(ub,nDim); 
+ public:
+  CAskTellModel(size_t dim, bopt_params params):
+    ContinuousModel(dim,params)  {}; 
 
-  try 
-    {
-      CContinuousModel optimizer(nDim, parameters);
+  double evaluateSample( const vectord &/*Xi*/ ) 
+  {
+    throw std::runtime_error("The ask/tell optimizer does not evaluate "
+			     "the target function.");
+  };
+};
 
-      optimizer.set_eval_funct(f);
-      optimizer.save_other_data(f_data);
-      optimizer.setBoundingBox(lowerBound,upperBound);
+struct bopt_optimizer
+{
+  bopt_optimizer(size_t dim, bopt_params params): 
+    nDim(dim), model(dim,params) {};
 
-      optimizer.optimize(result);
-      std::copy(result.begin(), result.end(), x);
+  size_t nDim;
+  CAskTellModel model;
+};
 
-      *minf = optimizer.getValueAtMinimum();
+/* Error code of the exception being handled (call inside catch). */
+static int error_code()
+{
+  try
+    {
+      throw;
     }
   catch (std::bad_alloc& e)
     {
@@ -135,12 +221,88 @@ int bayes_optimization(int nDim, eval_func f, void* f_data,
       FILE_LOG(logERROR) << "Unknown error";
       return BAYESOPT_FAILURE; 
     }
+}
+
+template <typename Func>
+static int optimize_continuous(int nDim, Func f, void* f_data,
+			       const double *lb, const double *ub,
+			       double *x, double *minf, 
+			       bopt_params parameters)
+{
+  vectord result(nDim);
+
+  vectord lowerBound = bayesopt::utils::array2vector(lb,nDim); 
+  vectord upperBound = bayesopt::utils::array2vector(ub,nDim); 
+
+  try 
+    {
+      CContinuousModel optimizer(nDim, parameters);
+
+      optimizer.set_eval_funct(f);
+      optimizer.save_other_data(f_data);
+      optimizer.setBoundingBox(lowerBound,upperBound);
+
+      optimizer.optimize(result);
+      std::copy(result.begin(), result.end(), x);
+
+      *minf = optimizer.getValueAtMinimum();
+      save_profile(optimizer);
+    }
+  catch (...)
+    {
+      return error_code();
+    }
   return 0; /* everything ok*/
 };
 
-int bayes_optimization_disc(int nDim, eval_func f, void* f_data,
-			    double *valid_x, size_t n_points,
-			    double *x, double *minf, bopt_params parameters)
+template <typename Func>
+static int optimize_warm(int nDim, Func f, void* f_data,
+			 const double *lb, const double *ub,
+			 const double *x_init, const double *y_init, 
+			 size_t n_init, double *x, double *minf, 
+			 bopt_params parameters)
+{
+  vectord result(nDim);
+
+  vectord lowerBound = bayesopt::utils::array2vector(lb,nDim); 
+  vectord upperBound = bayesopt::utils::array2vector(ub,nDim); 
+
+  try 
+    {
+      CContinuousModel optimizer(nDim, parameters);
+
+      optimizer.set_eval_funct(f);
+      optimizer.save_other_data(f_data);
+      optimizer.setBoundingBox(lowerBound,upperBound);
+
+      optimizer.initializeOptimization(x_init,y_init,n_init);
+      for (size_t ii = 0; ii < parameters.n_iterations; ++ii)
+	{
+	  optimizer.stepOptimization();
+	}
+
+      if (parameters.load_save_flag & 2)
+	{
+	  optimizer.saveObservations(parameters.save_filename);
+	}
+
+      result = optimizer.getFinalResult();
+      std::copy(result.begin(), result.end(), x);
+
+      *minf = optimizer.getValueAtMinimum();
+      save_profile(optimizer);
+    }
+  catch (...)
+    {
+      return error_code();
+    }
+  return 0; /* everything ok*/
+};
+
+template <typename Func>
+static int optimize_disc(int nDim, Func f, void* f_data,
+			 double *valid_x, size_t n_points,
+			 double *x, double *minf, bopt_params parameters)
 {
   vectord result(nDim);
   vectord input(nDim);
@@ -172,35 +334,20 @@ int bayes_optimization_disc(int nDim, eval_func f, void* f_data,
       std::copy(result.begin(), result.end(), x);
 
       *minf = optimizer.getValueAtMinimum();
-    }
-  catch (std::bad_alloc& e)
-    {
-      FILE_LOG(logERROR) << e.what(); 
-      return  BAYESOPT_OUT_OF_MEMORY; 
-    }
-  catch (std::invalid_argument& e)
-    { 
-      FILE_LOG(logERROR) << e.what(); 
-      return BAYESOPT_INVALID_ARGS; 
-    }
-  catch (std::runtime_error& e)
-    { 
-      FILE_LOG(logERROR) << e.what(); 
-      return BAYESOPT_RUNTIME_ERROR;
+      save_profile(optimizer);
     }
   catch (...)
-    { 
-      FILE_LOG(logERROR) << "Unknown error";
-      return BAYESOPT_FAILURE; 
+    {
+      return error_code();
     }
 
   return 0; /* everything ok*/
 }
 
-
-int bayes_optimization_categorical(int nDim, eval_func f, void* f_data,
-				   int *categories, double *x, 
-				   double *minf, bopt_params parameters)
+template <typename Func>
+static int optimize_categorical(int nDim, Func f, void* f_data,
+				int *categories, double *x, 
+				double *minf, bopt_params parameters)
 {
   vectord result(nDim);
   vectori cat(nDim);
@@ -218,27 +365,218 @@ int bayes_optimization_categorical(int nDim, eval_func f, void* f_data,
       std::copy(result.begin(), result.end(), x);
 
       *minf = optimizer.getValueAtMinimum();
+      save_profile(optimizer);
     }
-  catch (std::bad_alloc& e)
+  catch (...)
     {
-      FILE_LOG(logERROR) << e.what(); 
-      return  BAYESOPT_OUT_OF_MEMORY; 
+      return error_code();
     }
-  catch (std::invalid_argument& e)
-    { 
-      FILE_LOG(logERROR) << e.what(); 
-      return BAYESOPT_INVALID_ARGS; 
+
+  return 0; /* everything ok*/
+}
+
+
+int bayes_optimization(int nDim, eval_func f, void* f_data,
+		       const double *lb, const double *ub,
+		       double *x, double *minf, bopt_params parameters)
+{
+  return optimize_continuous(nDim,f,f_data,lb,ub,x,minf,parameters);
+}
+
+int bayes_optimization_warm(int nDim, eval_func f, void* f_data,
+			    const double *lb, const double *ub,
+			    const double *x_init, const double *y_init, 
+			    size_t n_init, double *x, double *minf, 
+			    bopt_params parameters)
+{
+  return optimize_warm(nDim,f,f_data,lb,ub,x_init,y_init,n_init,
+		       x,minf,parameters);
+}
+
+int bayes_optimization_disc(int nDim, eval_func f, void* f_data,
+			    double *valid_x, size_t n_points,
+			    double *x, double *minf, bopt_params parameters)
+{
+  return optimize_disc(nDim,f,f_data,valid_x,n_points,x,minf,parameters);
+}
+
+int bayes_optimization_categorical(int nDim, eval_func f, void* f_data,
+				   int *categories, double *x, 
+				   double *minf, bopt_params parameters)
+{
+  return optimize_categorical(nDim,f,f_data,categories,x,minf,parameters);
+}
+
+int bayes_optimization_batch(int nDim, eval_batch_func f, void* f_data,
+			     const double *lb, const double *ub,
+			     double *x, double *minf, bopt_params parameters)
+{
+  return optimize_continuous(nDim,f,f_data,lb,ub,x,minf,parameters);
+}
+
+int bayes_optimization_batch_warm(int nDim, eval_batch_func f, void* f_data,
+				  const double *lb, const double *ub,
+				  const double *x_init, const double *y_init, 
+				  size_t n_init, double *x, double *minf, 
+				  bopt_params parameters)
+{
+  return optimize_warm(nDim,f,f_data,lb,ub,x_init,y_init,n_init,
+		       x,minf,parameters);
+}
+
+int bayes_optimization_batch_disc(int nDim, eval_batch_func f, void* f_data,
+				  double *valid_x, size_t n_points,
+				  double *x, double *minf, 
+				  bopt_params parameters)
+{
+  return optimize_disc(nDim,f,f_data,valid_x,n_points,x,minf,parameters);
+}
+
+int bayes_optimization_batch_categorical(int nDim, eval_batch_func f, 
+					 void* f_data, int *categories, 
+					 double *x, double *minf, 
+					 bopt_params parameters)
+{
+  return optimize_categorical(nDim,f,f_data,categories,x,minf,parameters);
+}
+
+
+int bayes_optimizer_create(bopt_optimizer** opt, int nDim,
+			   const double *lb, const double *ub,
+			   bopt_params parameters)
+{
+  *opt = NULL;
+  try
+    {
+      bopt_optimizer* optimizer = new bopt_optimizer(nDim,parameters);
+      try
+	{
+	  optimizer->model.setBoundingBox(
+                                  bayesopt::utils::array2vector(lb,nDim),
+				  bayesopt::utils::array2vector(ub,nDim));
+	}
+      catch (...)
+	{
+	  delete optimizer;
+	  throw;
+	}
+      *opt = optimizer;
     }
-  catch (std::runtime_error& e)
-    { 
-      FILE_LOG(logERROR) << e.what(); 
-      return BAYESOPT_RUNTIME_ERROR;
+  catch (...)
+    {
+      return error_code();
+    }
+  return 0; /* everything ok*/
+}
+
+void bayes_optimizer_free(bopt_optimizer* opt)
+{
+  delete opt;
+}
+
+int bayes_optimizer_design(bopt_optimizer* opt, size_t n, double *x)
+{
+  try
+    {
+      matrixd xPoints(n,opt->nDim);
+      opt->model.getInitialDesign(xPoints);
+      for (size_t i = 0; i < n; ++i)
+	{
+	  for (size_t j = 0; j < opt->nDim; ++j)  x[i*opt->nDim+j] = xPoints(i,j);
+	}
     }
   catch (...)
-    { 
-      FILE_LOG(logERROR) << "Unknown error";
-      return BAYESOPT_FAILURE; 
+    {
+      return error_code();
+    }
+  return 0; /* everything ok*/
+}
+
+int bayes_optimizer_initialize(bopt_optimizer* opt, const double *x_init,
+			       const double *y_init, size_t n_init)
+{
+  try
+    {
+      opt->model.initializeOptimization(x_init,y_init,n_init);
+    }
+  catch (...)
+    {
+      return error_code();
+    }
+  return 0; /* everything ok*/
+}
+
+int bayes_optimizer_ask(bopt_optimizer* opt, double *x)
+{
+  try
+    {
+      const vectord query = opt->model.ask();
+      std::copy(query.begin(), query.end(), x);
+    }
+  catch (...)
+    {
+      return error_code();
+    }
+  return 0; /* everything ok*/
+}
+
+int bayes_optimizer_tell(bopt_optimizer* opt, const double *x, double y)
+{
+  try
+    {
+      opt->model.tell(bayesopt::utils::array2vector(x,opt->nDim),y);
     }
+  catch (...)
+    {
+      return error_code();
+    }
+  return 0; /* everything ok*/
+}
 
+int bayes_optimizer_predict(bopt_optimizer* opt, size_t n, const double *x,
+			    double *mean, double *std)
+{
+  try
+    {
+      for (size_t i = 0; i < n; ++i)
+	{
+	  opt->model.predict(bayesopt::utils::array2vector(x+i*opt->nDim,
+							   opt->nDim),
+			     mean[i],std[i]);
+	}
+    }
+  catch (...)
+    {
+      return error_code();
+    }
   return 0; /* everything ok*/
 }
+
+int bayes_optimizer_best(bopt_optimizer* opt, double *x, double *minf)
+{
+  try
+    {
+      if (opt->model.getData()->getNSamples() == 0)
+	{
+	  throw std::runtime_error("The optimization must be initialized "
+				   "before asking for the best point.");
+	}
+      const vectord result = opt->model.getFinalResult();
+      std::copy(result.begin(), result.end(), x);
+      *minf = opt->model.getValueAtMinimum();
+      save_profile(opt->model);
+    }
+  catch (...)
+    {
+      return error_code();
+    }
+  return 0; /* everything ok*/
+}
+
+
+int bayes_optimization_last_profile(bopt_profile* profile)
+{
+  if (!hasLastProfile)  return BAYESOPT_FAILURE;
+  *profile = lastProfile;
+  return 0;
+}